@@ -1,4 +1,5 @@
 #include <cstring>
+#include <cctype>
 
 #include "archive.h"
 #include "gobArchive.h"
@@ -6,9 +7,13 @@
 #include "labArchive.h"
 #include "zipArchive.h"
 #include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/filestream.h>
+#include <TFE_System/system.h>
 #include <assert.h>
 #include <string>
 #include <map>
+#include <mutex>
+#include <algorithm>
 
 namespace
 {
@@ -24,6 +29,256 @@ static const char* c_archiveExt[ARCHIVE_COUNT]=
 	"ZIP", // ARCHIVE_ZIP
 };
 
+struct ArchiveFile
+{
+	u32 index;
+	size_t length;
+	const u8* view;			// Memory-mapped or in-memory file data, null if the file has to be read.
+	size_t offset;			// Start of the file within the archive file, if it is stored but not mapped.
+	bool stored;
+
+	// Guards the stream and decoded data, so a handle can also be shared between threads.
+	std::mutex lock;
+	FileStream stream;
+	std::vector<u8> data;	// Compressed files are decoded once, unless they are read in one go.
+	bool decoded;
+};
+
+Archive::~Archive()
+{
+	closeFile();
+}
+
+ArchiveFile* Archive::openHandle(u32 index)
+{
+	if (index >= getFileCount()) { return nullptr; }
+
+	ArchiveFile* handle = new ArchiveFile();
+	handle->index = index;
+	handle->length = getFileLength(index);
+	handle->view = getFileData(index);
+	handle->offset = 0;
+	handle->stored = !handle->view && getFileOffset(index, &handle->offset);
+	handle->decoded = false;
+	return handle;
+}
+
+void Archive::closeHandle(ArchiveFile* handle)
+{
+	delete handle;
+}
+
+size_t Archive::read(ArchiveFile* handle, void* data, size_t offset, size_t size)
+{
+	if (!handle || offset >= handle->length) { return 0; }
+	size = std::min(size, handle->length - offset);
+	if (handle->view)
+	{
+		memcpy(data, handle->view + offset, size);
+		return size;
+	}
+
+	std::lock_guard<std::mutex> lock(handle->lock);
+	if (handle->stored)
+	{
+		// Each handle has its own stream, so readers never share a file position.
+		if (!handle->stream.isOpen() && !handle->stream.open(m_archivePath, Stream::MODE_READ))
+		{
+			return 0;
+		}
+		handle->stream.seek(s32(handle->offset + offset));
+		return handle->stream.readBuffer(data, u32(size));
+	}
+
+	if (!handle->decoded)
+	{
+		// The fast path decodes the entire file directly into the output, avoiding the extra copy.
+		if (offset == 0 && size == handle->length)
+		{
+			return readFileData(handle->index, data) ? size : 0;
+		}
+		handle->data.resize(handle->length);
+		if (!readFileData(handle->index, handle->data.data()))
+		{
+			handle->data.clear();
+			return 0;
+		}
+		handle->decoded = true;
+	}
+	memcpy(data, handle->data.data() + offset, size);
+	return size;
+}
+
+size_t Archive::getLength(const ArchiveFile* handle)
+{
+	return handle ? handle->length : 0;
+}
+
+bool Archive::openFile(const char *file)
+{
+	const u32 index = getFileIndex(file);
+	if (index == INVALID_FILE)
+	{
+		closeFile();
+		TFE_System::logWrite(LOG_ERROR, c_archiveExt[m_type < ARCHIVE_COUNT ? m_type : ARCHIVE_GOB], "Failed to load \"%s\" from \"%s\"", file, m_archivePath);
+		return false;
+	}
+	return openFile(index);
+}
+
+bool Archive::openFile(u32 index)
+{
+	closeFile();
+	m_curHandle = openHandle(index);
+	return m_curHandle != nullptr;
+}
+
+void Archive::closeFile()
+{
+	closeHandle(m_curHandle);
+	m_curHandle = nullptr;
+	m_fileOffset = 0;
+}
+
+size_t Archive::getFileLength()
+{
+	return getLength(m_curHandle);
+}
+
+size_t Archive::readFile(void *data, size_t size)
+{
+	if (!m_curHandle) { return 0; }
+	if (size == 0) { size = m_curHandle->length; }
+
+	const size_t bytesRead = read(m_curHandle, data, m_fileOffset, size);
+	m_fileOffset += (s32)bytesRead;
+	return bytesRead;
+}
+
+bool Archive::seekFile(s32 offset, s32 origin)
+{
+	if (!m_curHandle) { return false; }
+	const s32 size = (s32)m_curHandle->length;
+
+	switch (origin)
+	{
+		case SEEK_SET:
+		{
+			m_fileOffset = offset;
+		} break;
+		case SEEK_CUR:
+		{
+			m_fileOffset += offset;
+		} break;
+		case SEEK_END:
+		{
+			m_fileOffset = size - offset;
+		} break;
+	}
+	assert(m_fileOffset <= size && m_fileOffset >= 0);
+	if (m_fileOffset > size || m_fileOffset < 0)
+	{
+		m_fileOffset = 0;
+		return false;
+	}
+	return true;
+}
+
+size_t Archive::getLocInFile()
+{
+	return m_fileOffset;
+}
+
+static u32 hashFileName(const char* name)
+{
+	// FNV-1a on the lower case name.
+	u32 hash = 2166136261u;
+	for (; *name; name++)
+	{
+		hash ^= u32(tolower((u8)*name));
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+void Archive::buildFileIndex()
+{
+	clearFileIndex();
+	const u32 fileCount = getFileCount();
+	if (!fileCount) { return; }
+
+	// Keep the table at most half full.
+	u32 tableSize = 16;
+	while (tableSize < fileCount * 2) { tableSize <<= 1; }
+	m_fileIndex.resize(tableSize, INVALID_FILE);
+	m_fileIndexMask = tableSize - 1;
+
+	for (u32 i = 0; i < fileCount; i++)
+	{
+		const char* name = getFileName(i);
+		if (!name) { continue; }
+
+		u32 slot = hashFileName(name) & m_fileIndexMask;
+		bool duplicate = false;
+		while (m_fileIndex[slot] != INVALID_FILE)
+		{
+			// Only the first file with a given name can be found, matching a linear search.
+			if (strcasecmp(name, getFileName(m_fileIndex[slot])) == 0)
+			{
+				duplicate = true;
+				break;
+			}
+			slot = (slot + 1) & m_fileIndexMask;
+		}
+		if (!duplicate)
+		{
+			m_fileIndex[slot] = i;
+		}
+	}
+}
+
+void Archive::clearFileIndex()
+{
+	m_fileIndex.clear();
+	m_fileIndexMask = 0;
+}
+
+u32 Archive::findFile(const char* file)
+{
+	if (!file || m_fileIndex.empty()) { return INVALID_FILE; }
+
+	u32 slot = hashFileName(file) & m_fileIndexMask;
+	while (m_fileIndex[slot] != INVALID_FILE)
+	{
+		const u32 index = m_fileIndex[slot];
+		if (strcasecmp(file, getFileName(index)) == 0)
+		{
+			return index;
+		}
+		slot = (slot + 1) & m_fileIndexMask;
+	}
+	return INVALID_FILE;
+}
+
+bool Archive::mapArchive()
+{
+	return m_mappedFile.open(m_archivePath);
+}
+
+void Archive::unmapArchive()
+{
+	m_mappedFile.close();
+}
+
+const u8* Archive::getMappedData(size_t offset, size_t size)
+{
+	if (!m_mappedFile.isOpen() || offset > m_mappedFile.getSize() || size > m_mappedFile.getSize() - offset)
+	{
+		return nullptr;
+	}
+	return m_mappedFile.getData() + offset;
+}
+
 ArchiveType Archive::getArchiveTypeFromName(const char* path)
 {
 	const size_t len = strlen(path);
@@ -1,8 +1,10 @@
 #pragma once
 #include <cstdio>
+#include <vector>
 
 #include <TFE_System/types.h>
 #include <TFE_FileSystem/paths.h>
+#include <TFE_FileSystem/mappedFile.h>
 
 enum ArchiveType
 {
@@ -16,6 +18,9 @@ enum ArchiveType
 
 #define INVALID_FILE 0xffffffff
 
+// An open file within an archive, see Archive::openHandle().
+struct ArchiveFile;
+
 class Archive
 {
 	// Public API handling the same archive in multiple locations.
@@ -31,9 +36,9 @@ public:
 	
 	// Public Archive API
 public:
-	Archive() : m_type(ARCHIVE_UNKNOWN) {}
-	Archive(ArchiveType type) : m_type(type) {}
-	virtual ~Archive() {}
+	Archive() : m_type(ARCHIVE_UNKNOWN), m_fileOffset(0), m_curHandle(nullptr) { m_name[0] = 0; m_archivePath[0] = 0; }
+	Archive(ArchiveType type) : m_type(type), m_fileOffset(0), m_curHandle(nullptr) { m_name[0] = 0; m_archivePath[0] = 0; }
+	virtual ~Archive();
 
 	// Archive
 	virtual bool create(const char *archivePath) = 0;
@@ -43,28 +48,61 @@ public:
 	const char* getName() { return m_name; }
 	const char* getPath() { return m_archivePath; }
 
-	// File Access
-	virtual bool openFile(const char *file) = 0;
-	virtual bool openFile(u32 index) = 0;
-	virtual void closeFile() = 0;
+	// Handle based file access, safe to use from several threads at once.
+	// Each handle reads independently of the others, so any number of files (or the same file several times)
+	// can be open at once. Handles must be closed before the archive is closed.
+	ArchiveFile* openHandle(u32 index);
+	void closeHandle(ArchiveFile* handle);
+	// Read up to 'size' bytes starting at 'offset' within the file, returns the number of bytes read.
+	size_t read(ArchiveFile* handle, void* data, size_t offset, size_t size);
+	size_t getLength(const ArchiveFile* handle);
+
+	// Current file access, a single cursor on top of a handle. Only one file can be open at a time
+	// so this is not safe to share between threads, use the handle API instead.
+	bool openFile(const char *file);
+	bool openFile(u32 index);
+	void closeFile();
+
+	size_t getFileLength();
+	size_t readFile(void *data, size_t size);
+	bool seekFile(s32 offset, s32 origin = SEEK_SET);
+	size_t getLocInFile();
 
 	virtual bool fileExists(const char *file) = 0;
 	virtual bool fileExists(u32 index) = 0;
 	virtual u32  getFileIndex(const char* file) = 0;
 
-	virtual size_t getFileLength() = 0;
-	virtual size_t readFile(void *data, size_t size) = 0;
-	virtual bool seekFile(s32 offset, s32 origin = SEEK_SET) = 0;
-	virtual size_t getLocInFile() = 0;
-
 	// Directory
 	virtual u32 getFileCount() = 0;
 	virtual const char* getFileName(u32 index) = 0;
 	virtual size_t getFileLength(u32 index) = 0;
 
+	// Zero-copy access, returns a read-only view of the file data or null if the archive cannot provide one
+	// (such as compressed files). The view is valid until the archive is closed, use getFileLength(index) for the size.
+	virtual const u8* getFileData(u32 index) { return nullptr; }
+
 	// Edit
 	virtual void addFile(const char* fileName, const char* filePath) = 0;
 
+	// Shared lookup, returns the index of the first file named 'file' (case-insensitive) or INVALID_FILE.
+	u32 findFile(const char* file);
+
+protected:
+	// Where the data of a file is stored within the archive file, used by handles that cannot use getFileData().
+	// Archives that compress their files return false and implement readFileData() instead.
+	virtual bool getFileOffset(u32 index, size_t* offset) { return false; }
+	// Decode the whole file into 'data', which holds getFileLength(index) bytes. Called from any thread.
+	virtual bool readFileData(u32 index, void* data) { return false; }
+
+	// Build the case-insensitive hash index of file names, call once the directory has been read or changed.
+	void buildFileIndex();
+	void clearFileIndex();
+
+	// Map the archive at m_archivePath into memory, reads fall back to the file stream if this fails.
+	bool mapArchive();
+	void unmapArchive();
+	const u8* getMappedData(size_t offset, size_t size);
+
 	// Shared Private State
 protected:
 	ArchiveType m_type;
@@ -72,4 +110,11 @@ protected:
 	char m_archivePath[TFE_MAX_PATH];
 
 	s32 m_fileOffset;
+	ArchiveFile* m_curHandle;
+
+	// Open addressing hash table of file indices, INVALID_FILE marks an empty slot.
+	std::vector<u32> m_fileIndex;
+	u32 m_fileIndexMask = 0;
+
+	MappedFile m_mappedFile;
 };
@@ -14,7 +14,6 @@ GobArchive::~GobArchive()
 bool GobArchive::create(const char *archivePath)
 {
 	m_archiveOpen = m_file.open(archivePath, Stream::MODE_WRITE);
-	m_curFile = -1;
 	m_fileOffset = 0;
 	if (!m_archiveOpen) { return false; }
 
@@ -69,7 +68,6 @@ bool GobArchive::validate(const char *archivePath, s32 minFileCount)
 bool GobArchive::open(const char *archivePath)
 {
 	m_archiveOpen = m_file.open(archivePath, Stream::MODE_READ);
-	m_curFile = -1;
 	if (!m_archiveOpen) { return false; }
 
 	// Read the directory.
@@ -79,98 +77,38 @@ bool GobArchive::open(const char *archivePath)
 	m_file.readBuffer(&m_fileList.MASTERN, sizeof(u32));
 	m_fileList.entries = new GOB_Entry_t[m_fileList.MASTERN];
 	m_file.readBuffer(m_fileList.entries, sizeof(GOB_Entry_t), m_fileList.MASTERN);
+	buildFileIndex();
 
 	strcpy(m_archivePath, archivePath);
 	m_file.close();
+	mapArchive();
 
 	return true;
 }
 
 void GobArchive::close()
 {
+	closeFile();
 	m_file.close();
+	unmapArchive();
 	m_archiveOpen = false;
 	delete[] m_fileList.entries;
 	m_fileList.entries = nullptr;
+	clearFileIndex();
 }
 
 // File Access
-bool GobArchive::openFile(const char *file)
-{
-	if (!m_archiveOpen) { return false; }
-
-	m_file.open(m_archivePath, Stream::MODE_READ);
-	m_curFile = -1;
-	m_fileOffset = 0;
-
-	//search for this file.
-	for (s32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			m_curFile = i;
-			break;
-		}
-	}
-
-	if (m_curFile == -1)
-	{
-		m_file.close();
-		TFE_System::logWrite(LOG_ERROR, "GOB", "Failed to load \"%s\" from \"%s\"", file, m_archivePath);
-	}
-	else
-	{
-		m_file.seek(m_fileList.entries[m_curFile].IX);
-	}
-	return m_curFile > -1 ? true : false;
-}
-
-bool GobArchive::openFile(u32 index)
-{
-	if (index >= getFileCount()) { return false; }
-
-	m_curFile = s32(index);
-	m_fileOffset = 0;
-	m_file.open(m_archivePath, Stream::MODE_READ);
-	m_file.seek(m_fileList.entries[m_curFile].IX);
-	return true;
-}
-
-void GobArchive::closeFile()
-{
-	m_curFile = -1;
-	m_file.close();
-}
-
 u32 GobArchive::getFileIndex(const char* file)
 {
 	if (!m_archiveOpen) { return INVALID_FILE; }
 
-	//search for this file.
-	for (s32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	return findFile(file);
 }
 
 bool GobArchive::fileExists(const char *file)
 {
 	if (!m_archiveOpen) { return false; }
-	m_curFile = -1;
-
-	//search for this file.
-	for (s32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return true;
-		}
-	}
-	return false;
+	return findFile(file) != INVALID_FILE;
 }
 
 bool GobArchive::fileExists(u32 index)
@@ -179,59 +117,6 @@ bool GobArchive::fileExists(u32 index)
 	return true;
 }
 
-size_t GobArchive::getFileLength()
-{
-	if (m_curFile < 0) { return 0; }
-	return getFileLength(m_curFile);
-}
-
-size_t GobArchive::readFile(void *data, size_t size)
-{
-	if (m_curFile < 0) { return false; }
-	if (size == 0) { size = m_fileList.entries[m_curFile].LEN; }
-	const size_t sizeToRead = std::min(size, (size_t)m_fileList.entries[m_curFile].LEN);
-
-	u32 bytesRead = m_file.readBuffer(data, (u32)sizeToRead);
-	m_fileOffset += (s32)sizeToRead;
-	return bytesRead;
-}
-
-bool GobArchive::seekFile(s32 offset, s32 origin)
-{
-	if (m_curFile < 0) { return false; }
-	size_t size = m_fileList.entries[m_curFile].LEN;
-
-	switch (origin)
-	{
-		case SEEK_SET:
-		{
-			m_fileOffset = offset;
-		} break;
-		case SEEK_CUR:
-		{
-			m_fileOffset += offset;
-		} break;
-		case SEEK_END:
-		{
-			m_fileOffset = (s32)size - offset;
-		} break;
-	}
-	assert(m_fileOffset <= size && m_fileOffset >= 0);
-	if (m_fileOffset > size || m_fileOffset < 0)
-	{
-		m_fileOffset = 0;
-		return false;
-	}
-
-	m_file.seek(m_fileList.entries[m_curFile].IX + m_fileOffset);
-	return true;
-}
-
-size_t GobArchive::getLocInFile()
-{
-	return m_fileOffset;
-}
-
 // Directory
 u32 GobArchive::getFileCount()
 {
@@ -251,6 +136,19 @@ size_t GobArchive::getFileLength(u32 index)
 	return m_fileList.entries[index].LEN;
 }
 
+const u8* GobArchive::getFileData(u32 index)
+{
+	if (index >= getFileCount()) { return nullptr; }
+	return getMappedData(m_fileList.entries[index].IX, m_fileList.entries[index].LEN);
+}
+
+bool GobArchive::getFileOffset(u32 index, size_t* offset)
+{
+	if (index >= getFileCount()) { return false; }
+	*offset = m_fileList.entries[index].IX;
+	return true;
+}
+
 // Edit
 void GobArchive::addFile(const char* fileName, const char* filePath)
 {
@@ -272,6 +170,7 @@ void GobArchive::addFile(const char* fileName, const char* filePath)
 	newFile->LEN = u32(len);
 	strcpy(newFile->NAME, fileName);
 	m_header.MASTERX += newFile->LEN;
+	buildFileIndex();
 
 	// Read all of the file data.
 	std::vector<std::vector<u8>> fileData(m_fileList.MASTERN);
@@ -290,7 +189,8 @@ void GobArchive::addFile(const char* fileName, const char* filePath)
 		file.close();
 	}
 
-	// Now write the new file.
+	// Now write the new file, the mapping has to be released first.
+	unmapArchive();
 	if (m_file.open(m_archivePath, Stream::MODE_WRITE))
 	{
 		m_file.writeBuffer(&m_header, sizeof(GOB_Header_t));
@@ -303,4 +203,5 @@ void GobArchive::addFile(const char* fileName, const char* filePath)
 		m_file.writeBuffer(m_fileList.entries, sizeof(GOB_Entry_t), m_fileList.MASTERN);
 		m_file.close();
 	}
+	mapArchive();
 }
@@ -11,7 +11,7 @@ class GobArchive : public Archive
 public:
 	friend GobMemoryArchive;
 public:
-	GobArchive() : Archive(ARCHIVE_GOB), m_archiveOpen(false), m_curFile(-1) {}
+	GobArchive() : Archive(ARCHIVE_GOB), m_archiveOpen(false) {}
 	~GobArchive() override;
 
 	// Archive
@@ -20,23 +20,16 @@ public:
 	void close() override;
 
 	// File Access
-	bool openFile(const char *file) override;
-	bool openFile(u32 index) override;
-	void closeFile() override;
-
 	u32 getFileIndex(const char* file) override;
 	bool fileExists(const char *file) override;
 	bool fileExists(u32 index) override;
 
-	size_t getFileLength() override;
-	size_t readFile(void *data, size_t size) override;
-	bool seekFile(s32 offset, s32 origin = SEEK_SET) override;
-	size_t getLocInFile() override;
-
 	// Directory
 	u32 getFileCount() override;
 	const char* getFileName(u32 index) override;
 	size_t getFileLength(u32 index) override;
+	using Archive::getFileLength;
+	const u8* getFileData(u32 index) override;
 
 	// Validation
 	static bool validate(const char *archivePath, s32 minFileCount = 1);
@@ -44,6 +37,9 @@ public:
 	// Edit
 	void addFile(const char* fileName, const char* filePath) override;
 
+protected:
+	bool getFileOffset(u32 index, size_t* offset) override;
+
 private:
 	#pragma pack(push)
 	#pragma pack(1)
@@ -74,5 +70,4 @@ private:
 
 	GOB_Header_t m_header;
 	GOB_Index_t m_fileList;
-	s32 m_curFile;
 };
@@ -10,7 +10,7 @@
 class GobMemoryArchive : public Archive
 {
 public:
-	GobMemoryArchive() : Archive(ARCHIVE_GOB), m_buffer(nullptr), m_size(0), m_readLoc(0), m_archiveOpen(false), m_curFile(-1) {}
+	GobMemoryArchive() : Archive(ARCHIVE_GOB), m_buffer(nullptr), m_size(0), m_archiveOpen(false) {}
 	~GobMemoryArchive() override;
 
 	// Archive
@@ -20,23 +20,16 @@ public:
 	void close() override;
 
 	// File Access
-	bool openFile(const char *file) override;
-	bool openFile(u32 index) override;
-	void closeFile() override;
-
 	u32 getFileIndex(const char* file) override;
 	bool fileExists(const char *file) override;
 	bool fileExists(u32 index) override;
 
-	size_t getFileLength() override;
-	size_t readFile(void *data, size_t size) override;
-	bool seekFile(s32 offset, s32 origin = SEEK_SET) override;
-	size_t getLocInFile() override;
-
 	// Directory
 	u32 getFileCount() override;
 	const char* getFileName(u32 index) override;
 	size_t getFileLength(u32 index) override;
+	using Archive::getFileLength;
+	const u8* getFileData(u32 index) override;
 
 	// Edit
 	void addFile(const char* fileName, const char* filePath) override;
@@ -44,10 +37,8 @@ public:
 private:
 	const u8* m_buffer;
 	size_t m_size;
-	size_t m_readLoc;
 	bool m_archiveOpen;
 
 	GobArchive::GOB_Header_t* m_header;
 	GobArchive::GOB_Index_t   m_fileList;
-	s32 m_curFile;
 };
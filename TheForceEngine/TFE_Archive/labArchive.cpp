@@ -19,7 +19,6 @@ bool LabArchive::create(const char *archivePath)
 bool LabArchive::open(const char *archivePath)
 {
 	m_archiveOpen = m_file.open(archivePath, Stream::MODE_READ);
-	m_curFile = -1;
 	m_fileOffset = 0;
 	if (!m_archiveOpen) { return false; }
 
@@ -33,99 +32,38 @@ bool LabArchive::open(const char *archivePath)
 
 	// Read string table.
 	m_file.readBuffer(m_stringTable, m_header.stringTableSize);
+	m_stringTable[m_header.stringTableSize] = 0;
 	m_file.close();
+	buildFileIndex();
 		
 	strcpy(m_archivePath, archivePath);
+	mapArchive();
 	
 	return true;
 }
 
 void LabArchive::close()
 {
+	closeFile();
 	m_file.close();
+	unmapArchive();
 	m_archiveOpen = false;
 	delete[] m_entries;
 	delete[] m_stringTable;
+	clearFileIndex();
 }
 
 // File Access
-bool LabArchive::openFile(const char *file)
-{
-	if (!m_archiveOpen) { return false; }
-
-	m_file.open(m_archivePath, Stream::MODE_READ);
-	m_curFile = -1;
-	m_fileOffset = 0;
-
-	//search for this file.
-	for (u32 i = 0; i < m_header.fileCount; i++)
-	{
-		if (strcasecmp(file, &m_stringTable[m_entries[i].nameOffset]) == 0)
-		{
-			m_curFile = i;
-			break;
-		}
-	}
-
-	if (m_curFile == -1)
-	{
-		m_file.close();
-		TFE_System::logWrite(LOG_ERROR, "GOB", "Failed to load \"%s\" from \"%s\"", file, m_archivePath);
-	}
-	else
-	{
-		m_file.seek(m_entries[m_curFile].dataOffset);
-	}
-	return m_curFile > -1 ? true : false;
-}
-
-bool LabArchive::openFile(u32 index)
-{
-	if (index >= getFileCount()) { return false; }
-
-	m_curFile = s32(index);
-	m_fileOffset = 0;
-	m_file.open(m_archivePath, Stream::MODE_READ);
-	m_file.seek(m_entries[m_curFile].dataOffset);
-	return true;
-}
-
-void LabArchive::closeFile()
-{
-	m_curFile = -1;
-	m_file.close();
-}
-
 u32 LabArchive::getFileIndex(const char* file)
 {
 	if (!m_archiveOpen) { return INVALID_FILE; }
-	m_curFile = -1;
-
-	//search for this file.
-	for (u32 i = 0; i < m_header.fileCount; i++)
-	{
-		if (strcasecmp(file, &m_stringTable[m_entries[i].nameOffset]) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	return findFile(file);
 }
 
 bool LabArchive::fileExists(const char *file)
 {
 	if (!m_archiveOpen) { return false; }
-	m_curFile = -1;
-
-	//search for this file.
-	for (u32 i = 0; i < m_header.fileCount; i++)
-	{
-		if (strcasecmp(file, &m_stringTable[m_entries[i].nameOffset]) == 0)
-		{
-			return true;
-		}
-	}
-	return false;
+	return findFile(file) != INVALID_FILE;
 }
 
 bool LabArchive::fileExists(u32 index)
@@ -134,59 +72,6 @@ bool LabArchive::fileExists(u32 index)
 	return true;
 }
 
-size_t LabArchive::getFileLength()
-{
-	if (m_curFile < 0) { return 0; }
-	return getFileLength(m_curFile);
-}
-
-size_t LabArchive::readFile(void *data, size_t size)
-{
-	if (m_curFile < 0) { return false; }
-	if (size == 0) { size = m_entries[m_curFile].len; }
-	const size_t sizeToRead = std::min(size, (size_t)m_entries[m_curFile].len);
-
-	size_t bytesRead = m_file.readBuffer(data, (u32)sizeToRead);
-	m_fileOffset += (s32)sizeToRead;
-	return bytesRead;
-}
-
-bool LabArchive::seekFile(s32 offset, s32 origin)
-{
-	if (m_curFile < 0) { return false; }
-	size_t size = m_entries[m_curFile].len;
-
-	switch (origin)
-	{
-		case SEEK_SET:
-		{
-			m_fileOffset = offset;
-		} break;
-		case SEEK_CUR:
-		{
-			m_fileOffset += offset;
-		} break;
-		case SEEK_END:
-		{
-			m_fileOffset = (s32)size - offset;
-		} break;
-	}
-	assert(m_fileOffset <= size && m_fileOffset >= 0);
-	if (m_fileOffset > size || m_fileOffset < 0)
-	{
-		m_fileOffset = 0;
-		return false;
-	}
-
-	m_file.seek(m_entries[m_curFile].dataOffset + m_fileOffset);
-	return true;
-}
-
-size_t LabArchive::getLocInFile()
-{
-	return m_fileOffset;
-}
-
 // Directory
 u32 LabArchive::getFileCount()
 {
@@ -206,6 +91,19 @@ size_t LabArchive::getFileLength(u32 index)
 	return m_entries[index].len;
 }
 
+const u8* LabArchive::getFileData(u32 index)
+{
+	if (index >= getFileCount()) { return nullptr; }
+	return getMappedData(m_entries[index].dataOffset, m_entries[index].len);
+}
+
+bool LabArchive::getFileOffset(u32 index, size_t* offset)
+{
+	if (index >= getFileCount()) { return false; }
+	*offset = m_entries[index].dataOffset;
+	return true;
+}
+
 // Edit
 void LabArchive::addFile(const char* fileName, const char* filePath)
 {
@@ -7,7 +7,7 @@
 class LabArchive : public Archive
 {
 public:
-	LabArchive() : Archive(ARCHIVE_LAB), m_archiveOpen(false), m_curFile(-1) {}
+	LabArchive() : Archive(ARCHIVE_LAB), m_archiveOpen(false) {}
 	~LabArchive() override;
 
 	// Archive
@@ -16,27 +16,23 @@ public:
 	void close() override;
 
 	// File Access
-	bool openFile(const char *file) override;
-	bool openFile(u32 index) override;
-	void closeFile() override;
-
 	u32 getFileIndex(const char* file) override;
 	bool fileExists(const char *file) override;
 	bool fileExists(u32 index) override;
 
-	size_t getFileLength() override;
-	size_t readFile(void *data, size_t size) override;
-	bool seekFile(s32 offset, s32 origin = SEEK_SET) override;
-	size_t getLocInFile() override;
-
 	// Directory
 	u32 getFileCount() override;
 	const char* getFileName(u32 index) override;
 	size_t getFileLength(u32 index) override;
+	using Archive::getFileLength;
+	const u8* getFileData(u32 index) override;
 
 	// Edit
 	void addFile(const char* fileName, const char* filePath) override;
 
+protected:
+	bool getFileOffset(u32 index, size_t* offset) override;
+
 private:
 	#pragma pack(push)
 	#pragma pack(1)
@@ -63,6 +59,4 @@ private:
 	LAB_Header_t m_header;
 	char* m_stringTable;
 	LAB_Entry_t* m_entries;
-
-	s32 m_curFile;
 };
@@ -13,7 +13,6 @@ LfdArchive::~LfdArchive()
 bool LfdArchive::create(const char *archivePath)
 {
 	m_archiveOpen = m_file.open(archivePath, Stream::MODE_WRITE);
-	m_curFile = -1;
 	m_fileOffset = 0;
 	if (!m_archiveOpen) { return false; }
 
@@ -32,7 +31,6 @@ bool LfdArchive::create(const char *archivePath)
 bool LfdArchive::open(const char *archivePath)
 {
 	m_archiveOpen = m_file.open(archivePath, Stream::MODE_READ);
-	m_curFile = -1;
 	m_fileOffset = 0;
 	if (!m_archiveOpen) { return false; }
 
@@ -59,16 +57,20 @@ bool LfdArchive::open(const char *archivePath)
 
 		IX += sizeof(LFD_Entry_t) + entry.LENGTH;
 	}
+	buildFileIndex();
 
 	strcpy(m_archivePath, archivePath);
 	m_file.close();
+	mapArchive();
 
 	return true;
 }
 
 void LfdArchive::close()
 {
+	closeFile();
 	m_file.close();
+	unmapArchive();
 	m_archiveOpen = false;
 
 	if (m_fileList.entries)
@@ -76,86 +78,20 @@ void LfdArchive::close()
 		delete[] m_fileList.entries;
 		m_fileList.entries = nullptr;
 	}
+	clearFileIndex();
 }
 
 // File Access
-bool LfdArchive::openFile(const char *file)
-{
-	if (!m_archiveOpen) { return false; }
-
-	m_file.open(m_archivePath, Stream::MODE_READ);
-	m_curFile = -1;
-	m_fileOffset = 0;
-
-	//search for this file.
-	for (s32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			m_curFile = i;
-			break;
-		}
-	}
-
-	if (m_curFile == -1)
-	{
-		m_file.close();
-		TFE_System::logWrite(LOG_ERROR, "LFD", "Failed to load \"%s\" from \"%s\"", file, m_archivePath);
-	}
-	else
-	{
-		m_file.seek(m_fileList.entries[m_curFile].IX);
-	}
-	return m_curFile > -1 ? true : false;
-}
-
-bool LfdArchive::openFile(u32 index)
-{
-	if (index >= getFileCount()) { return false; }
-
-	m_curFile = s32(index);
-	m_fileOffset = 0;
-	m_file.open(m_archivePath, Stream::MODE_READ);
-	m_file.seek(m_fileList.entries[m_curFile].IX);
-	return true;
-}
-
-void LfdArchive::closeFile()
-{
-	m_curFile = -1;
-	m_file.close();
-}
-
 u32 LfdArchive::getFileIndex(const char* file)
 {
 	if (!m_archiveOpen) { return INVALID_FILE; }
-	m_curFile = -1;
-
-	//search for this file.
-	for (s32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	return findFile(file);
 }
 
 bool LfdArchive::fileExists(const char *file)
 {
 	if (!m_archiveOpen) { return false; }
-	m_curFile = -1;
-
-	//search for this file.
-	for (s32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return true;
-		}
-	}
-	return false;
+	return findFile(file) != INVALID_FILE;
 }
 
 bool LfdArchive::fileExists(u32 index)
@@ -164,59 +100,6 @@ bool LfdArchive::fileExists(u32 index)
 	return true;
 }
 
-size_t LfdArchive::getFileLength()
-{
-	if (m_curFile < 0) { return 0; }
-	return getFileLength(m_curFile);
-}
-
-size_t LfdArchive::readFile(void *data, size_t size)
-{
-	if (m_curFile < 0) { return false; }
-	if (size == 0) { size = m_fileList.entries[m_curFile].LENGTH; }
-	const size_t sizeToRead = std::min(size, (size_t)m_fileList.entries[m_curFile].LENGTH);
-
-	size_t bytesRead = m_file.readBuffer(data, (u32)sizeToRead);
-	m_fileOffset += (s32)sizeToRead;
-	return bytesRead;
-}
-
-bool LfdArchive::seekFile(s32 offset, s32 origin)
-{
-	if (m_curFile < 0) { return false; }
-	size_t size = m_fileList.entries[m_curFile].LENGTH;
-
-	switch (origin)
-	{
-		case SEEK_SET:
-		{
-			m_fileOffset = offset;
-		} break;
-		case SEEK_CUR:
-		{
-			m_fileOffset += offset;
-		} break;
-		case SEEK_END:
-		{
-			m_fileOffset = (s32)size - offset;
-		} break;
-	}
-	assert(m_fileOffset <= size && m_fileOffset >= 0);
-	if (m_fileOffset > size || m_fileOffset < 0)
-	{
-		m_fileOffset = 0;
-		return false;
-	}
-
-	m_file.seek(m_fileList.entries[m_curFile].IX + m_fileOffset);
-	return true;
-}
-
-size_t LfdArchive::getLocInFile()
-{
-	return m_fileOffset;
-}
-
 // Directory
 u32 LfdArchive::getFileCount()
 {
@@ -236,6 +119,19 @@ size_t LfdArchive::getFileLength(u32 index)
 	return m_fileList.entries[index].LENGTH;
 }
 
+const u8* LfdArchive::getFileData(u32 index)
+{
+	if (index >= getFileCount()) { return nullptr; }
+	return getMappedData(m_fileList.entries[index].IX, m_fileList.entries[index].LENGTH);
+}
+
+bool LfdArchive::getFileOffset(u32 index, size_t* offset)
+{
+	if (index >= getFileCount()) { return false; }
+	*offset = m_fileList.entries[index].IX;
+	return true;
+}
+
 // Edit
 void LfdArchive::addFile(const char* fileName, const char* filePath)
 {
@@ -12,7 +12,7 @@
 class LfdArchive : public Archive
 {
 public:
-	LfdArchive() : Archive(ARCHIVE_LFD), m_archiveOpen(false), m_curFile(-1) {}
+	LfdArchive() : Archive(ARCHIVE_LFD), m_archiveOpen(false) {}
 	~LfdArchive() override;
 
 	// Archive
@@ -21,27 +21,23 @@ public:
 	void close() override;
 
 	// File Access
-	bool openFile(const char *file) override;
-	bool openFile(u32 index) override;
-	void closeFile() override;
-
 	bool fileExists(const char *file) override;
 	bool fileExists(u32 index) override;
 	u32  getFileIndex(const char* file) override;
 
-	size_t getFileLength() override;
-	size_t readFile(void *data, size_t size) override;
-	bool seekFile(s32 offset, s32 origin = SEEK_SET) override;
-	size_t getLocInFile() override;
-
 	// Directory
 	u32 getFileCount() override;
 	const char* getFileName(u32 index) override;
 	size_t getFileLength(u32 index) override;
+	using Archive::getFileLength;
+	const u8* getFileData(u32 index) override;
 
 	// Edit
 	void addFile(const char* fileName, const char* filePath) override;
 
+protected:
+	bool getFileOffset(u32 index, size_t* offset) override;
+
 private:
 	#pragma pack(push)
 	#pragma pack(1)
@@ -73,5 +69,4 @@ private:
 
 	LFD_Entry_t m_header;
 	LFD_Index_t m_fileList;
-	s32 m_curFile;
 };
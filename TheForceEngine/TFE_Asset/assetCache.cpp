@@ -0,0 +1,118 @@
+#include <cstring>
+
+#include "assetCache.h"
+#include <TFE_Archive/archive.h>
+#include <TFE_FileSystem/fileutil.h>
+#include <TFE_System/system.h>
+#include <list>
+#include <unordered_map>
+
+namespace TFE_AssetCache
+{
+	struct CachedAsset
+	{
+		std::string key;
+		void* asset;
+		size_t size;
+		AssetCacheFreeFunc freeFunc;
+	};
+	typedef std::list<CachedAsset> AssetList;
+	typedef std::unordered_map<std::string, AssetList::iterator> AssetMap;
+
+	// Most recently used assets are at the front of the list.
+	static AssetList s_assets;
+	static AssetMap  s_assetMap;
+	static size_t s_size = 0;
+	static size_t s_budget = 64 * 1024 * 1024;
+
+	static const char c_typePrefix[ACACHE_COUNT] = { 'F', 'W', 'T', 'M', 'S' };
+
+	static void evict(size_t budget)
+	{
+		while (s_size > budget && !s_assets.empty())
+		{
+			CachedAsset& oldest = s_assets.back();
+			oldest.freeFunc(oldest.asset);
+			s_size -= oldest.size;
+			s_assetMap.erase(oldest.key);
+			s_assets.pop_back();
+		}
+	}
+
+	void buildKey(AssetCacheType type, const FilePath* filePath, std::string& key)
+	{
+		// Memory archives have no path, their contents cannot change while they are open.
+		const char* sourcePath = filePath->archive ? filePath->archive->getPath() : filePath->path;
+		const u64 modifiedTime = sourcePath[0] ? FileUtil::getModifiedTime(sourcePath) : 0;
+		const size_t size = filePath->archive ? filePath->archive->getFileLength(filePath->index) : size_t(FileUtil::getFileSize(sourcePath));
+
+		char idStr[64];
+		snprintf(idStr, 64, "|%u|%zu|%016llx", filePath->archive ? filePath->index : 0u, size, (unsigned long long)modifiedTime);
+
+		key.assign(1, c_typePrefix[type]);
+		key += '|';
+		if (filePath->archive)
+		{
+			key += filePath->archive->getPath();
+			key += '|';
+			key += filePath->archive->getName();
+		}
+		else
+		{
+			key += filePath->path;
+		}
+		key += idStr;
+	}
+
+	void add(const std::string& key, void* asset, size_t size, AssetCacheFreeFunc freeFunc)
+	{
+		if (!asset) { return; }
+		if (size > s_budget || s_assetMap.find(key) != s_assetMap.end())
+		{
+			freeFunc(asset);
+			return;
+		}
+
+		s_assets.push_front({ key, asset, size, freeFunc });
+		s_assetMap[key] = s_assets.begin();
+		s_size += size;
+		evict(s_budget);
+	}
+
+	void* take(const std::string& key, size_t* size)
+	{
+		AssetMap::iterator iAsset = s_assetMap.find(key);
+		if (iAsset == s_assetMap.end())
+		{
+			return nullptr;
+		}
+
+		void* asset = iAsset->second->asset;
+		*size = iAsset->second->size;
+		s_size -= iAsset->second->size;
+		s_assets.erase(iAsset->second);
+		s_assetMap.erase(iAsset);
+		return asset;
+	}
+
+	void setBudget(size_t bytes)
+	{
+		s_budget = bytes;
+		evict(s_budget);
+	}
+
+	size_t getBudget()
+	{
+		return s_budget;
+	}
+
+	size_t getSize()
+	{
+		return s_size;
+	}
+
+	void clear()
+	{
+		evict(0);
+	}
+}
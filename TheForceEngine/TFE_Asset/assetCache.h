@@ -0,0 +1,53 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// The Force Engine Asset Cache
+// Keeps decoded level assets alive across level transitions.
+// When a level pool is freed, its assets are handed to the cache
+// instead, and the next level (or the same level after a reload)
+// takes them back if the source file is unchanged. The cache is
+// bounded by a memory budget (the asset cache size setting) and
+// evicts the least recently used assets first.
+//
+// Sprites and frames are handed over as-is. Textures, 3DO models and
+// sounds live in level or game memory, so a copy is cached instead
+// and copied back into that memory when the asset is loaded again.
+//
+// Keys include the archive (or loose file) path, the file index, the
+// size and the modification time of the archive or loose file, so mods
+// that replace a file with the same name never get a stale asset.
+// Building a key never reads the source data.
+//
+// The cache is only accessed from the main thread.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_FileSystem/paths.h>
+#include <string>
+
+namespace TFE_AssetCache
+{
+	enum AssetCacheType
+	{
+		ACACHE_FRAME = 0,
+		ACACHE_WAX,
+		ACACHE_TEXTURE,
+		ACACHE_MODEL,
+		ACACHE_SOUND,
+		ACACHE_COUNT
+	};
+	typedef void(*AssetCacheFreeFunc)(void* asset);
+
+	// Build the key for an asset decoded from 'filePath', this only reads the directory and file times.
+	void buildKey(AssetCacheType type, const FilePath* filePath, std::string& key);
+
+	// Hand a decoded asset that is no longer used to the cache, it is freed with 'freeFunc' once evicted.
+	void add(const std::string& key, void* asset, size_t size, AssetCacheFreeFunc freeFunc);
+	// Remove the asset from the cache and return ownership to the caller, returns null if it is not cached.
+	void* take(const std::string& key, size_t* size);
+
+	// Set the memory budget in bytes, evicting assets if needed. A budget of 0 disables the cache.
+	void setBudget(size_t bytes);
+	size_t getBudget();
+	size_t getSize();
+	// Free all cached assets.
+	void clear();
+}
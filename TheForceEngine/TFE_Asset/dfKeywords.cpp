@@ -1,4 +1,5 @@
 #include <cstring>
+#include <cctype>
 
 #include "dfKeywords.h"
 #include <TFE_System/system.h>
@@ -229,20 +230,128 @@ static const char* c_keywords[] =
 
 #define KEYWORD_COUNT TFE_ARRAYSIZE(c_keywords)
 
-KEYWORD getKeywordIndex(const char* keywordString)
+enum
+{
+	KEYWORD_HASH_SIZE = 1024,	// Power of two, kept at more than 4x the keyword count so probe chains stay short.
+	KEYWORD_HASH_MASK = KEYWORD_HASH_SIZE - 1,
+};
+
+// FNV-1a over the upper case characters, so the lookup is case-insensitive like the original strcasecmp().
+static u32 hashKeyword(const char* str)
+{
+	u32 hash = 2166136261u;
+	for (; *str; str++)
+	{
+		hash ^= u32(toupper((u8)*str));
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// Open addressing table of keyword indices, built once from c_keywords during static initialization.
+struct KeywordHashTable
+{
+	s16 slots[KEYWORD_HASH_SIZE];
+
+	KeywordHashTable()
+	{
+		static_assert(KEYWORD_COUNT * 4 <= KEYWORD_HASH_SIZE, "The keyword hash table is too small.");
+		for (s32 i = 0; i < KEYWORD_HASH_SIZE; i++)
+		{
+			slots[i] = -1;
+		}
+		for (u32 i = 0; i < KEYWORD_COUNT; i++)
+		{
+			u32 slot = hashKeyword(c_keywords[i]) & KEYWORD_HASH_MASK;
+			bool duplicate = false;
+			for (; slots[slot] >= 0; slot = (slot + 1) & KEYWORD_HASH_MASK)
+			{
+				// Some keywords are repeated, the first one wins as with the linear search.
+				if (!strcasecmp(c_keywords[slots[slot]], c_keywords[i]))
+				{
+					duplicate = true;
+					break;
+				}
+			}
+			if (!duplicate) { slots[slot] = s16(i); }
+		}
+	}
+};
+static const KeywordHashTable s_keywordTable;
+
+// The original linear search, kept as the reference for the benchmark.
+static KEYWORD getKeywordIndexLinear(const char* keywordString)
 {
 	s32 result = -1;
-	for (s32 i = 0; i < KEYWORD_COUNT; i++)
+	for (u32 i = 0; i < KEYWORD_COUNT; i++)
 	{
 		const char* keyword = c_keywords[i];
 		if (toupper(keywordString[0]) == keyword[0])
 		{
 			if (!strcasecmp(keywordString, keyword))
 			{
-				result = i;
+				result = s32(i);
 				break;
 			}
 		}
 	}
 	return KEYWORD(result);
 }
+
+KEYWORD getKeywordIndex(const char* keywordString)
+{
+	for (u32 slot = hashKeyword(keywordString) & KEYWORD_HASH_MASK; s_keywordTable.slots[slot] >= 0; slot = (slot + 1) & KEYWORD_HASH_MASK)
+	{
+		const s32 index = s_keywordTable.slots[slot];
+		if (!strcasecmp(keywordString, c_keywords[index]))
+		{
+			return KEYWORD(index);
+		}
+	}
+	return KW_UNKNOWN;
+}
+
+static volatile s32 s_benchmarkSink = 0;
+
+void benchmarkKeywordLookup(s32 iterations, f64* hashTime, f64* linearTime)
+{
+	// Look up every keyword in lower case plus a few misses, which is the worst case for the linear search.
+	std::vector<std::string> tokens;
+	for (u32 i = 0; i < KEYWORD_COUNT; i++)
+	{
+		std::string token = c_keywords[i];
+		for (size_t c = 0; c < token.length(); c++) { token[c] = tolower(token[c]); }
+		tokens.push_back(token);
+	}
+	tokens.push_back("unknown:");
+	tokens.push_back("123");
+	tokens.push_back("");
+
+	const size_t tokenCount = tokens.size();
+	for (size_t t = 0; t < tokenCount; t++)
+	{
+		// Both searches must agree on every token.
+		if (getKeywordIndex(tokens[t].c_str()) != getKeywordIndexLinear(tokens[t].c_str()))
+		{
+			TFE_System::logWrite(LOG_ERROR, "Keywords", "Hashed and linear keyword lookups do not match for '%s'.", tokens[t].c_str());
+		}
+	}
+
+	s32 check = 0;
+	u64 start = TFE_System::getCurrentTimeInTicks();
+	for (s32 i = 0; i < iterations; i++)
+	{
+		for (size_t t = 0; t < tokenCount; t++) { check += getKeywordIndex(tokens[t].c_str()); }
+	}
+	*hashTime = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - start);
+
+	start = TFE_System::getCurrentTimeInTicks();
+	for (s32 i = 0; i < iterations; i++)
+	{
+		for (size_t t = 0; t < tokenCount; t++) { check -= getKeywordIndexLinear(tokens[t].c_str()); }
+	}
+	*linearTime = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - start);
+
+	// Keep the lookups from being optimized away.
+	s_benchmarkSink = check;
+}
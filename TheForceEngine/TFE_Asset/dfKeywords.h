@@ -235,4 +235,6 @@ enum KEYWORD
 	KW_COUNT
 };
 
-extern KEYWORD getKeywordIndex(const char* keywordString);
\ No newline at end of file
+extern KEYWORD getKeywordIndex(const char* keywordString);
+// Times 'iterations' lookups of every keyword using the hash table and the original linear search.
+extern void benchmarkKeywordLookup(s32 iterations, f64* hashTime, f64* linearTime);
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <mutex>
 
 #define IL_USE_PRAGMA_LIBS
 #include <IL/il.h>
@@ -18,6 +19,9 @@ namespace TFE_Image
 	typedef std::map<std::string, Image*> ImageMap;
 	static ImageMap s_images;
 	static std::vector<u8> s_buffer;
+	// DevIL keeps global state, so images can only be processed by one thread at a time.
+	// Save games encode their screenshots on a worker thread.
+	static std::recursive_mutex s_imageLock;
 
 	void init()
 	{
@@ -40,6 +44,7 @@ namespace TFE_Image
 
 	Image* loadFromMemory(const u8* buffer, size_t size)
 	{
+		std::lock_guard<std::recursive_mutex> lock(s_imageLock);
 		Image* image = new Image;
 
 		// Now let's switch over to using devIL...
@@ -69,6 +74,7 @@ namespace TFE_Image
 
 	Image* get(const char* imagePath)
 	{
+		std::lock_guard<std::recursive_mutex> lock(s_imageLock);
 		ImageMap::iterator iImage = s_images.find(imagePath);
 		if (iImage != s_images.end())
 		{
@@ -107,6 +113,7 @@ namespace TFE_Image
 
 	void free(Image* image)
 	{
+		std::lock_guard<std::recursive_mutex> lock(s_imageLock);
 		if (!image) { return; }
 		delete[] image->data;
 
@@ -124,6 +131,7 @@ namespace TFE_Image
 
 	void freeAll()
 	{
+		std::lock_guard<std::recursive_mutex> lock(s_imageLock);
 		ImageMap::iterator iImage = s_images.begin();
 		for (; iImage != s_images.end(); ++iImage)
 		{
@@ -139,6 +147,7 @@ namespace TFE_Image
 
 	void writeImage(const char* path, u32 width, u32 height, u32* pixelData)
 	{
+		std::lock_guard<std::recursive_mutex> lock(s_imageLock);
 		ILuint handle;
 		ilGenImages(1, &handle);
 		ilBindImage(handle);
@@ -218,6 +227,7 @@ namespace TFE_Image
 	//////////////////////////////////////////////////////
 	size_t writeImageToMemory(u8*& output, u32 width, u32 height, const u32* pixelData)
 	{
+		std::lock_guard<std::recursive_mutex> lock(s_imageLock);
 		s_memStream.open(Stream::MODE_WRITE);
 		ilSetWrite(iOpen, iClose, iPutc, iSeek, iTell, iWrite);
 
@@ -230,8 +240,18 @@ namespace TFE_Image
 		return s_memStream.getSize();
 	}
 
-	void readImageFromMemory(Image* output, size_t size, const u32* pixelData)
+	size_t writeImageToMemory(std::vector<u8>& output, u32 width, u32 height, const u32* pixelData)
 	{
+		std::lock_guard<std::recursive_mutex> lock(s_imageLock);
+		u8* data;
+		const size_t size = writeImageToMemory(data, width, height, pixelData);
+		output.assign(data, data + size);
+		return size;
+	}
+
+	bool readImageFromMemory(Image* output, size_t size, const u32* pixelData, size_t capacity)
+	{
+		std::lock_guard<std::recursive_mutex> lock(s_imageLock);
 		s_memStream.load(size, pixelData);
 		s_memStream.open(Stream::MODE_READ);
 		ilSetRead(iOpen, iClose, iEof, iGetc, iRead, iSeek, iTell);
@@ -242,22 +262,26 @@ namespace TFE_Image
 		// In the next section, we load one image
 		ilGenImages(1, &handle);
 		ilBindImage(handle);
-		if (ilLoadImage("image.png") == IL_FALSE)
+		bool result = false;
+		if (ilLoadImage("image.png") == IL_TRUE)
 		{
-			ILenum error = ilGetError();
-			return;
+			// Only copy the pixels if they fit into the output buffer.
+			const u32 width  = (u32)ilGetInteger(IL_IMAGE_WIDTH);
+			const u32 height = (u32)ilGetInteger(IL_IMAGE_HEIGHT);
+			if (size_t(width) * size_t(height) <= capacity)
+			{
+				output->width = width;
+				output->height = height;
+				ilCopyPixels(0, 0, 0, width, height, 1, IL_RGBA, IL_UNSIGNED_BYTE, output->data);
+				result = true;
+			}
 		}
 
-		// Lets spy on it a little bit
-		output->width = (u32)ilGetInteger(IL_IMAGE_WIDTH);  // getting image width
-		output->height = (u32)ilGetInteger(IL_IMAGE_HEIGHT); // and height
-		// get the image data
-		ilCopyPixels(0, 0, 0, output->width, output->height, 1, IL_RGBA, IL_UNSIGNED_BYTE, output->data);
-
 		// Finally, clean the mess!
 		ilDeleteImages(1, &handle);
 
 		ilResetRead();
 		s_memStream.close();
+		return result;
 	}
 }
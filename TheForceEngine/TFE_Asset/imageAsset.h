@@ -5,6 +5,7 @@
 // Can use std_image.h and std_image_write.h for reading and writing.
 //////////////////////////////////////////////////////////////////////
 #include <TFE_System/types.h>
+#include <vector>
 
 struct Image
 {
@@ -25,6 +26,10 @@ namespace TFE_Image
 
 	void writeImage(const char* path, u32 width, u32 height, u32* pixelData);
 
+	// The output points to an internal buffer that is overwritten by the next call.
 	size_t writeImageToMemory(u8*& output, u32 width, u32 height, const u32* pixelData);
-	void readImageFromMemory(Image* output, size_t size, const u32* pixelData);
+	// Copies the encoded image into 'output', safe to call from any thread.
+	size_t writeImageToMemory(std::vector<u8>& output, u32 width, u32 height, const u32* pixelData);
+	// Decodes into 'output->data', which must hold 'capacity' pixels. Fails if the image is larger.
+	bool readImageFromMemory(Image* output, size_t size, const u32* pixelData, size_t capacity);
 }
@@ -4,6 +4,7 @@
 #include <TFE_System/system.h>
 #include <TFE_Settings/settings.h>
 #include <TFE_Asset/assetSystem.h>
+#include <TFE_Asset/assetCache.h>
 #include <TFE_FileSystem/filestream.h>
 #include <TFE_FileSystem/paths.h>
 #include <TFE_System/parser.h>
@@ -159,15 +160,61 @@ namespace TFE_Model_Jedi
 	typedef std::vector<JediModel*> ModelList;
 	typedef std::map<std::string, TextureData*> TextureMap;
 	typedef std::vector<std::string> NameList;
+
+	// Where each model came from, so it can be handed to the asset cache when the pool is freed.
+	struct ModelSource
+	{
+		std::string key;		// empty if the model is not cached.
+		NameList textureNames;	// name of the texture loaded for each slot, empty for <NoTexture>.
+	};
+	typedef std::vector<ModelSource> SourceList;
+
+	// Cached models are stored as a single block: the header, vertices, polygon normals, vertex normals (if any),
+	// polygons, vertex indices, texture coordinates, texture sizes and finally the texture names.
+	struct ModelCacheHeader
+	{
+		s32 isBridge;
+		s32 flags;
+		s32 radius;
+		s32 vertexCount;
+		s32 polygonCount;
+		s32 textureCount;
+		s32 hasVertexNormals;
+		s32 indexCount;
+		s32 uvCount;
+		s32 nameSize;
+	};
+	struct ModelCachePolygon
+	{
+		s32 index;
+		s32 shading;
+		s32 p08;
+		s32 color;
+		s32 texture;	// index into the model textures or -1.
+		s32 vertexCount;
+		s32 hasUv;		// texture coordinates are stored per vertex.
+	};
+	// The texture coordinates are scaled by the texture size, so the model is parsed again if a texture changes size.
+	struct ModelCacheTexture
+	{
+		s32 uvWidth;
+		s32 uvHeight;
+	};
+
 	static ModelMap s_models[POOL_COUNT];
 	static ModelList s_modelList[POOL_COUNT];
 	static NameList s_modelNames[POOL_COUNT];
-	static std::vector<char> s_buffer;
+	static SourceList s_modelSources[POOL_COUNT];
+	static NameList s_textureNames;
+	static std::vector<u8> s_buffer;
 
 	// Remove 3DO limits.
 	static std::vector<vec2> s_tmpVtx;
 
-	bool parseModel(JediModel* model, const char* name, AssetPool pool);
+	bool parseModel(JediModel* model, const char* name, AssetPool pool, const char* fileBuffer, size_t len);
+	JediModel* restoreCached(const std::string& key, AssetPool pool, NameList& textureNames);
+	void buildCacheKey(const FilePath* filePath, std::string& key);
+	void allocatePolygon(JmPolygon* polygon, s32 vertexCount);
 
 	JediModel* get(const char* name, AssetPool pool)
 	{
@@ -183,27 +230,43 @@ namespace TFE_Model_Jedi
 		{
 			return nullptr;
 		}
-		FileStream file;
-		if (!file.open(&filePath, Stream::MODE_READ))
+		s_memRegion = (pool == POOL_GAME) ? s_gameRegion : s_levelRegion;
+
+		// Level models kept from a previous level only need to be copied into the level memory.
+		ModelSource source;
+		if (pool == POOL_LEVEL)
+		{
+			buildCacheKey(&filePath, source.key);
+			JediModel* model = restoreCached(source.key, pool, source.textureNames);
+			if (model)
+			{
+				s_models[pool][name] = model;
+				s_modelList[pool].push_back(model);
+				s_modelNames[pool].push_back(name);
+				s_modelSources[pool].push_back(source);
+				return model;
+			}
+		}
+
+		// Parse directly from the archive when it is memory-mapped.
+		size_t len;
+		const u8* data = FileStream::readContentsView(&filePath, s_buffer, &len);
+		if (!data)
 		{
 			return nullptr;
 		}
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
-		file.close();
 			
-		s_memRegion = (pool == POOL_GAME) ? s_gameRegion : s_levelRegion;
 		JediModel* model = (JediModel*)model_alloc(sizeof(JediModel));
 		memset(model, 0, sizeof(JediModel));
 
 		////////////////////////////////////////////////////////////////
 		// Load and parse the model.
 		////////////////////////////////////////////////////////////////
-		if (!parseModel(model, name, pool))
+		if (!parseModel(model, name, pool, (const char*)data, len))
 		{
 			return nullptr;
 		}
+		source.textureNames.swap(s_textureNames);
 
 		////////////////////////////////////////////////////////////////
 		// Post process the model.
@@ -246,6 +309,211 @@ namespace TFE_Model_Jedi
 		s_models[pool][name] = model;
 		s_modelList[pool].push_back(model);
 		s_modelNames[pool].push_back(name);
+		s_modelSources[pool].push_back(source);
+		return model;
+	}
+
+	void buildCacheKey(const FilePath* filePath, std::string& key)
+	{
+		TFE_AssetCache::buildKey(TFE_AssetCache::ACACHE_MODEL, filePath, key);
+		// Both settings change the result of parsing the model.
+		const TFE_Settings_Graphics* graphics = TFE_Settings::getGraphicsSettings();
+		key += graphics->fix3doNormalOverflow ? "|n1" : "|n0";
+		key += graphics->ignore3doLimits ? "|l1" : "|l0";
+	}
+
+	void freeCached(void* cached)
+	{
+		free(cached);
+	}
+
+	// Copy a model into a single block of memory that does not depend on the level memory.
+	void addToCache(const JediModel* model, const ModelSource& source)
+	{
+		if (source.key.empty() || (s32)source.textureNames.size() != model->textureCount) { return; }
+
+		ModelCacheHeader header;
+		header.isBridge = model->isBridge;
+		header.flags = model->flags;
+		header.radius = model->radius;
+		header.vertexCount = model->vertexCount;
+		header.polygonCount = model->polygonCount;
+		header.textureCount = model->textureCount;
+		header.hasVertexNormals = model->vertexNormals ? 1 : 0;
+		header.indexCount = 0;
+		header.uvCount = 0;
+		header.nameSize = 0;
+		for (s32 p = 0; p < model->polygonCount; p++)
+		{
+			header.indexCount += model->polygons[p].vertexCount;
+			header.uvCount += model->polygons[p].uv ? model->polygons[p].vertexCount : 0;
+		}
+		for (s32 t = 0; t < model->textureCount; t++)
+		{
+			header.nameSize += s32(source.textureNames[t].length() + 1);
+		}
+
+		const s32 normalCount = header.polygonCount + (header.hasVertexNormals ? header.vertexCount : 0);
+		const size_t size = sizeof(ModelCacheHeader) + sizeof(vec3) * (header.vertexCount + normalCount) + sizeof(ModelCachePolygon) * header.polygonCount
+			+ sizeof(s32) * header.indexCount + sizeof(vec2) * header.uvCount + sizeof(ModelCacheTexture) * header.textureCount + header.nameSize;
+		u8* cached = (u8*)malloc(size);
+		u8* out = cached;
+
+		memcpy(out, &header, sizeof(ModelCacheHeader)); out += sizeof(ModelCacheHeader);
+		memcpy(out, model->vertices, sizeof(vec3) * header.vertexCount); out += sizeof(vec3) * header.vertexCount;
+		memcpy(out, model->polygonNormals, sizeof(vec3) * header.polygonCount); out += sizeof(vec3) * header.polygonCount;
+		if (header.hasVertexNormals)
+		{
+			memcpy(out, model->vertexNormals, sizeof(vec3) * header.vertexCount); out += sizeof(vec3) * header.vertexCount;
+		}
+
+		ModelCachePolygon* outPolygon = (ModelCachePolygon*)out;
+		out += sizeof(ModelCachePolygon) * header.polygonCount;
+		for (s32 p = 0; p < model->polygonCount; p++, outPolygon++)
+		{
+			const JmPolygon* polygon = &model->polygons[p];
+			outPolygon->index = polygon->index;
+			outPolygon->shading = polygon->shading;
+			outPolygon->p08 = polygon->p08;
+			outPolygon->color = polygon->color;
+			outPolygon->texture = -1;
+			for (s32 t = 0; t < model->textureCount && polygon->texture; t++)
+			{
+				if (model->textures[t] == polygon->texture)
+				{
+					outPolygon->texture = t;
+					break;
+				}
+			}
+			outPolygon->vertexCount = polygon->vertexCount;
+			outPolygon->hasUv = polygon->uv ? 1 : 0;
+		}
+		for (s32 p = 0; p < model->polygonCount; p++)
+		{
+			memcpy(out, model->polygons[p].indices, sizeof(s32) * model->polygons[p].vertexCount);
+			out += sizeof(s32) * model->polygons[p].vertexCount;
+		}
+		for (s32 p = 0; p < model->polygonCount; p++)
+		{
+			if (!model->polygons[p].uv) { continue; }
+			memcpy(out, model->polygons[p].uv, sizeof(vec2) * model->polygons[p].vertexCount);
+			out += sizeof(vec2) * model->polygons[p].vertexCount;
+		}
+
+		ModelCacheTexture* outTexture = (ModelCacheTexture*)out;
+		out += sizeof(ModelCacheTexture) * header.textureCount;
+		for (s32 t = 0; t < model->textureCount; t++, outTexture++)
+		{
+			const TextureData* texture = model->textures[t];
+			outTexture->uvWidth  = texture ? texture->uvWidth  : 0;
+			outTexture->uvHeight = texture ? texture->uvHeight : 0;
+		}
+		for (s32 t = 0; t < model->textureCount; t++)
+		{
+			const size_t nameLen = source.textureNames[t].length() + 1;
+			memcpy(out, source.textureNames[t].c_str(), nameLen);
+			out += nameLen;
+		}
+		assert(out == cached + size);
+
+		TFE_AssetCache::add(source.key, cached, size, freeCached);
+	}
+
+	// Rebuild a cached model in the current memory region, returns null if it is not cached or a texture has changed.
+	JediModel* restoreCached(const std::string& key, AssetPool pool, NameList& textureNames)
+	{
+		size_t size;
+		u8* cached = (u8*)TFE_AssetCache::take(key, &size);
+		if (!cached) { return nullptr; }
+
+		const u8* in = cached;
+		ModelCacheHeader header;
+		memcpy(&header, in, sizeof(ModelCacheHeader)); in += sizeof(ModelCacheHeader);
+		const vec3* vertices = (vec3*)in; in += sizeof(vec3) * header.vertexCount;
+		const vec3* polygonNormals = (vec3*)in; in += sizeof(vec3) * header.polygonCount;
+		const vec3* vertexNormals = nullptr;
+		if (header.hasVertexNormals)
+		{
+			vertexNormals = (vec3*)in; in += sizeof(vec3) * header.vertexCount;
+		}
+		const ModelCachePolygon* polygons = (ModelCachePolygon*)in; in += sizeof(ModelCachePolygon) * header.polygonCount;
+		const s32* indices = (s32*)in; in += sizeof(s32) * header.indexCount;
+		const vec2* uv = (vec2*)in; in += sizeof(vec2) * header.uvCount;
+		const ModelCacheTexture* textureSizes = (ModelCacheTexture*)in; in += sizeof(ModelCacheTexture) * header.textureCount;
+		const char* names = (const char*)in;
+
+		// Load the textures the same way as parseModel().
+		std::vector<TextureData*> textures(header.textureCount);
+		textureNames.resize(header.textureCount);
+		MemoryRegion* prevMemRegion = TFE_Jedi::bitmap_getAllocator();
+		TFE_Jedi::bitmap_setAllocator(s_memRegion);
+		bool texturesMatch = true;
+		for (s32 t = 0; t < header.textureCount; t++)
+		{
+			textureNames[t] = names;
+			names += textureNames[t].length() + 1;
+
+			textures[t] = textureNames[t].empty() ? nullptr : TFE_Jedi::bitmap_load(textureNames[t].c_str(), 1, pool);
+			const s32 uvWidth  = textures[t] ? textures[t]->uvWidth  : 0;
+			const s32 uvHeight = textures[t] ? textures[t]->uvHeight : 0;
+			texturesMatch = texturesMatch && uvWidth == textureSizes[t].uvWidth && uvHeight == textureSizes[t].uvHeight;
+		}
+		TFE_Jedi::bitmap_setAllocator(prevMemRegion);
+		if (!texturesMatch)
+		{
+			free(cached);
+			textureNames.clear();
+			return nullptr;
+		}
+
+		JediModel* model = (JediModel*)model_alloc(sizeof(JediModel));
+		memset(model, 0, sizeof(JediModel));
+		model->isBridge = header.isBridge;
+		model->flags = header.flags;
+		model->radius = header.radius;
+		model->drawId = nullptr;
+
+		model->vertexCount = header.vertexCount;
+		model->vertices = (vec3*)model_alloc(sizeof(vec3) * header.vertexCount);
+		memcpy(model->vertices, vertices, sizeof(vec3) * header.vertexCount);
+		model->polygonNormals = (vec3*)model_alloc(sizeof(vec3) * header.polygonCount);
+		memcpy(model->polygonNormals, polygonNormals, sizeof(vec3) * header.polygonCount);
+		if (vertexNormals)
+		{
+			model->vertexNormals = (vec3*)model_alloc(sizeof(vec3) * header.vertexCount);
+			memcpy(model->vertexNormals, vertexNormals, sizeof(vec3) * header.vertexCount);
+		}
+
+		if (header.textureCount)
+		{
+			model->textureCount = header.textureCount;
+			model->textures = (TextureData**)model_alloc(sizeof(TextureData*) * header.textureCount);
+			memcpy(model->textures, textures.data(), sizeof(TextureData*) * header.textureCount);
+		}
+
+		model->polygonCount = header.polygonCount;
+		model->polygons = (JmPolygon*)model_alloc(sizeof(JmPolygon) * header.polygonCount);
+		for (s32 p = 0; p < header.polygonCount; p++, polygons++)
+		{
+			JmPolygon* polygon = &model->polygons[p];
+			allocatePolygon(polygon, polygons->vertexCount);
+			polygon->index = polygons->index;
+			polygon->shading = polygons->shading;
+			polygon->p08 = polygons->p08;
+			polygon->color = polygons->color;
+			polygon->texture = polygons->texture >= 0 ? model->textures[polygons->texture] : nullptr;
+			memcpy(polygon->indices, indices, sizeof(s32) * polygons->vertexCount);
+			indices += polygons->vertexCount;
+
+			if (polygons->hasUv)
+			{
+				polygon->uv = (vec2*)model_alloc(sizeof(vec2) * polygons->vertexCount);
+				memcpy(polygon->uv, uv, sizeof(vec2) * polygons->vertexCount);
+				uv += polygons->vertexCount;
+			}
+		}
+
+		free(cached);
 		return model;
 	}
 
@@ -285,7 +553,7 @@ namespace TFE_Model_Jedi
 		return s_modelList[pool];
 	}
 
-	void freePool(AssetPool pool)
+	void freePool(AssetPool pool, bool cacheModels)
 	{
 		// Memory will get freed with the memory region automatically.
 		s_models[pool].clear();
@@ -293,13 +561,20 @@ namespace TFE_Model_Jedi
 		// free the memory of each models' drawId object
 		const size_t count = s_modelList[pool].size();
 		JediModel** models = s_modelList[pool].data();
+		const ModelSource* sources = s_modelSources[pool].data();
 		for (size_t i = 0; i < count; i++)
 		{
 			free(models[i]->drawId);
+			// Level models are copied to the asset cache, so the next level can reuse them.
+			if (cacheModels && pool == POOL_LEVEL)
+			{
+				addToCache(models[i], sources[i]);
+			}
 		}
 
 		s_modelList[pool].clear();
 		s_modelNames[pool].clear();
+		s_modelSources[pool].clear();
 	}
 
 	void serializeModels(Stream* stream)
@@ -307,7 +582,7 @@ namespace TFE_Model_Jedi
 		bool modeWrite = serialization_getMode() == SMODE_WRITE;
 		if (!modeWrite)
 		{
-			freePool(POOL_LEVEL);
+			freePool(POOL_LEVEL, true);
 		}
 
 		s32 count = (s32)s_modelNames[POOL_LEVEL].size();
@@ -341,13 +616,13 @@ namespace TFE_Model_Jedi
 	{
 		for (s32 p = 0; p < POOL_COUNT; p++)
 		{
-			freePool(AssetPool(p));
+			freePool(AssetPool(p), false);
 		}
 	}
 	
 	void freeLevelData()
 	{
-		freePool(POOL_LEVEL);
+		freePool(POOL_LEVEL, true);
 	}
 
 	void allocatePolygon(JmPolygon* polygon, s32 vertexCount)
@@ -361,10 +636,9 @@ namespace TFE_Model_Jedi
 		polygon->indices = (s32*)model_alloc(vertexCount * sizeof(s32));
 	}
 	
-	bool parseModel(JediModel* model, const char* name, AssetPool pool)
+	bool parseModel(JediModel* model, const char* name, AssetPool pool, const char* fileBuffer, size_t len)
 	{
-		if (s_buffer.empty()) { return false; }
-		const size_t len = s_buffer.size();
+		if (!len) { return false; }
 
 		model->isBridge = 0;
 		model->vertexCount = 0;
@@ -393,8 +667,7 @@ namespace TFE_Model_Jedi
 
 		TFE_Parser parser;
 		size_t bufferPos = 0;
-		parser.init(s_buffer.data(), len);
-		const char* fileBuffer = s_buffer.data();
+		parser.init(fileBuffer, len);
 		parser.addCommentString("#");
 
 		// For now just do what the original code does.
@@ -494,6 +767,7 @@ namespace TFE_Model_Jedi
 		MemoryRegion* prevMemRegion = TFE_Jedi::bitmap_getAllocator();
 		TFE_Jedi::bitmap_setAllocator(s_memRegion);
 		model->textures = nullptr;
+		s_textureNames.clear();
 		if (textureCount)
 		{
 			model->textures = (TextureData**)model_alloc(textureCount * sizeof(TextureData*));
@@ -509,16 +783,20 @@ namespace TFE_Model_Jedi
 				{
 					TFE_System::logWrite(LOG_WARNING, "Object3D_Load", "'%s' unable to parse TEXTURE: entry.", name);
 					*texture = TFE_Jedi::bitmap_load("default.bm", 1, pool);
+					s_textureNames.push_back("default.bm");
 					continue;
 				}
 
 				*texture = nullptr;
+				s_textureNames.push_back("");
 				if (strcasecmp(textureName, "<NoTexture>"))
 				{
 					*texture = TFE_Jedi::bitmap_load(textureName, 1, pool);
+					s_textureNames.back() = textureName;
 					if (!(*texture))
 					{
 						*texture = TFE_Jedi::bitmap_load("default.bm", 1, pool);
+						s_textureNames.back() = "default.bm";
 					}
 				}
 			}
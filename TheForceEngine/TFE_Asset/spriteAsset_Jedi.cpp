@@ -4,7 +4,9 @@
 #include <TFE_System/system.h>
 #include <TFE_FileSystem/filestream.h>
 #include <TFE_FileSystem/paths.h>
+#include <TFE_System/jobSystem.h>
 #include <TFE_Asset/assetSystem.h>
+#include <TFE_Asset/assetCache.h>
 #include <TFE_Jedi/Math/core_math.h>
 #include <TFE_Jedi/Level/robject.h>
 #include <TFE_Jedi/Serialization/serialization.h>
@@ -18,6 +20,7 @@
 #include <map>
 
 using namespace TFE_Jedi;
+using namespace TFE_AssetCache;
 
 namespace TFE_Sprite_Jedi
 {
@@ -27,40 +30,42 @@ namespace TFE_Sprite_Jedi
 	typedef std::vector<JediWax*> SpriteList;
 	typedef std::vector<std::string> NameList;
 
+	// Where each asset came from, so it can be handed to the asset cache when the pool is freed.
+	struct AssetSource
+	{
+		std::string key;
+		size_t size;
+	};
+	typedef std::vector<AssetSource> SourceList;
+
 	static FrameMap   s_frames[POOL_COUNT];
 	static SpriteMap  s_sprites[POOL_COUNT];
 	static FrameList  s_frameList[POOL_COUNT];
 	static SpriteList s_spriteList[POOL_COUNT];
 	static NameList   s_frameNames[POOL_COUNT];
 	static NameList   s_spriteNames[POOL_COUNT];
+	static SourceList s_frameSources[POOL_COUNT];
+	static SourceList s_spriteSources[POOL_COUNT];
 	static std::vector<u8> s_buffer;
+	static std::vector<u32> s_cellOffsets;
 
-	JediFrame* getFrame(const char* name, AssetPool pool)
+	// An asset read by prefetchFrame() or prefetchWax() while it is built by a job.
+	struct PendingAsset
+	{
+		const u8* data;
+		size_t len;
+		std::vector<u8> buffer;	// file contents, if the archive is not memory-mapped.
+		void* asset;			// null if the data was not valid.
+		std::string key;		// asset cache key.
+		size_t size;			// size of the asset in bytes.
+	};
+	typedef std::map<std::string, PendingAsset*> PendingMap;
+	static PendingMap s_pendingFrames[POOL_COUNT];
+	static PendingMap s_pendingSprites[POOL_COUNT];
+
+	// Build the frame asset from the file data, this only reads 'data' and allocates with malloc() so it can run on any thread.
+	JediFrame* loadFrame(const u8* data, size_t len, size_t* assetSize)
 	{
-		FrameMap::iterator iFrame = s_frames[pool].find(name);
-		if (iFrame != s_frames[pool].end())
-		{
-			return iFrame->second;
-		}
-
-		// It doesn't exist yet, try to load the frame.
-		FilePath filePath;
-		if (!TFE_Paths::getFilePath(name, &filePath))
-		{
-			return nullptr;
-		}
-		FileStream file;
-		if (!file.open(&filePath, Stream::MODE_READ))
-		{
-			return nullptr;
-		}
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
-		file.close();
-
-		const u8* data = s_buffer.data();
-
 		// Determine ahead of time how much we need to allocate.
 		const WaxFrame* base_frame = (WaxFrame*)data;
 		const WaxCell* base_cell = WAX_CellPtr(data, base_frame);
@@ -68,10 +73,11 @@ namespace TFE_Sprite_Jedi
 
 		// This is a "load in place" format in the original code.
 		// We are going to allocate new memory and copy the data.
-		u8* assetPtr = (u8*)malloc(s_buffer.size() + columnSize);
+		*assetSize = len + columnSize;
+		u8* assetPtr = (u8*)malloc(*assetSize);
 		JediFrame* asset = (JediFrame*)assetPtr;
 		
-		memcpy(asset, data, s_buffer.size());
+		memcpy(asset, data, len);
 
 		WaxFrame* frame = asset;
 		WaxCell* cell = WAX_CellPtr(asset, frame);
@@ -93,7 +99,7 @@ namespace TFE_Sprite_Jedi
 		}
 		else
 		{
-			u32* columns = (u32*)((u8*)asset + s_buffer.size());
+			u32* columns = (u32*)((u8*)asset + len);
 			// Local pointer.
 			cell->columnOffset = u32((u8*)columns - (u8*)asset);
 			// Calculate column offsets.
@@ -102,24 +108,74 @@ namespace TFE_Sprite_Jedi
 				columns[c] = cell->sizeY * c;
 			}
 		}
-		
+		return asset;
+	}
+
+	void loadFrameJob(void* userData)
+	{
+		PendingAsset* pending = (PendingAsset*)userData;
+		pending->asset = loadFrame(pending->data, pending->len, &pending->size);
+	}
+
+	JediFrame* getFrame(const char* name, AssetPool pool)
+	{
+		FrameMap::iterator iFrame = s_frames[pool].find(name);
+		if (iFrame != s_frames[pool].end())
+		{
+			return iFrame->second;
+		}
+
+		JediFrame* asset = nullptr;
+		AssetSource source = { "", 0 };
+		PendingMap::iterator iPending = s_pendingFrames[pool].find(name);
+		if (iPending != s_pendingFrames[pool].end())
+		{
+			asset = (JediFrame*)iPending->second->asset;
+			source.key.swap(iPending->second->key);
+			source.size = iPending->second->size;
+			delete iPending->second;
+			s_pendingFrames[pool].erase(iPending);
+		}
+		else
+		{
+			// It doesn't exist yet, try to load the frame.
+			FilePath filePath;
+			if (!TFE_Paths::getFilePath(name, &filePath))
+			{
+				return nullptr;
+			}
+			buildKey(ACACHE_FRAME, &filePath, source.key);
+			asset = (JediFrame*)take(source.key, &source.size);
+			if (!asset)
+			{
+				// The data is copied into the asset, so read it directly from the archive when it is memory-mapped.
+				size_t len;
+				const u8* data = FileStream::readContentsView(&filePath, s_buffer, &len);
+				if (!data)
+				{
+					return nullptr;
+				}
+				asset = loadFrame(data, len, &source.size);
+			}
+		}
+		if (!asset) { return nullptr; }
+
 		s_frames[pool][name] = asset;
 		s_frameList[pool].push_back(asset);
 		s_frameNames[pool].push_back(name);
+		s_frameSources[pool].push_back(source);
 		return asset;
 	}
 
-	static std::vector<u32> s_cellOffsets;
-
-	bool isUniqueCell(u32 offset)
+	bool isUniqueCell(std::vector<u32>& cellOffsets, u32 offset)
 	{
-		const size_t count = s_cellOffsets.size();
-		const u32* offsetList = s_cellOffsets.data();
+		const size_t count = cellOffsets.size();
+		const u32* offsetList = cellOffsets.data();
 		for (u32 i = 0; i < count; i++)
 		{
 			if (offsetList[i] == offset) { return false; }
 		}
-		s_cellOffsets.push_back(offset);
+		cellOffsets.push_back(offset);
 
 		return true;
 	}
@@ -186,31 +242,9 @@ namespace TFE_Sprite_Jedi
 		}
 	}
 		
-	JediWax* getWax(const char* name, AssetPool pool)
+	// Build the wax asset from the file data, this only reads 'data' and allocates with malloc() so it can run on any thread.
+	JediWax* loadWax(const u8* data, size_t len, std::vector<u32>& cellOffsets, size_t* assetSize)
 	{
-		SpriteMap::iterator iSprite = s_sprites[pool].find(name);
-		if (iSprite != s_sprites[pool].end())
-		{
-			return iSprite->second;
-		}
-
-		// It doesn't exist yet, try to load the frame.
-		FilePath filePath;
-		if (!TFE_Paths::getFilePath(name, &filePath))
-		{
-			return nullptr;
-		}
-		FileStream file;
-		if (!file.open(&filePath, Stream::MODE_READ))
-		{
-			return nullptr;
-		}
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
-		file.close();
-
-		const u8* data = s_buffer.data();
 		const Wax* srcWax = (Wax*)data;
 		
 		// every animation is filled out until the end, so no animations = no wax.
@@ -218,10 +252,10 @@ namespace TFE_Sprite_Jedi
 		{
 			return nullptr;
 		}
-		s_cellOffsets.clear();
+		cellOffsets.clear();
 
 		// First determine the size to allocate (note that this will overallocate a bit because cells are shared).
-		u32 sizeToAlloc = sizeof(JediWax) + (u32)s_buffer.size();
+		u32 sizeToAlloc = sizeof(JediWax) + (u32)len;
 		const s32* animOffset = srcWax->animOffsets;
 		for (s32 animIdx = 0; animIdx < 32 && animOffset[animIdx]; animIdx++)
 		{
@@ -235,7 +269,7 @@ namespace TFE_Sprite_Jedi
 				{
 					const WaxFrame* frame = (WaxFrame*)(data + frameOffset[f]);
 					const WaxCell* cell = frame->cellOffset ? (WaxCell*)(data + frame->cellOffset) : nullptr;
-					if (cell && cell->compressed == 0 && isUniqueCell(frame->cellOffset))
+					if (cell && cell->compressed == 0 && isUniqueCell(cellOffsets, frame->cellOffset))
 					{
 						sizeToAlloc += cell->sizeX * sizeof(u32);
 					}
@@ -244,9 +278,10 @@ namespace TFE_Sprite_Jedi
 		}
 
 		// Allocate and copy the data (this is a "copy in place" format... mostly.
+		*assetSize = sizeToAlloc;
 		JediWax* asset = (JediWax*)malloc(sizeToAlloc);
 		Wax* dstWax = asset;
-		memcpy(dstWax, srcWax, s_buffer.size());
+		memcpy(dstWax, srcWax, len);
 
 		// Loop through animation list until we reach 32 (maximum count) or a null animation.
 		// This means that animations are contiguous.
@@ -308,7 +343,7 @@ namespace TFE_Sprite_Jedi
 							}
 							else
 							{
-								u32* columns = (u32*)((u8*)asset + s_buffer.size() + cellOffsetPtr);
+								u32* columns = (u32*)((u8*)asset + len + cellOffsetPtr);
 								cellOffsetPtr += dstCell->sizeX * sizeof(u32);
 
 								// Local pointer.
@@ -338,12 +373,144 @@ namespace TFE_Sprite_Jedi
 			}
 		}
 		asset->animCount = animIdx;
+		return asset;
+	}
+
+	void loadWaxJob(void* userData)
+	{
+		PendingAsset* pending = (PendingAsset*)userData;
+		std::vector<u32> cellOffsets;
+		pending->asset = loadWax(pending->data, pending->len, cellOffsets, &pending->size);
+	}
+
+	JediWax* getWax(const char* name, AssetPool pool)
+	{
+		SpriteMap::iterator iSprite = s_sprites[pool].find(name);
+		if (iSprite != s_sprites[pool].end())
+		{
+			return iSprite->second;
+		}
+
+		JediWax* asset = nullptr;
+		AssetSource source = { "", 0 };
+		PendingMap::iterator iPending = s_pendingSprites[pool].find(name);
+		if (iPending != s_pendingSprites[pool].end())
+		{
+			asset = (JediWax*)iPending->second->asset;
+			source.key.swap(iPending->second->key);
+			source.size = iPending->second->size;
+			delete iPending->second;
+			s_pendingSprites[pool].erase(iPending);
+		}
+		else
+		{
+			// It doesn't exist yet, try to load the frame.
+			FilePath filePath;
+			if (!TFE_Paths::getFilePath(name, &filePath))
+			{
+				return nullptr;
+			}
+			buildKey(ACACHE_WAX, &filePath, source.key);
+			asset = (JediWax*)take(source.key, &source.size);
+			if (!asset)
+			{
+				// The data is copied into the asset, so read it directly from the archive when it is memory-mapped.
+				size_t len;
+				const u8* data = FileStream::readContentsView(&filePath, s_buffer, &len);
+				if (!data)
+				{
+					return nullptr;
+				}
+				asset = loadWax(data, len, s_cellOffsets, &source.size);
+			}
+		}
+		if (!asset) { return nullptr; }
 
 		s_sprites[pool][name] = asset;
 		s_spriteList[pool].push_back(asset);
 		s_spriteNames[pool].push_back(name);
+		s_spriteSources[pool].push_back(source);
 		return asset;
 	}
+
+	// Read the file now and build the asset on a worker thread, the job is added to 'counter'.
+	void prefetchAsset(PendingMap& pendingMap, AssetCacheType type, const char* name, JobFunc loadJob, atomic_s32* counter)
+	{
+		if (pendingMap.find(name) != pendingMap.end())
+		{
+			return;
+		}
+
+		FilePath filePath;
+		if (!TFE_Paths::getFilePath(name, &filePath))
+		{
+			return;
+		}
+		PendingAsset* pending = new PendingAsset();
+		pending->data = nullptr;
+		pending->len = 0;
+		pending->size = 0;
+
+		// Assets kept from a previous level do not need to be read or built again.
+		buildKey(type, &filePath, pending->key);
+		pending->asset = take(pending->key, &pending->size);
+		if (pending->asset)
+		{
+			pendingMap[name] = pending;
+			return;
+		}
+
+		pending->data = FileStream::readContentsView(&filePath, pending->buffer, &pending->len);
+		if (!pending->data)
+		{
+			delete pending;
+			return;
+		}
+		pendingMap[name] = pending;
+		TFE_Jobs::addJob(loadJob, pending, counter);
+	}
+
+	void prefetchFrame(const char* name, atomic_s32* counter, AssetPool pool)
+	{
+		if (s_frames[pool].find(name) != s_frames[pool].end()) { return; }
+		prefetchAsset(s_pendingFrames[pool], ACACHE_FRAME, name, loadFrameJob, counter);
+	}
+
+	void prefetchWax(const char* name, atomic_s32* counter, AssetPool pool)
+	{
+		if (s_sprites[pool].find(name) != s_sprites[pool].end()) { return; }
+		prefetchAsset(s_pendingSprites[pool], ACACHE_WAX, name, loadWaxJob, counter);
+	}
+
+	void freeAsset(void* asset)
+	{
+		free(asset);
+	}
+
+	// Level assets are handed to the asset cache, so the next level can reuse them.
+	void releaseAsset(AssetPool pool, void* asset, const AssetSource& source)
+	{
+		if (pool == POOL_LEVEL && !source.key.empty())
+		{
+			add(source.key, asset, source.size, freeAsset);
+		}
+		else
+		{
+			free(asset);
+		}
+	}
+
+	void freePending(PendingMap& pendingMap, AssetPool pool)
+	{
+		PendingMap::iterator iPending = pendingMap.begin();
+		for (; iPending != pendingMap.end(); ++iPending)
+		{
+			const PendingAsset* pending = iPending->second;
+			releaseAsset(pool, pending->asset, { pending->key, pending->size });
+			delete pending;
+		}
+		pendingMap.clear();
+	}
 				
 	const std::vector<JediWax*>& getWaxList(AssetPool pool)
 	{
@@ -359,23 +526,30 @@ namespace TFE_Sprite_Jedi
 	{
 		const size_t frameCount = s_frameList[pool].size();
 		JediFrame** frameList = s_frameList[pool].data();
+		const AssetSource* frameSources = s_frameSources[pool].data();
 		for (size_t i = 0; i < frameCount; i++)
 		{
-			free(frameList[i]);
+			releaseAsset(pool, frameList[i], frameSources[i]);
 		}
 		s_frames[pool].clear();
 		s_frameList[pool].clear();
 		s_frameNames[pool].clear();
+		s_frameSources[pool].clear();
 
 		const size_t waxCount = s_spriteList[pool].size();
 		JediWax** waxList = s_spriteList[pool].data();
+		const AssetSource* waxSources = s_spriteSources[pool].data();
 		for (size_t i = 0; i < waxCount; i++)
 		{
-			free(waxList[i]);
+			releaseAsset(pool, waxList[i], waxSources[i]);
 		}
 		s_sprites[pool].clear();
 		s_spriteList[pool].clear();
 		s_spriteNames[pool].clear();
+		s_spriteSources[pool].clear();
+
+		freePending(s_pendingFrames[pool], pool);
+		freePending(s_pendingSprites[pool], pool);
 	}
 
 	void freeAll()
@@ -92,6 +92,10 @@ namespace TFE_Sprite_Jedi
 {
 	JediFrame* getFrame(const char* name, AssetPool pool = POOL_LEVEL);
 	JediWax*   getWax(const char* name, AssetPool pool = POOL_LEVEL);
+	// Read the file now and build the asset on a worker thread, the job is added to 'counter'.
+	// getFrame()/getWax() pick up the asset, which must wait for the counter to reach zero first.
+	void prefetchFrame(const char* name, atomic_s32* counter, AssetPool pool = POOL_LEVEL);
+	void prefetchWax(const char* name, atomic_s32* counter, AssetPool pool = POOL_LEVEL);
 	void freeAll();
 	void freeLevelData();
 
@@ -449,6 +449,8 @@ namespace TFE_Audio
 	// Audio callback
 	s32 audioCallback(void *outputBuffer, void* inputBuffer, u32 bufferSize, f64 streamTime, u32 status, void* userData)
 	{
+		TFE_Profiler::setThreadName("Audio");
+		TFE_ZONE("Audio Callback");
 		f32* buffer = (f32*)outputBuffer;
 
 	#if AUDIO_TIMING == 1
@@ -4,6 +4,7 @@
 #include "systemMidiDevice.h"
 #include <TFE_Asset/gmidAsset.h>
 #include <TFE_System/system.h>
+#include <TFE_System/profiler.h>
 #include <TFE_System/Threads/thread.h>
 #include <TFE_Settings/settings.h>
 #include <TFE_FrontEndUI/console.h>
@@ -442,6 +443,7 @@ namespace TFE_MidiPlayer
 		u64 localTime = 0;
 		u64 localTimeCallback = 0;
 		f64 dt = 0.0;
+		TFE_Profiler::setThreadName("Midi");
 		while (runThread)
 		{
 			MUTEX_LOCK(&s_mutex);
@@ -485,6 +487,7 @@ namespace TFE_MidiPlayer
 				s_midiCallback.accumulator += TFE_System::updateThreadLocal(&localTimeCallback);
 				while (s_midiCallback.callback && s_midiCallback.accumulator >= s_midiCallback.timeStep)
 				{
+					TFE_ZONE("Midi Callback");
 					s_midiCallback.callback();
 					s_midiCallback.accumulator -= s_midiCallback.timeStep;
 					s_curNoteTime += s_midiCallback.timeStep;
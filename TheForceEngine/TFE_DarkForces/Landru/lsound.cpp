@@ -276,31 +276,30 @@ namespace TFE_DarkForces
 		}
 	}
 
-	u8* readVocFileData(const char* name, u32* sizeOut)
+	bool getVocFilePath(const char* name, FilePath* path)
 	{
-		FilePath path;
 		if (strstr(name, ".voc") || strstr(name, ".VOC"))
 		{
-			if (!TFE_Paths::getFilePath(name, &path))
-			{
-				return nullptr;
-			}
+			return TFE_Paths::getFilePath(name, path);
 		}
-		else
+
+		char fileName[TFE_MAX_PATH];
+		sprintf(fileName, "%s.VOIC", name);	// Prefer the version of a sound from the LFD.
+		if (!TFE_Paths::getFilePath(fileName, path))
 		{
-			char fileName[TFE_MAX_PATH];
-			sprintf(fileName, "%s.VOIC", name);	// Prefer the version of a sound from the LFD.
-			if (!TFE_Paths::getFilePath(fileName, &path))
+			sprintf(fileName, "%s.VOC", name);
+			if (!TFE_Paths::getFilePath(fileName, path))
 			{
-				sprintf(fileName, "%s.VOC", name);
-				if (!TFE_Paths::getFilePath(fileName, &path))
-				{
-					return nullptr;
-				}
+				return false;
 			}
 		}
+		return true;
+	}
+
+	u8* readVocFileData(const FilePath* path, u32* sizeOut)
+	{
 		FileStream file;
-		if (!file.open(&path, Stream::MODE_READ))
+		if (!file.open(path, Stream::MODE_READ))
 		{
 			return nullptr;
 		}
@@ -321,6 +320,16 @@ namespace TFE_DarkForces
 		return data;
 	}
 
+	u8* readVocFileData(const char* name, u32* sizeOut)
+	{
+		FilePath path;
+		if (!getVocFilePath(name, &path))
+		{
+			return nullptr;
+		}
+		return readVocFileData(&path, sizeOut);
+	}
+
 	/////////////////////////////////////////////////////////
 	// System Internal
 	/////////////////////////////////////////////////////////
@@ -8,6 +8,7 @@
 //////////////////////////////////////////////////////////////////////
 #include <TFE_System/types.h>
 #include <TFE_Jedi/Math/core_math.h>
+#include <TFE_FileSystem/paths.h>
 
 enum LSoundConst
 {
@@ -91,5 +92,8 @@ namespace TFE_DarkForces
 	JBool isSoundKeepable(LSound* sound);
 	void  setSoundName(LSound* sound, u32 type, const char* name);
 
+	// Find the sound file, the LFD version (.VOIC) is preferred if 'name' has no extension.
+	bool getVocFilePath(const char* name, FilePath* path);
+	u8* readVocFileData(const FilePath* path, u32* size = nullptr);
 	u8* readVocFileData(const char* name, u32* size = nullptr);
 }  // namespace TFE_Jedi
\ No newline at end of file
@@ -38,6 +38,7 @@
 #include <TFE_FileSystem/filestream.h>
 #include <TFE_Audio/midiPlayer.h>
 #include <TFE_Audio/audioSystem.h>
+#include <TFE_Asset/assetCache.h>
 #include <TFE_Asset/modelAsset_jedi.h>
 #include <TFE_Asset/spriteAsset_Jedi.h>
 #include <TFE_Archive/archive.h>
@@ -335,6 +336,7 @@ namespace TFE_DarkForces
 			saveLevelStatus();
 		}
 		freeAllMidi();
+		level_cancelPreload();
 
 		gameMessage_freeBuffer();
 		briefingList_freeBuffer();
@@ -368,6 +370,7 @@ namespace TFE_DarkForces
 		// TFE
 		TFE_Sprite_Jedi::freeAll();
 		TFE_Model_Jedi::freeAll();
+		TFE_AssetCache::clear();
 		reticle_enable(false);
 		texturepacker_reset();
 
@@ -582,6 +585,7 @@ namespace TFE_DarkForces
 			} break;
 			case GSTATE_CUTSCENE:
 			{
+				level_updatePreload();
 				if (!cutscene_update())
 				{
 					s_runGameState.cutsceneIndex++;
@@ -600,6 +604,7 @@ namespace TFE_DarkForces
 			{
 				s32 skill;
 				JBool abort;
+				level_updatePreload();
 				lmusic_reset();	// Fix a Dark Forces bug where music won't play when entering a cutscene again without restarting.
 				if (!missionBriefing_update(&skill, &abort))
 				{
@@ -654,10 +659,11 @@ namespace TFE_DarkForces
 					
 					startNextMode();
 
-					region_clear(s_levelRegion);
+					// Level assets are copied to the asset cache, so the level memory is cleared last.
 					bitmap_clearLevelData();
 					bitmap_setAllocator(s_gameRegion);
 					level_freeAllAssets();
+					region_clear(s_levelRegion);
 				}
 			} break;
 		}
@@ -713,6 +719,8 @@ namespace TFE_DarkForces
 				if (s_runGameState.cutscenesEnabled && cutscene_play(s_cutsceneData[s_runGameState.cutsceneIndex].cutscene))
 				{
 					s_runGameState.state = GSTATE_CUTSCENE;
+					// TFE: Prepare the next level in the background while the cutscene plays.
+					level_preload(agent_getLevelName());
 				}
 				else
 				{
@@ -742,6 +750,8 @@ namespace TFE_DarkForces
 					{
 						missionBriefing_start(brief->archive, brief->bgAnim, levelName, brief->palette, skill, &s_sharedState.langKeys);
 						s_runGameState.state = GSTATE_BRIEFING;
+						// TFE: Prepare the level in the background while the player reads the briefing.
+						level_preload(levelName);
 					}
 				}
 
@@ -1227,10 +1237,12 @@ namespace TFE_DarkForces
 		lmusic_reset();	// Fix a Dark Forces bug where music won't play when entering a cutscene again without restarting.
 		pda_cleanup();
 		reticle_enable(true);
+		level_cancelPreload();
 
-		region_clear(s_levelRegion);
+		// Level assets are copied to the asset cache, so the level memory is cleared last.
 		bitmap_clearLevelData();
 		level_freeAllAssets();
+		region_clear(s_levelRegion);
 
 		// Next
 		sound_levelStart();
@@ -1345,4 +1357,13 @@ namespace TFE_DarkForces
 		}
 		return true;
 	}
+
+	bool DarkForces::captureGameState(Stream* stream)
+	{
+		// Most sectors do not change between snapshots, so their data is copied from the previous capture.
+		level_setIncrementalCapture(true);
+		const bool ret = serializeGameState(stream, nullptr, true);
+		level_setIncrementalCapture(false);
+		return ret;
+	}
 }
\ No newline at end of file
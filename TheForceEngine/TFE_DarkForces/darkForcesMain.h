@@ -18,6 +18,7 @@ namespace TFE_DarkForces
 		void exitGame() override;
 		void loopGame() override;
 		bool serializeGameState(Stream* stream, const char* filename, bool writeState) override;
+		bool captureGameState(Stream* stream) override;
 		bool canSave() override;
 		bool isPaused() override;
 		void getLevelName(char* name) override;
@@ -195,6 +195,40 @@ namespace TFE_DarkForces
 		logic_spawnEnemy(args[1].c_str(), args[2].c_str());
 	}
 
+	void console_levelParseBenchmark(const ConsoleArgList& args)
+	{
+		const s32 iterations = args.size() > 1 ? max(1, atoi(args[1].c_str())) : 10;
+		f64 total = 0.0;
+		char msg[256];
+		for (s32 i = 0; i < s_maxLevelIndex; i++)
+		{
+			const f64 time = level_benchmarkGeometryParse(s_levelGamePaths[i], iterations);
+			if (time < 0.0)
+			{
+				sprintf(msg, "%s: failed to parse.", s_levelGamePaths[i]);
+			}
+			else
+			{
+				sprintf(msg, "%s: %0.3fms", s_levelGamePaths[i], time * 1000.0);
+				total += time;
+			}
+			TFE_Console::addToHistory(msg);
+		}
+		sprintf(msg, "Total: %0.3fms per pass, %d iterations.", total * 1000.0, iterations);
+		TFE_Console::addToHistory(msg);
+	}
+
+	void console_keywordBenchmark(const ConsoleArgList& args)
+	{
+		const s32 iterations = args.size() > 1 ? max(1, atoi(args[1].c_str())) : 10000;
+		f64 hashTime, linearTime;
+		benchmarkKeywordLookup(iterations, &hashTime, &linearTime);
+
+		char msg[256];
+		sprintf(msg, "Keyword lookup, %d iterations: hash %0.3fms, linear %0.3fms", iterations, hashTime * 1000.0, linearTime * 1000.0);
+		TFE_Console::addToHistory(msg);
+	}
+
 	void mission_createDisplay()
 	{
 		vfb_setResolution(320, 200);
@@ -354,6 +388,8 @@ namespace TFE_DarkForces
 			// TFE-specific
 			mission_addCheatCommands();
 			CCMD("spawnEnemy", console_spawnEnemy, 2, "spawnEnemy(waxName, enemyTypeName) - spawns an enemy 8 units away in the player direction. Example: spawnEnemy offcfin.wax i_officer");
+			CCMD("levelParseBenchmark", console_levelParseBenchmark, 0, "levelParseBenchmark(iterations) - times parsing the geometry of every level in the level list, 10 iterations by default.");
+			CCMD("keywordBenchmark", console_keywordBenchmark, 0, "keywordBenchmark(iterations) - times looking up every keyword with the hash table and the original linear search.");
 
 			// Make sure the loading screen is displayed for at least 1 second.
 			if (!s_loadingFromSave)
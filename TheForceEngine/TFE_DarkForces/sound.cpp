@@ -6,6 +6,7 @@
 #include <TFE_Settings/settings.h>
 #include <TFE_Game/igame.h>
 #include <TFE_Asset/vocAsset.h>
+#include <TFE_Asset/assetCache.h>
 #include <TFE_Audio/audioSystem.h>
 #include <TFE_Audio/midiPlayer.h>
 #include <TFE_Jedi/Math/core_math.h>
@@ -14,6 +15,7 @@
 #include <TFE_Jedi/Serialization/serialization.h>
 #include <TFE_DarkForces/time.h>
 #include <TFE_System/system.h>
+#include <unordered_map>
 
 namespace TFE_DarkForces
 {
@@ -51,6 +53,8 @@ namespace TFE_DarkForces
 	static const s32 s_tPan[32] = { 00,-06,-12,-18,-24,-30,-36,-42,-48,-42,-36,-30,-24,-18,-12,-06,00,06,12,18,24,30,36,42,48,42,36,30,24,18,12,06 };
 	
 	static SoundState s_state = {};
+	// Asset cache key of each loaded sound, so level sounds can be kept for the next level.
+	static std::unordered_map<GameSound*, std::string> s_soundKeys;
 	s32 s_lastMaintainVolume;
 
 	SoundEffectId soundInstance(SoundSourceId soundId, s32 instance);
@@ -59,6 +63,7 @@ namespace TFE_DarkForces
 	u8* sound_getResource(SoundEffectId id);
 	void sound_alwaysFree(GameSound* sound);
 	void sound_clearLevelSounds();
+	void sound_freeCached(void* data);
 
 	// Called at game startup and shutdown.
 	void sound_open(MemoryRegion* memRegion)
@@ -80,6 +85,7 @@ namespace TFE_DarkForces
 		allocator_free(s_state.gameSoundList);
 		ImTerminate();
 		s_state = {};
+		s_soundKeys.clear();
 	}
 
 	// Called at level startup and shutdown.
@@ -172,6 +178,14 @@ namespace TFE_DarkForces
 		GameSound* sound = (GameSound*)allocator_getIter(s_state.gameSoundList);
 		while (sound)
 		{
+			// Keep a copy of the sound data in the asset cache, the next level usually loads most of the same sounds.
+			std::unordered_map<GameSound*, std::string>::iterator iKey = s_soundKeys.find(sound);
+			if (sound->data && iKey != s_soundKeys.end())
+			{
+				u8* cached = (u8*)malloc(sound->size);
+				memcpy(cached, sound->data, sound->size);
+				TFE_AssetCache::add(iKey->second, cached, sound->size, sound_freeCached);
+			}
 			sound_alwaysFree(sound);
 			sound = (GameSound*)allocator_getNext(s_state.gameSoundList);
 		}
@@ -191,8 +205,30 @@ namespace TFE_DarkForces
 			sound = (GameSound*)allocator_getNext(s_state.gameSoundList);
 		}
 
+		FilePath path;
+		if (!getVocFilePath(fileName, &path))
+		{
+			return NULL_SOUND;
+		}
+		std::string key;
+		TFE_AssetCache::buildKey(TFE_AssetCache::ACACHE_SOUND, &path, key);
+
 		u32 size = 0;
-		u8* data = readVocFileData(fileName, &size);
+		u8* data = nullptr;
+		size_t cachedSize;
+		u8* cached = (u8*)TFE_AssetCache::take(key, &cachedSize);
+		if (cached)
+		{
+			size = (u32)cachedSize;
+			data = (u8*)game_alloc(size);
+			memcpy(data, cached, size);
+			free(cached);
+		}
+		else
+		{
+			data = readVocFileData(&path, &size);
+		}
+
 		if (data)
 		{
 			sound = (GameSound*)allocator_newItem(s_state.gameSoundList);
@@ -205,11 +241,17 @@ namespace TFE_DarkForces
 			sound->volume = 127;
 			sound->refCount = 1;
 			newId = soundInstance(sound->id, 0);
+			s_soundKeys[sound].swap(key);
 		}
 
 		return newId;
 	}
 
+	void sound_freeCached(void* data)
+	{
+		free(data);
+	}
+
 	void sound_free(SoundSourceId id)
 	{
 		if (id)
@@ -224,6 +266,7 @@ namespace TFE_DarkForces
 					game_free(sound->data);
 				}
 				sound->data = nullptr;
+				s_soundKeys.erase(sound);
 				allocator_deleteItem(s_state.gameSoundList, sound);
 			}
 		}
@@ -238,6 +281,7 @@ namespace TFE_DarkForces
 				game_free(sound->data);
 			}
 			sound->data = nullptr;
+			s_soundKeys.erase(sound);
 			allocator_deleteItem(s_state.gameSoundList, sound);
 		}
 	}
@@ -11,6 +11,7 @@
 #include <TFE_Jedi/Level/rwall.h>
 #include <TFE_Jedi/Collision/collision.h>
 #include <TFE_System/system.h>
+#include <TFE_System/parser.h>
 #include <TFE_FileSystem/paths.h>
 #include <TFE_FileSystem/filestream.h>
 #include <TFE_Jedi/Serialization/serialization.h>
@@ -200,7 +201,7 @@ namespace TFE_DarkForces
 				if (!line) { break; }
 
 				f32 x1, z1, y1, x2, z2, y2, r, lens;
-				if (sscanf(line, "camera %f %f %f %f %f %f %f %f", &x1, &z1, &y1, &x2, &z2, &y2, &r, &lens) == 8)
+				if (TFE_LineScanner::scan(line, "camera %f %f %f %f %f %f %f %f", &x1, &z1, &y1, &x2, &z2, &y2, &r, &lens) == 8)
 				{
 					y1 = -y1;
 					y2 = -y2;
@@ -257,7 +258,7 @@ namespace TFE_DarkForces
 
 				char name[32];
 				f32 f00, f01, f02, f03, f04, f05, f06, f07, f08, f09, f10, f11;
-				s32 count = sscanf(line, "transform %s %f %f %f %f %f %f %f %f %f %f %f %f", name, &f00, &f01, &f02, &f03, &f04, &f05, &f06, &f07, &f08, &f09, &f10, &f11);
+				s32 count = TFE_LineScanner::scan(line, "transform %s %f %f %f %f %f %f %f %f %f %f %f %f", name, &f00, &f01, &f02, &f03, &f04, &f05, &f06, &f07, &f08, &f09, &f10, &f11);
 				if (count == 13)
 				{
 					// Is this the correct transform?
@@ -0,0 +1,226 @@
+#include "bufferedstream.h"
+#include <cstdlib>
+#include <stdio.h>
+#include <stdarg.h>
+
+BufferedStream::BufferedStream(u32 bufferSize) : Stream()
+{
+	m_mode = MODE_INVALID;
+	m_bufferSize = bufferSize ? bufferSize : BSTREAM_DEFAULT_BUFFER_SIZE;
+	m_buffer = (u8*)malloc(m_bufferSize);
+	m_pos = m_buffer;
+	m_end = m_buffer;
+	m_bufferLoc = 0;
+	m_size = 0;
+}
+
+BufferedStream::~BufferedStream()
+{
+	close();
+	free(m_buffer);
+}
+
+bool BufferedStream::open(const char* filename, AccessMode mode)
+{
+	assert(mode == MODE_READ || mode == MODE_WRITE);
+	if (!m_buffer || (mode != MODE_READ && mode != MODE_WRITE)) { return false; }
+	if (!m_file.open(filename, mode)) { return false; }
+
+	m_mode = mode;
+	m_size = mode == MODE_READ ? m_file.getSize() : 0;
+	resetBuffer(0);
+	return true;
+}
+
+bool BufferedStream::open(const FilePath* filePath, AccessMode mode)
+{
+	assert(mode == MODE_READ || mode == MODE_WRITE);
+	if (!m_buffer || (mode != MODE_READ && mode != MODE_WRITE)) { return false; }
+	if (!m_file.open(filePath, mode)) { return false; }
+
+	m_mode = mode;
+	m_size = mode == MODE_READ ? m_file.getSize() : 0;
+	resetBuffer(0);
+	return true;
+}
+
+void BufferedStream::close()
+{
+	if (!m_file.isOpen()) { return; }
+
+	flush();
+	m_file.close();
+	m_mode = MODE_INVALID;
+	resetBuffer(0);
+}
+
+bool BufferedStream::isOpen() const
+{
+	return m_file.isOpen();
+}
+
+void BufferedStream::flush()
+{
+	if (m_mode != MODE_WRITE || m_pos == m_buffer) { return; }
+
+	const size_t size = size_t(m_pos - m_buffer);
+	m_file.writeBuffer(m_buffer, u32(size));
+	resetBuffer(m_bufferLoc + size);
+}
+
+bool BufferedStream::seek(s32 offset, Origin origin)
+{
+	if (!m_file.isOpen()) { return false; }
+
+	if (m_mode == MODE_READ && origin != ORIGIN_END)
+	{
+		const s64 loc = (origin == ORIGIN_START) ? s64(offset) : s64(getLoc()) + offset;
+		if (loc < 0 || loc > s64(m_size)) { return false; }
+
+		// Stay within the buffer if possible, so small skips do not touch the file.
+		const size_t bufferedEnd = m_bufferLoc + size_t(m_end - m_buffer);
+		if (size_t(loc) >= m_bufferLoc && size_t(loc) <= bufferedEnd)
+		{
+			m_pos = m_buffer + (size_t(loc) - m_bufferLoc);
+			return true;
+		}
+		if (!m_file.seek(s32(loc))) { return false; }
+		resetBuffer(size_t(loc));
+		return true;
+	}
+
+	// Otherwise write out anything buffered and let the file handle it.
+	flush();
+	if (origin == ORIGIN_CURRENT)
+	{
+		offset = s32(s64(getLoc()) + offset);
+		origin = ORIGIN_START;
+	}
+	if (!m_file.seek(offset, origin)) { return false; }
+	resetBuffer(m_file.getLoc());
+	return true;
+}
+
+size_t BufferedStream::getLoc()
+{
+	return m_bufferLoc + size_t(m_pos - m_buffer);
+}
+
+size_t BufferedStream::getSize()
+{
+	if (m_mode == MODE_READ) { return m_size; }
+	if (m_mode != MODE_WRITE) { return 0; }
+
+	// FileStream::getSize() moves the file position, so restore it afterwards.
+	flush();
+	const size_t size = m_file.getSize();
+	m_file.seek(s32(m_bufferLoc));
+	return size > m_bufferLoc ? size : m_bufferLoc;
+}
+
+void BufferedStream::read(std::string* ptr, u32 count)
+{
+	// Same layout as FileStream: the lengths of all of the strings followed by the string data.
+	std::vector<u32> lengths(count);
+	readBuffer(lengths.data(), sizeof(u32), count);
+	for (u32 s = 0; s < count; s++)
+	{
+		ptr[s].resize(lengths[s]);
+		if (lengths[s])
+		{
+			const u32 bytesRead = readBuffer(&ptr[s][0], lengths[s]);
+			ptr[s].resize(bytesRead);
+		}
+	}
+}
+
+void BufferedStream::write(const std::string* ptr, u32 count)
+{
+	for (u32 s = 0; s < count; s++)
+	{
+		const u32 length = u32(ptr[s].length());
+		writeBuffer(&length, sizeof(u32));
+	}
+	for (u32 s = 0; s < count; s++)
+	{
+		writeBuffer(ptr[s].data(), u32(ptr[s].length()));
+	}
+}
+
+void BufferedStream::writeString(const char* fmt, ...)
+{
+	char tmpStr[4096];
+	va_list arg;
+	va_start(arg, fmt);
+	const s32 len = vsnprintf(tmpStr, sizeof(tmpStr), fmt, arg);
+	va_end(arg);
+
+	if (len > 0)
+	{
+		writeBuffer(tmpStr, u32(len < s32(sizeof(tmpStr)) ? len : sizeof(tmpStr) - 1));
+	}
+}
+
+////////////////////////////////////////////
+// Internal
+////////////////////////////////////////////
+void BufferedStream::resetBuffer(size_t fileLoc)
+{
+	m_bufferLoc = fileLoc;
+	m_pos = m_buffer;
+	m_end = (m_mode == MODE_WRITE) ? m_buffer + m_bufferSize : m_buffer;
+}
+
+bool BufferedStream::fillBuffer()
+{
+	resetBuffer(m_bufferLoc + size_t(m_end - m_buffer));
+	// Read single bytes, so a partial block at the end of the file is still counted.
+	const u32 bytesRead = m_file.readBuffer(m_buffer, 1, m_bufferSize);
+	m_end = m_buffer + bytesRead;
+	return bytesRead > 0;
+}
+
+u32 BufferedStream::readSlow(u8* ptr, size_t size)
+{
+	if (m_mode != MODE_READ) { return 0; }
+
+	// Use what is left in the buffer first.
+	size_t bytesRead = size_t(m_end - m_pos);
+	memcpy(ptr, m_pos, bytesRead);
+	m_pos = m_end;
+
+	const size_t remaining = size - bytesRead;
+	if (remaining >= m_bufferSize)
+	{
+		// Large reads go straight to the destination.
+		const size_t fileLoc = m_bufferLoc + size_t(m_end - m_buffer);
+		const u32 directRead = m_file.readBuffer(ptr + bytesRead, 1, u32(remaining));
+		resetBuffer(fileLoc + directRead);
+		return u32(bytesRead + directRead);
+	}
+
+	if (remaining && fillBuffer())
+	{
+		const size_t copySize = remaining < size_t(m_end - m_pos) ? remaining : size_t(m_end - m_pos);
+		memcpy(ptr + bytesRead, m_pos, copySize);
+		m_pos += copySize;
+		bytesRead += copySize;
+	}
+	return u32(bytesRead);
+}
+
+void BufferedStream::writeSlow(const u8* ptr, size_t size)
+{
+	if (m_mode != MODE_WRITE) { return; }
+
+	flush();
+	if (size >= m_bufferSize)
+	{
+		// Large writes go straight to the file.
+		m_file.writeBuffer(ptr, u32(size));
+		resetBuffer(m_bufferLoc + size);
+		return;
+	}
+	memcpy(m_pos, ptr, size);
+	m_pos += size;
+}
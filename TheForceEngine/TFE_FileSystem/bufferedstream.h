@@ -0,0 +1,120 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// A FileStream with a block buffer in front of it.
+// Serialization reads and writes one small field at a time, which
+// costs a stdio call per field with a plain FileStream. This stream
+// copies fields into a large buffer instead and only goes to the file
+// when the buffer is empty (reading) or full (writing).
+// The stream is opened either for reading or for writing.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_FileSystem/filestream.h>
+#include <cstring>
+
+class BufferedStream : public Stream
+{
+public:
+	enum BufferedStreamConst : u32
+	{
+		BSTREAM_DEFAULT_BUFFER_SIZE = 64 * 1024,
+	};
+
+	BufferedStream(u32 bufferSize = BSTREAM_DEFAULT_BUFFER_SIZE);
+	~BufferedStream();
+
+	bool open(const char* filename, AccessMode mode);
+	bool open(const FilePath* filePath, AccessMode mode);
+	void close();
+	bool isOpen() const;
+	// Write any buffered data to the file.
+	void flush();
+
+	//derived functions.
+	bool seek(s32 offset, Origin origin=ORIGIN_START) override;
+	size_t getLoc() override;
+	size_t getSize() override;
+
+	void read(s8*  ptr, u32 count=1) override { readType(ptr, count); }
+	void read(u8*  ptr, u32 count=1) override { readType(ptr, count); }
+	void read(s16* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(u16* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(s32* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(u32* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(s64* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(u64* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(f32* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(f64* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(std::string* ptr, u32 count=1) override;
+
+	u32 readBuffer(void* ptr, u32 size, u32 count=1) override
+	{
+		assert(m_mode == MODE_READ);
+		const size_t bytes = size_t(size) * count;
+		if (bytes <= size_t(m_end - m_pos))
+		{
+			memcpy(ptr, m_pos, bytes);
+			m_pos += bytes;
+			return u32(bytes);
+		}
+		return readSlow((u8*)ptr, bytes);
+	}
+
+	void write(const s8*  ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const u8*  ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const s16* ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const u16* ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const s32* ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const u32* ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const s64* ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const u64* ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const f32* ptr, u32 count=1) override { writeType(ptr, count); }
+	void write(const f64* ptr, u32 count=1) override { writeType(ptr, count); }
+	void write(const std::string* ptr, u32 count=1) override;
+
+	void writeBuffer(const void* ptr, u32 size, u32 count=1) override
+	{
+		assert(m_mode == MODE_WRITE);
+		const size_t bytes = size_t(size) * count;
+		if (bytes <= size_t(m_end - m_pos))
+		{
+			memcpy(m_pos, ptr, bytes);
+			m_pos += bytes;
+			return;
+		}
+		writeSlow((const u8*)ptr, bytes);
+	}
+
+	void writeString(const char* fmt, ...) override;
+
+private:
+	// Fixed size types are copied directly, without going through the virtual functions.
+	template <typename T>
+	void readType(T* ptr, u32 count)
+	{
+		BufferedStream::readBuffer(ptr, sizeof(T), count);
+	}
+
+	template <typename T>
+	void writeType(const T* ptr, u32 count)
+	{
+		BufferedStream::writeBuffer(ptr, sizeof(T), count);
+	}
+
+	u32  readSlow(u8* ptr, size_t size);
+	void writeSlow(const u8* ptr, size_t size);
+	bool fillBuffer();
+	void resetBuffer(size_t fileLoc);
+
+private:
+	FileStream m_file;
+	AccessMode m_mode;
+
+	u8* m_buffer;
+	u32 m_bufferSize;
+	// Reading: [m_pos, m_end) is the data that has not been read yet.
+	// Writing: [m_buffer, m_pos) is the data that has not been written yet and m_end is the end of the buffer.
+	u8* m_pos;
+	u8* m_end;
+	// The location in the file of the start of the buffer.
+	size_t m_bufferLoc;
+	size_t m_size;
+};
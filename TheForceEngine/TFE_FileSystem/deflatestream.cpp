@@ -0,0 +1,265 @@
+#include "deflatestream.h"
+#include <cstdlib>
+#include <stdio.h>
+#include <stdarg.h>
+
+// The implementation is compiled with the zip library.
+#define MINIZ_HEADER_FILE_ONLY
+#define MINIZ_NO_ZLIB_COMPATIBLE_NAMES
+#include <TFE_Archive/zip/miniz.h>
+
+DeflateStream::DeflateStream() : Stream()
+{
+	m_stream = nullptr;
+	m_zstream = nullptr;
+	m_mode = MODE_INVALID;
+	m_error = false;
+	m_streamEnd = false;
+
+	m_data = (u8*)malloc(DSTREAM_BUFFER_SIZE);
+	m_compressed = (u8*)malloc(DSTREAM_BUFFER_SIZE);
+	m_pos = m_data;
+	m_end = m_data;
+	m_dataLoc = 0;
+}
+
+DeflateStream::~DeflateStream()
+{
+	close();
+	free(m_data);
+	free(m_compressed);
+}
+
+bool DeflateStream::open(Stream* stream, AccessMode mode, u32 level)
+{
+	assert(stream && (mode == MODE_READ || mode == MODE_WRITE));
+	if (!stream || !m_data || !m_compressed || (mode != MODE_READ && mode != MODE_WRITE)) { return false; }
+	close();
+
+	m_zstream = new mz_stream();
+	const s32 result = (mode == MODE_WRITE) ? mz_deflateInit(m_zstream, s32(level)) : mz_inflateInit(m_zstream);
+	if (result != MZ_OK)
+	{
+		delete m_zstream;
+		m_zstream = nullptr;
+		return false;
+	}
+
+	m_stream = stream;
+	m_mode = mode;
+	m_error = false;
+	m_streamEnd = false;
+	m_dataLoc = 0;
+	m_pos = m_data;
+	m_end = (mode == MODE_WRITE) ? m_data + DSTREAM_BUFFER_SIZE : m_data;
+	return true;
+}
+
+bool DeflateStream::close()
+{
+	if (!m_zstream) { return true; }
+
+	if (m_mode == MODE_WRITE)
+	{
+		if (!m_error) { deflateBlock(true); }
+		mz_deflateEnd(m_zstream);
+	}
+	else
+	{
+		mz_inflateEnd(m_zstream);
+	}
+	delete m_zstream;
+	m_zstream = nullptr;
+
+	m_stream = nullptr;
+	m_mode = MODE_INVALID;
+	m_pos = m_data;
+	m_end = m_data;
+	return !m_error;
+}
+
+bool DeflateStream::isOpen() const
+{
+	return m_zstream != nullptr;
+}
+
+bool DeflateStream::seek(s32 offset, Origin origin)
+{
+	if (!m_zstream || origin == ORIGIN_END) { return false; }
+
+	const s64 loc = (origin == ORIGIN_START) ? s64(offset) : s64(getLoc()) + offset;
+	if (loc == s64(getLoc())) { return true; }
+	if (m_mode != MODE_READ || loc < s64(getLoc())) { return false; }
+
+	size_t skip = size_t(loc - s64(getLoc()));
+	while (skip)
+	{
+		if (m_pos == m_end && !inflateBlock()) { return false; }
+
+		const size_t available = size_t(m_end - m_pos);
+		const size_t step = skip < available ? skip : available;
+		m_pos += step;
+		skip -= step;
+	}
+	return true;
+}
+
+size_t DeflateStream::getLoc()
+{
+	return m_dataLoc + size_t(m_pos - m_data);
+}
+
+size_t DeflateStream::getSize()
+{
+	if (m_mode == MODE_READ && m_streamEnd)
+	{
+		return m_dataLoc + size_t(m_end - m_data);
+	}
+	return getLoc();
+}
+
+void DeflateStream::read(std::string* ptr, u32 count)
+{
+	// Same layout as the other streams: the lengths of all of the strings followed by the string data.
+	std::vector<u32> lengths(count);
+	readBuffer(lengths.data(), sizeof(u32), count);
+	for (u32 s = 0; s < count; s++)
+	{
+		ptr[s].resize(lengths[s]);
+		if (lengths[s])
+		{
+			const u32 bytesRead = readBuffer(&ptr[s][0], lengths[s]);
+			ptr[s].resize(bytesRead);
+		}
+	}
+}
+
+void DeflateStream::write(const std::string* ptr, u32 count)
+{
+	for (u32 s = 0; s < count; s++)
+	{
+		const u32 length = u32(ptr[s].length());
+		writeBuffer(&length, sizeof(u32));
+	}
+	for (u32 s = 0; s < count; s++)
+	{
+		writeBuffer(ptr[s].data(), u32(ptr[s].length()));
+	}
+}
+
+void DeflateStream::writeString(const char* fmt, ...)
+{
+	char tmpStr[4096];
+	va_list arg;
+	va_start(arg, fmt);
+	const s32 len = vsnprintf(tmpStr, sizeof(tmpStr), fmt, arg);
+	va_end(arg);
+
+	if (len > 0)
+	{
+		writeBuffer(tmpStr, u32(len < s32(sizeof(tmpStr)) ? len : sizeof(tmpStr) - 1));
+	}
+}
+
+////////////////////////////////////////////
+// Internal
+////////////////////////////////////////////
+bool DeflateStream::inflateBlock()
+{
+	if (m_mode != MODE_READ || m_streamEnd || m_error) { return false; }
+
+	m_dataLoc += size_t(m_end - m_data);
+	m_zstream->next_out = m_data;
+	m_zstream->avail_out = DSTREAM_BUFFER_SIZE;
+	while (m_zstream->avail_out)
+	{
+		if (!m_zstream->avail_in)
+		{
+			m_zstream->next_in = m_compressed;
+			m_zstream->avail_in = m_stream->readBuffer(m_compressed, 1, DSTREAM_BUFFER_SIZE);
+		}
+
+		// This also fails if the source ends before the compressed data does.
+		const s32 result = mz_inflate(m_zstream, MZ_NO_FLUSH);
+		if (result == MZ_STREAM_END)
+		{
+			m_streamEnd = true;
+			break;
+		}
+		else if (result != MZ_OK)
+		{
+			m_error = true;
+			break;
+		}
+	}
+
+	m_pos = m_data;
+	m_end = m_data + (DSTREAM_BUFFER_SIZE - m_zstream->avail_out);
+	return m_end > m_pos;
+}
+
+bool DeflateStream::deflateBlock(bool finish)
+{
+	m_zstream->next_in = m_data;
+	m_zstream->avail_in = u32(m_pos - m_data);
+
+	// Keep going until all of the input has been consumed and, when finishing, all of the output written.
+	s32 result;
+	do
+	{
+		m_zstream->next_out = m_compressed;
+		m_zstream->avail_out = DSTREAM_BUFFER_SIZE;
+		result = mz_deflate(m_zstream, finish ? MZ_FINISH : MZ_NO_FLUSH);
+		// MZ_BUF_ERROR only means that no progress could be made without more input.
+		if (result != MZ_OK && result != MZ_STREAM_END && (finish || result != MZ_BUF_ERROR))
+		{
+			m_error = true;
+			return false;
+		}
+
+		const u32 size = DSTREAM_BUFFER_SIZE - m_zstream->avail_out;
+		if (size)
+		{
+			m_stream->writeBuffer(m_compressed, size);
+		}
+	} while (finish ? result != MZ_STREAM_END : (m_zstream->avail_in || !m_zstream->avail_out));
+
+	m_dataLoc += size_t(m_pos - m_data);
+	m_pos = m_data;
+	return true;
+}
+
+u32 DeflateStream::readSlow(u8* ptr, size_t size)
+{
+	if (m_mode != MODE_READ) { return 0; }
+
+	size_t bytesRead = 0;
+	while (bytesRead < size)
+	{
+		if (m_pos == m_end && !inflateBlock()) { break; }
+
+		const size_t available = size_t(m_end - m_pos);
+		const size_t copySize = (size - bytesRead) < available ? (size - bytesRead) : available;
+		memcpy(ptr + bytesRead, m_pos, copySize);
+		m_pos += copySize;
+		bytesRead += copySize;
+	}
+	return u32(bytesRead);
+}
+
+void DeflateStream::writeSlow(const u8* ptr, size_t size)
+{
+	if (m_mode != MODE_WRITE || m_error) { return; }
+
+	while (size)
+	{
+		const size_t space = size_t(m_end - m_pos);
+		const size_t copySize = size < space ? size : space;
+		memcpy(m_pos, ptr, copySize);
+		m_pos += copySize;
+		ptr += copySize;
+		size -= copySize;
+
+		if (m_pos == m_end && !deflateBlock(false)) { return; }
+	}
+}
@@ -0,0 +1,133 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Deflate (zlib) compression on top of another stream, using miniz.
+// In write mode everything written is compressed into the target
+// stream, close() must be called to finish the compressed data.
+// In read mode the data is decompressed from the source stream as it
+// is read. The stream only moves forward, so seeking backwards is not
+// supported.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_FileSystem/stream.h>
+#include <cassert>
+#include <cstring>
+
+struct mz_stream_s;
+
+class DeflateStream : public Stream
+{
+public:
+	enum DeflateStreamConst : u32
+	{
+		DSTREAM_BUFFER_SIZE = 64 * 1024,
+		// Compression levels, from 1 (fastest) to 9 (smallest).
+		DSTREAM_LEVEL_FASTEST = 1,
+		DSTREAM_LEVEL_DEFAULT = 6,
+		DSTREAM_LEVEL_BEST    = 9,
+	};
+
+	DeflateStream();
+	~DeflateStream();
+
+	// The underlying stream must stay open until this stream is closed.
+	bool open(Stream* stream, AccessMode mode, u32 level = DSTREAM_LEVEL_DEFAULT);
+	// Returns false if the compressed data could not be written or read.
+	bool close();
+	bool isOpen() const;
+
+	//derived functions.
+	// Only forward seeks are supported when reading, the data in between is decompressed and discarded.
+	bool seek(s32 offset, Origin origin=ORIGIN_START) override;
+	// Location and size of the uncompressed data. The size is only known once everything has been read.
+	size_t getLoc() override;
+	size_t getSize() override;
+
+	void read(s8*  ptr, u32 count=1) override { readType(ptr, count); }
+	void read(u8*  ptr, u32 count=1) override { readType(ptr, count); }
+	void read(s16* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(u16* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(s32* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(u32* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(s64* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(u64* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(f32* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(f64* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(std::string* ptr, u32 count=1) override;
+
+	u32 readBuffer(void* ptr, u32 size, u32 count=1) override
+	{
+		assert(m_mode == MODE_READ);
+		const size_t bytes = size_t(size) * count;
+		if (bytes <= size_t(m_end - m_pos))
+		{
+			memcpy(ptr, m_pos, bytes);
+			m_pos += bytes;
+			return u32(bytes);
+		}
+		return readSlow((u8*)ptr, bytes);
+	}
+
+	void write(const s8*  ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const u8*  ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const s16* ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const u16* ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const s32* ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const u32* ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const s64* ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const u64* ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const f32* ptr, u32 count=1) override { writeType(ptr, count); }
+	void write(const f64* ptr, u32 count=1) override { writeType(ptr, count); }
+	void write(const std::string* ptr, u32 count=1) override;
+
+	void writeBuffer(const void* ptr, u32 size, u32 count=1) override
+	{
+		assert(m_mode == MODE_WRITE);
+		const size_t bytes = size_t(size) * count;
+		if (bytes <= size_t(m_end - m_pos))
+		{
+			memcpy(m_pos, ptr, bytes);
+			m_pos += bytes;
+			return;
+		}
+		writeSlow((const u8*)ptr, bytes);
+	}
+
+	void writeString(const char* fmt, ...) override;
+
+private:
+	template <typename T>
+	void readType(T* ptr, u32 count)
+	{
+		DeflateStream::readBuffer(ptr, sizeof(T), count);
+	}
+
+	template <typename T>
+	void writeType(const T* ptr, u32 count)
+	{
+		DeflateStream::writeBuffer(ptr, sizeof(T), count);
+	}
+
+	u32  readSlow(u8* ptr, size_t size);
+	void writeSlow(const u8* ptr, size_t size);
+	// Decompress the next block into the uncompressed buffer.
+	bool inflateBlock();
+	// Compress the uncompressed buffer, flushing all of the compressed data if 'finish' is true.
+	bool deflateBlock(bool finish);
+
+private:
+	Stream* m_stream;
+	mz_stream_s* m_zstream;
+	AccessMode m_mode;
+	bool m_error;
+	bool m_streamEnd;
+
+	// Uncompressed data.
+	// Reading: [m_pos, m_end) is the data that has not been read yet.
+	// Writing: [m_data, m_pos) is the data that has not been compressed yet and m_end is the end of the buffer.
+	u8* m_data;
+	u8* m_pos;
+	u8* m_end;
+	// Compressed data.
+	u8* m_compressed;
+	// Uncompressed location of the start of the buffer.
+	size_t m_dataLoc;
+};
@@ -22,6 +22,8 @@ FileStream::FileStream() : Stream()
 {
 	m_file = nullptr;
 	m_archive = nullptr;
+	m_archiveFile = nullptr;
+	m_archiveLoc = 0;
 	m_mode = MODE_INVALID;
 }
 
@@ -81,8 +83,13 @@ bool FileStream::open(const FilePath *filePath, AccessMode mode)
 		m_mode = mode;
 		m_file = nullptr;
 		m_archive = filePath->archive;
-
-		return filePath->archive->openFile(filePath->index);
+		m_archiveFile = m_archive->openHandle(filePath->index);
+		m_archiveLoc = 0;
+		if (!m_archiveFile) {
+			m_archive = nullptr;
+			return false;
+		}
+		return true;
 	}
 	return open(filePath->path, mode);
 }
@@ -93,7 +100,8 @@ void FileStream::close()
 		fclose(m_file);
 		m_file = nullptr;
 	} else if (m_archive) {
-		m_archive->closeFile();
+		m_archive->closeHandle(m_archiveFile);
+		m_archiveFile = nullptr;
 		m_archive = nullptr;
 	}
 	m_mode = MODE_INVALID;
@@ -160,6 +168,28 @@ u32 FileStream::readContents(const FilePath *filePath, void *output, size_t size
 	return 0;
 }
 
+const u8 *FileStream::readContentsView(const FilePath *filePath, std::vector<u8>& buffer, size_t *size)
+{
+	if (filePath->archive && filePath->index != INVALID_FILE) {
+		const u8 *data = filePath->archive->getFileData(filePath->index);
+		if (data) {
+			*size = filePath->archive->getFileLength(filePath->index);
+			return data;
+		}
+	}
+
+	FileStream file;
+	if (!file.open(filePath, MODE_READ)) {
+		*size = 0;
+		return nullptr;
+	}
+	*size = file.getSize();
+	buffer.resize(*size);
+	file.readBuffer(buffer.data(), (u32)*size);
+	file.close();
+	return buffer.data();
+}
+
 //derived from Stream
 bool FileStream::seek(s32 offset, Origin origin/*=ORIGIN_START*/)
 {
@@ -167,7 +197,12 @@ bool FileStream::seek(s32 offset, Origin origin/*=ORIGIN_START*/)
 	if (m_file) {
 		return fseek(m_file, offset, forigin[origin]) == 0;
 	} else if (m_archive) {
-		return m_archive->seekFile(offset, forigin[origin]);
+		// Matches Archive::seekFile(), ORIGIN_END counts back from the end of the file.
+		const s64 size = (s64)m_archive->getLength(m_archiveFile);
+		const s64 loc = (origin == ORIGIN_START) ? offset : (origin == ORIGIN_END) ? size - offset : s64(m_archiveLoc) + offset;
+		if (loc < 0 || loc > size) { return false; }
+		m_archiveLoc = size_t(loc);
+		return true;
 	}
 	return false;
 }
@@ -180,7 +215,7 @@ size_t FileStream::getLoc(void)
 	if (m_file)
 		return ftell(m_file);
 
-	return m_archive->getLocInFile();
+	return m_archiveLoc;
 }
 
 size_t FileStream::getSize(void)
@@ -194,7 +229,7 @@ size_t FileStream::getSize(void)
 		filesize = getLoc();
 		seek(0, FileStream::ORIGIN_START);
 	} else {
-		filesize = m_archive->getFileLength();
+		filesize = m_archive->getLength(m_archiveFile);
 	}
 
 	return filesize;
@@ -212,7 +247,9 @@ u32 FileStream::readBuffer(void *ptr, u32 size, u32 count)
 		// fread() returns the number of *elements* read, but we want the number of bytes read.
 		return (u32)fread(ptr, size, count, m_file) * size;
 	} else if (m_archive) {
-		return (u32)m_archive->readFile(ptr, size * count);
+		const size_t bytesRead = m_archive->read(m_archiveFile, ptr, m_archiveLoc, size_t(size) * count);
+		m_archiveLoc += bytesRead;
+		return (u32)bytesRead;
 	}
 	return 0;
 }
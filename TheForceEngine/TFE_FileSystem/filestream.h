@@ -2,12 +2,14 @@
 #include <TFE_FileSystem/stream.h>
 #include <TFE_FileSystem/paths.h>
 #include <cassert>
+#include <vector>
 
 ////////////////////////////////////////////////////
 // TODO: FileStream directly accesses arhive data.
 ////////////////////////////////////////////////////
 
 class Archive;
+struct ArchiveFile;
 
 class FileStream : public Stream
 {
@@ -24,6 +26,9 @@ public:
 	static u32 readContents(const char* filePath, void* output, size_t size);
 	static u32 readContents(const FilePath* filePath, void** output);
 	static u32 readContents(const FilePath* filePath, void* output, size_t size);
+	// Returns a read-only view of the whole file, pointing directly into the memory-mapped archive when possible.
+	// Otherwise the file is read into 'buffer'. The view is valid until the archive is closed or 'buffer' is changed.
+	static const u8* readContentsView(const FilePath* filePath, std::vector<u8>& buffer, size_t* size);
 	
 	//derived functions.
 	bool seek(s32 offset, Origin origin=ORIGIN_START) override;
@@ -83,5 +88,8 @@ private:
 private:
 	FILE*    m_file;
 	Archive* m_archive;
+	// Files within archives are read through their own handle, so several streams can read from the same archive at once.
+	ArchiveFile* m_archiveFile;
+	size_t m_archiveLoc;
 	AccessMode m_mode;
 };
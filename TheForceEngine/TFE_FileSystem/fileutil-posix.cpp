@@ -56,6 +56,31 @@ namespace FileUtil
 		closedir(d);
 	}
 
+	void readDirectoryFiles(const char *dir, FileList& fileList)
+	{
+		char buf[PATH_MAX];
+		struct dirent *de;
+		struct stat st;
+		int ret;
+		DIR *d;
+
+		d = opendir(dir);
+		if (!d) {
+			TFE_System::logWrite(LOG_ERROR, "readDirectoryFiles", "opendir(%s) failed with %d\n", dir, errno);
+			return;
+		}
+
+		while (NULL != (de = readdir(d))) {
+			memset(buf, 0, PATH_MAX);
+			snprintf(buf, PATH_MAX - 1, "%s%s", dir, de->d_name);
+			ret = stat(buf, &st);
+			if (ret || !S_ISREG(st.st_mode))
+				continue;
+			fileList.push_back(string(de->d_name));
+		}
+		closedir(d);
+	}
+
 	void readSubdirectories(const char *dir, FileList& dirList)
 	{
 		char *dn, fp[PATH_MAX];
@@ -223,6 +248,16 @@ namespace FileUtil
 		}
 	}
 
+	bool replaceFile(const char *src, const char *dst)
+	{
+		// rename() atomically replaces an existing file.
+		int ret = rename(src, dst);
+		if (ret) {
+			TFE_System::logWrite(LOG_WARNING, "replaceFile", "rename(%s, %s) failed with %d\n", src, dst, errno);
+		}
+		return ret == 0;
+	}
+
 	bool directoryExits(const char *path, char *outPath)
 	{
 		char *ret;
@@ -354,6 +389,15 @@ namespace FileUtil
 		return mtim;
 	}
 
+	u64 getFileSize(const char *path)
+	{
+		struct stat st;
+		if (stat(path, &st)) {
+			return 0;
+		}
+		return (u64)st.st_size;
+	}
+
 	void fixupPath(char *path)
 	{
 		char *c = path;
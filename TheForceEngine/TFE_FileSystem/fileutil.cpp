@@ -30,6 +30,24 @@ namespace FileUtil
 		}
 	}
 
+	void readDirectoryFiles(const char* dir, FileList& fileList)
+	{
+		char searchStr[TFE_MAX_PATH];
+		_finddata_t fileInfo;
+
+		sprintf(searchStr, "%s*", dir);
+		intptr_t hFile = _findfirst(searchStr, &fileInfo);
+		if (hFile != -1)
+		{
+			do
+			{
+				if (fileInfo.attrib & _A_SUBDIR) { continue; }
+				fileList.push_back( string(fileInfo.name) );
+			} while ( _findnext(hFile, &fileInfo) == 0 );
+			_findclose(hFile);
+		}
+	}
+
 	void readSubdirectories(const char* dir, FileList& dirList)
 	{
 		#ifdef _WIN32
@@ -221,6 +239,11 @@ namespace FileUtil
 		DeleteFile(srcFile);
 	}
 
+	bool replaceFile(const char* srcFile, const char* dstFile)
+	{
+		return MoveFileExA(srcFile, dstFile, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE;
+	}
+
 	bool directoryExits(const char* path, char* outPath)
 	{
 		DWORD attr = GetFileAttributesA(path);
@@ -261,6 +284,16 @@ namespace FileUtil
 		return modTime;
 	}
 
+	u64 getFileSize(const char* path)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA attributes;
+		if (!GetFileAttributesExA(path, GetFileExInfoStandard, &attributes))
+		{
+			return 0;
+		}
+		return u64(attributes.nFileSizeHigh) << 32ULL | u64(attributes.nFileSizeLow);
+	}
+
 	void fixupPath(char* path)
 	{
 		const size_t len = strlen(path);
@@ -1,99 +1,175 @@
 #include "filewriterAsync.h"
+#include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_System/profiler.h>
 #include <assert.h>
 #include <stdio.h>
-#include <stdarg.h>
-#include <vector>
-
-#ifdef _WIN32
-#define WIN32_LEAN_AND_MEAN 1
-#include <Windows.h>
-#endif
+#include <cstring>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 namespace FileWriterAsync
 {
-#ifdef _WIN32
-	#define MAX_REQUEST_COUNT 32
-
 	struct WriteRequest
 	{
+		char path[TFE_MAX_PATH];
 		std::vector<u8> buffer;
-		OVERLAPPED file;
+		FileBuildCallback build;
+		void* buildData;
 
 		FileWriteCompletionCallback callback;
 		void* userData;
 	};
-	WriteRequest s_requests[MAX_REQUEST_COUNT];
-	s32 s_freeRequests[MAX_REQUEST_COUNT];
-	s32 s_processRequest[MAX_REQUEST_COUNT];
 
-	std::atomic<s32> s_requestCount = 0;
-	std::atomic<s32> s_freeRequestCount = 0;
-	std::atomic<s32> s_processRequestCount = 0;
+	// A single writer thread handles every request in order. It is separate from the job system
+	// so slow disks or large files never hold up the workers used during the frame.
+	static std::thread s_writer;
+	static std::deque<WriteRequest*> s_requests;
+	static std::mutex s_requestLock;
+	static std::condition_variable s_requestReady;
+	static std::condition_variable s_requestsDone;
+	// Requests queued or being written.
+	static s32 s_pendingWrites = 0;
+	static bool s_exit = false;
 
-	void CALLBACK fileWrittenCallback(DWORD dwErrorCode, DWORD dwBytesTransferred, LPOVERLAPPED lpOverlapped)
+	static u32 writeRequest(const WriteRequest* request)
 	{
-		// Note that this won't be called unless the calling thread is waiting in an "alertable" state.
-		const size_t id = (size_t)lpOverlapped->hEvent;
-		WriteRequest& request = s_requests[id];
+		char tempPath[TFE_MAX_PATH];
+		snprintf(tempPath, TFE_MAX_PATH, "%s.tmp", request->path);
 
-		if (dwErrorCode == 0 && request.callback)	// Success
+		FILE* file = fopen(tempPath, "wb");
+		if (!file)
 		{
-			request.callback(size_t(dwBytesTransferred), request.userData, u32(dwErrorCode));
+			TFE_System::logWrite(LOG_ERROR, "AsyncFileWrite", "Cannot create file handle for: %s", tempPath);
+			return AFW_OPEN_FAILED;
 		}
-		else if (request.callback)  // Failure
+		const size_t size = request->buffer.size();
+		const bool written = fwrite(request->buffer.data(), 1, size, file) == size;
+		const bool closed = fclose(file) == 0;
+		if (!written || !closed)
 		{
-			request.callback(0, request.userData, u32(dwErrorCode));
+			TFE_System::logWrite(LOG_ERROR, "AsyncFileWrite", "Cannot write file: %s", request->path);
+			FileUtil::deleteFile(tempPath);
+			return AFW_WRITE_FAILED;
 		}
 
-		request.buffer.clear();
-		s_freeRequests[s_freeRequestCount++] = id;
+		// Replace the previous file only once the new one is complete.
+		if (!FileUtil::replaceFile(tempPath, request->path))
+		{
+			TFE_System::logWrite(LOG_ERROR, "AsyncFileWrite", "Cannot replace file: %s", request->path);
+			FileUtil::deleteFile(tempPath);
+			return AFW_WRITE_FAILED;
+		}
+		return AFW_SUCCESS;
 	}
 
-	bool writeFileToDisk(const char* path, u8* data, size_t dataSize, FileWriteCompletionCallback completionCallback, void* userData)
+	static void writerLoop()
 	{
-		size_t index = 0;
-		if (s_freeRequestCount)
-		{
-			index = s_freeRequests[s_freeRequestCount - 1];
-			s_freeRequestCount--;
-		}
-		else if (s_requestCount < MAX_REQUEST_COUNT)
+		TFE_Profiler::setThreadName("File Writer");
+
+		std::unique_lock<std::mutex> lock(s_requestLock);
+		while (1)
 		{
-			index = s_requestCount;
-			s_requestCount++;
+			s_requestReady.wait(lock, [] { return s_exit || !s_requests.empty(); });
+			// Finish the remaining writes before exiting.
+			if (s_requests.empty()) { break; }
+
+			WriteRequest* request = s_requests.front();
+			s_requests.pop_front();
+			lock.unlock();
+
+			if (request->build)
+			{
+				request->build(request->buffer, request->buildData);
+			}
+			const u32 errorCode = writeRequest(request);
+			if (request->callback)
+			{
+				request->callback(errorCode == AFW_SUCCESS ? request->buffer.size() : 0, request->userData, errorCode);
+			}
+			delete request;
+
+			lock.lock();
+			s_pendingWrites--;
+			if (!s_pendingWrites) { s_requestsDone.notify_all(); }
 		}
-		else
+	}
+
+	static bool addRequest(WriteRequest* request)
+	{
 		{
-			return false;
+			std::lock_guard<std::mutex> lock(s_requestLock);
+			if (!s_writer.joinable())
+			{
+				s_exit = false;
+				s_writer = std::thread(writerLoop);
+			}
+			s_requests.push_back(request);
+			s_pendingWrites++;
 		}
+		s_requestReady.notify_one();
+		return true;
+	}
 
-		WriteRequest* request = &s_requests[index];
-		request->buffer.resize(dataSize);
-		memcpy(request->buffer.data(), data, dataSize);
+	bool writeFileToDisk(const char* path, std::vector<u8>&& data, FileWriteCompletionCallback completionCallback, void* userData)
+	{
+		if (!path || strlen(path) + 5 > TFE_MAX_PATH) { return false; }
 
+		WriteRequest* request = new WriteRequest();
+		strcpy(request->path, path);
+		request->buffer = std::move(data);
+		request->build = nullptr;
+		request->buildData = nullptr;
 		request->callback = completionCallback;
 		request->userData = userData;
+		return addRequest(request);
+	}
 
-		HANDLE hFile = CreateFile(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_FLAG_OVERLAPPED, NULL);
-		if (hFile == INVALID_HANDLE_VALUE)
-		{
-			TFE_System::logWrite(LOG_ERROR, "AsyncFileWrite", "Cannot create file handle for: %s", path);
-			return false;
-		}
+	bool writeFileToDisk(const char* path, u8* data, size_t dataSize, FileWriteCompletionCallback completionCallback, void* userData)
+	{
+		std::vector<u8> buffer(data, data + dataSize);
+		return writeFileToDisk(path, std::move(buffer), completionCallback, userData);
+	}
+
+	bool writeFileToDisk(const char* path, FileBuildCallback build, void* buildData, FileWriteCompletionCallback completionCallback, void* userData)
+	{
+		if (!path || strlen(path) + 5 > TFE_MAX_PATH) { return false; }
 
-		memset(&request->file, 0, sizeof(OVERLAPPED));
-		request->file.Offset = 0;
-		request->file.OffsetHigh = 0;
-		request->file.hEvent = HANDLE(index);
+		WriteRequest* request = new WriteRequest();
+		strcpy(request->path, path);
+		request->build = build;
+		request->buildData = buildData;
+		request->callback = completionCallback;
+		request->userData = userData;
+		return addRequest(request);
+	}
 
-		if (!WriteFileEx(hFile, request->buffer.data(), DWORD(dataSize), &request->file, fileWrittenCallback))
+	void waitForWrites()
+	{
+		std::unique_lock<std::mutex> lock(s_requestLock);
+		s_requestsDone.wait(lock, [] { return s_pendingWrites <= 0; });
+	}
+
+	bool isBusy()
+	{
+		std::lock_guard<std::mutex> lock(s_requestLock);
+		return s_pendingWrites > 0;
+	}
+
+	void shutdown()
+	{
 		{
-			TFE_System::logWrite(LOG_ERROR, "AsyncFileWrite", "Cannot write file: %s", path);
-			return false;
+			std::lock_guard<std::mutex> lock(s_requestLock);
+			s_exit = true;
 		}
+		s_requestReady.notify_all();
 
-		CloseHandle(hFile);
-		return true;
+		if (s_writer.joinable())
+		{
+			s_writer.join();
+		}
+		s_writer = std::thread();
 	}
-#endif
 };
@@ -1,15 +1,39 @@
 #pragma once
+//////////////////////////////////////////////////////////////////////
+// Writes whole files to disk on a dedicated writer thread, so slow
+// disks do not stall the main thread or the job system. Writes are
+// performed in the order they are queued and each file is written to
+// a temporary file first, which then atomically replaces the target,
+// so an interrupted write never leaves a truncated file behind.
+//////////////////////////////////////////////////////////////////////
 #include <TFE_System/system.h>
+#include <vector>
 
 // TODO: Flesh out error codes.
 enum AsyncFileWriteCodes
 {
 	AFW_SUCCESS = 0,
+	AFW_OPEN_FAILED,
+	AFW_WRITE_FAILED,
 };
 
+// Called from the writer thread once the file has been written (or failed).
 typedef void(*FileWriteCompletionCallback)(size_t bytesWritten, void* userData, u32 errorCode);
+// Called from the writer thread to fill in the file contents just before they are written.
+typedef void(*FileBuildCallback)(std::vector<u8>& output, void* buildData);
 
 namespace FileWriterAsync
 {
+	// The data is copied, so it can be freed as soon as this returns.
 	bool writeFileToDisk(const char* path, u8* data, size_t dataSize, FileWriteCompletionCallback completionCallback = nullptr, void* userData = nullptr);
+	// Takes ownership of 'data', avoiding the copy.
+	bool writeFileToDisk(const char* path, std::vector<u8>&& data, FileWriteCompletionCallback completionCallback = nullptr, void* userData = nullptr);
+	// The contents are built on the writer thread, so slow work such as encoding stays off the main thread and the job system.
+	bool writeFileToDisk(const char* path, FileBuildCallback build, void* buildData, FileWriteCompletionCallback completionCallback = nullptr, void* userData = nullptr);
+
+	// Block until all queued writes have finished.
+	void waitForWrites();
+	bool isBusy();
+	// Finish the queued writes and stop the writer thread.
+	void shutdown();
 };
@@ -0,0 +1,46 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mappedFile.h"
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(const char *path)
+{
+	struct stat st;
+	void *data;
+	int fd;
+
+	close();
+
+	fd = ::open(path, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	if (fstat(fd, &st) || st.st_size <= 0) {
+		::close(fd);
+		return false;
+	}
+
+	// the mapping keeps its own reference to the file.
+	data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (data == MAP_FAILED)
+		return false;
+
+	m_data = (const u8 *)data;
+	m_size = st.st_size;
+	return true;
+}
+
+void MappedFile::close(void)
+{
+	if (m_data)
+		munmap((void *)m_data, m_size);
+	m_data = nullptr;
+	m_size = 0;
+}
@@ -0,0 +1,63 @@
+#include "mappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN 1
+#include <Windows.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(const char* path)
+{
+	close();
+
+	// Allow other processes to write, rename or delete the file while it is mapped, so mods and tools can replace
+	// archives while TFE is running. A file replaced by a rename keeps the old data in the view until it is reopened.
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) { return false; }
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	m_data = (const u8*)data;
+	m_size = size_t(size.QuadPart);
+	m_fileHandle = file;
+	m_mapHandle = mapping;
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (m_data)
+	{
+		UnmapViewOfFile(m_data);
+		CloseHandle(m_mapHandle);
+		CloseHandle(m_fileHandle);
+	}
+	m_data = nullptr;
+	m_size = 0;
+	m_fileHandle = nullptr;
+	m_mapHandle = nullptr;
+}
@@ -0,0 +1,30 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// A read-only memory-mapped file.
+// The view is backed directly by the OS page cache, so reading from it
+// does not copy the data and several processes mapping the same file
+// share the same physical pages.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+class MappedFile
+{
+public:
+	MappedFile() : m_data(nullptr), m_size(0), m_fileHandle(nullptr), m_mapHandle(nullptr) {}
+	~MappedFile();
+
+	// Map the whole file, fails for empty files.
+	bool open(const char* path);
+	void close();
+
+	bool isOpen() const { return m_data != nullptr; }
+	const u8* getData() const { return m_data; }
+	size_t getSize() const { return m_size; }
+
+private:
+	const u8* m_data;
+	size_t m_size;
+	// Platform handles, unused on platforms that can close the file once it is mapped.
+	void* m_fileHandle;
+	void* m_mapHandle;
+};
@@ -3,10 +3,12 @@
 #include "paths.h"
 #include "fileutil.h"
 #include "filestream.h"
+#include "vfs.h"
 #include <TFE_System/system.h>
 #include <TFE_Archive/archive.h>
 #include <algorithm>
 #include <deque>
+#include <mutex>
 #include <string>
 
 namespace TFE_Paths
@@ -22,6 +24,7 @@ namespace TFE_Paths
 	static std::deque<std::string> s_searchPaths;
 	static std::deque<FileMapping> s_fileMappings;
 	static std::deque<std::string> s_systemPaths;	// TFE Support data paths
+	static std::mutex s_fileIndexLock;
 
 	void setPath(TFE_PathType pathType, const char* path)
 	{
@@ -170,10 +173,31 @@ namespace TFE_Paths
 		return false;
 	}
 
+	// The search paths and archives are resolved through a single file index,
+	// which is rebuilt on the next lookup after they change.
+	static void invalidateFileIndex(bool rescanDirectories)
+	{
+		std::lock_guard<std::mutex> lock(s_fileIndexLock);
+		TFE_VFS::invalidate(rescanDirectories);
+	}
+
+	static void buildFileIndex(void)
+	{
+		TFE_VFS::beginBuild();
+		for (auto it = s_searchPaths.begin(); it != s_searchPaths.end(); it++)
+			TFE_VFS::addDirectory(it->c_str());
+		for (auto it = s_localArchives.begin(); it != s_localArchives.end(); it++)
+			TFE_VFS::addArchive(*it);
+		TFE_VFS::endBuild();
+	}
+
 	void addSearchPath(const char *fullPath)
 	{
 		char workpath[TFE_MAX_PATH];
 
+		// Adding a path, even one already in the list, rescans the directories.
+		invalidateFileIndex(true);
+
 		if (!FileUtil::directoryExits(fullPath, workpath))
 			return;
 
@@ -192,6 +216,8 @@ namespace TFE_Paths
 	{
 		char workpath[TFE_MAX_PATH];
 
+		invalidateFileIndex(true);
+
 		if (!FileUtil::directoryExits(fullPath, workpath))
 			return;
 
@@ -208,12 +234,14 @@ namespace TFE_Paths
 
 	void clearSearchPaths(void)
 	{
+		invalidateFileIndex(true);
 		s_searchPaths.clear();
 		s_fileMappings.clear();
 	}
 
 	void clearLocalArchives(void)
 	{
+		invalidateFileIndex(false);
 		std::for_each(s_localArchives.begin(), s_localArchives.end(),
 				[](Archive *a) { Archive::freeArchive(a); });
 		s_localArchives.clear();
@@ -263,21 +291,25 @@ namespace TFE_Paths
 
 	void addLocalArchiveToFront(Archive *a)
 	{
+		invalidateFileIndex(false);
 		s_localArchives.push_front(a);
 	}
 
 	void removeFirstArchive(void)
 	{
+		invalidateFileIndex(false);
 		s_localArchives.pop_front();
 	}
 
 	void addLocalArchive(Archive *a)
 	{
+		invalidateFileIndex(false);
 		s_localArchives.push_back(a);
 	}
 
 	void removeLastArchive(void)
 	{
+		invalidateFileIndex(false);
 		s_localArchives.pop_back();
 	}
 
@@ -298,24 +330,23 @@ namespace TFE_Paths
 			}
 		}
 
-		// Search in the local search paths before local archives: s_searchPaths.
-		for (auto it = s_searchPaths.begin(); it != s_searchPaths.end(); it++) {
-			sprintf(fullname, "%s%s", it->c_str(), fileName);
-			if (FileUtil::existsNoCase(fullname)) {
-				strncpy(outPath->path, fullname, TFE_MAX_PATH);
-				return true;
+		// Names that include a directory are not in the file index, so search the local paths directly.
+		if (strchr(fileName, '/') || strchr(fileName, '\\')) {
+			for (auto it = s_searchPaths.begin(); it != s_searchPaths.end(); it++) {
+				sprintf(fullname, "%s%s", it->c_str(), fileName);
+				if (FileUtil::existsNoCase(fullname)) {
+					strncpy(outPath->path, fullname, TFE_MAX_PATH);
+					return true;
+				}
 			}
 		}
 
-		// Then archives: s_localArchives.
-		for (auto it = s_localArchives.begin(); it != s_localArchives.end(); it++) {
-			u32 index = (*it)->getFileIndex(fileName);
-			if (index != INVALID_FILE) {
-				outPath->archive = *it;
-				outPath->index = index;
-				return true;
-			}
-		}
+		// Then the local search paths before local archives, through the file index.
+		std::lock_guard<std::mutex> lock(s_fileIndexLock);
+		if (!TFE_VFS::isValid())
+			buildFileIndex();
+		if (TFE_VFS::findFile(fileName, outPath))
+			return true;
 
 		// Finally admit defeat.
 		return false;
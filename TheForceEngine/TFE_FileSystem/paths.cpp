@@ -2,8 +2,10 @@
 #include "paths.h"
 #include "fileutil.h"
 #include "filestream.h"
+#include "vfs.h"
 #include <TFE_System/system.h>
 #include <TFE_Archive/archive.h>
+#include <mutex>
 #include <string>
 
 #ifdef _WIN32
@@ -31,6 +33,7 @@ namespace TFE_Paths
 	static std::vector<Archive*> s_localArchives;
 	static std::vector<std::string> s_searchPaths;
 	static std::vector<FileMapping> s_fileMappings;
+	static std::mutex s_fileIndexLock;
 
 	void setPath(TFE_PathType pathType, const char* path)
 	{
@@ -154,8 +157,33 @@ namespace TFE_Paths
 		}
 	}
 
+	// The search paths and archives are resolved through a single file index, which is rebuilt on the next lookup after they change.
+	static void invalidateFileIndex(bool rescanDirectories)
+	{
+		std::lock_guard<std::mutex> lock(s_fileIndexLock);
+		TFE_VFS::invalidate(rescanDirectories);
+	}
+
+	static void buildFileIndex()
+	{
+		TFE_VFS::beginBuild();
+		const size_t pathCount = s_searchPaths.size();
+		for (size_t i = 0; i < pathCount; i++)
+		{
+			TFE_VFS::addDirectory(s_searchPaths[i].c_str());
+		}
+		const size_t archiveCount = s_localArchives.size();
+		for (size_t i = 0; i < archiveCount; i++)
+		{
+			TFE_VFS::addArchive(s_localArchives[i]);
+		}
+		TFE_VFS::endBuild();
+	}
+
 	void addSearchPath(const char* fullPath)
 	{
+		// Adding a path, even one already in the list, rescans the directories.
+		invalidateFileIndex(true);
 		if (FileUtil::directoryExits(fullPath))
 		{
 			const size_t count = s_searchPaths.size();
@@ -175,6 +203,7 @@ namespace TFE_Paths
 
 	void addSearchPathToHead(const char* fullPath)
 	{
+		invalidateFileIndex(true);
 		if (FileUtil::directoryExits(fullPath))
 		{
 			const size_t count = s_searchPaths.size();
@@ -194,12 +223,14 @@ namespace TFE_Paths
 
 	void clearSearchPaths()
 	{
+		invalidateFileIndex(true);
 		s_searchPaths.clear();
 		s_fileMappings.clear();
 	}
 
 	void clearLocalArchives()
 	{
+		invalidateFileIndex(false);
 		const size_t count = s_localArchives.size();
 		Archive** archive = s_localArchives.data();
 		for (size_t i = 0; i < count; i++)
@@ -253,21 +284,25 @@ namespace TFE_Paths
 		
 	void addLocalArchiveToFront(Archive* archive)
 	{
+		invalidateFileIndex(false);
 		s_localArchives.insert(s_localArchives.begin(), archive);
 	}
 
 	void removeFirstArchive()
 	{
+		invalidateFileIndex(false);
 		s_localArchives.erase(s_localArchives.begin());
 	}
 
 	void addLocalArchive(Archive* archive)
 	{
+		invalidateFileIndex(false);
 		s_localArchives.push_back(archive);
 	}
 
 	void removeLastArchive()
 	{
+		invalidateFileIndex(false);
 		s_localArchives.pop_back();
 	}
 
@@ -291,34 +326,34 @@ namespace TFE_Paths
 			}
 		}
 
-		// Search in the local search paths before local archives: s_searchPaths.
-		const size_t pathCount = s_searchPaths.size();
-		const std::string* localPath = s_searchPaths.data();
-		for (size_t i = 0; i < pathCount; i++, localPath++)
+		// Names that include a directory are not in the file index, so search the local paths directly.
+		if (strchr(fileName, '/') || strchr(fileName, '\\'))
 		{
-			char fullName[TFE_MAX_PATH];
-			sprintf(fullName, "%s%s", localPath->c_str(), fileName);
-
-			FileStream file;
-			if (file.exists(fullName))
+			const size_t pathCount = s_searchPaths.size();
+			const std::string* localPath = s_searchPaths.data();
+			for (size_t i = 0; i < pathCount; i++, localPath++)
 			{
-				strncpy(outPath->path, fullName, TFE_MAX_PATH);
-				return true;
+				char fullName[TFE_MAX_PATH];
+				sprintf(fullName, "%s%s", localPath->c_str(), fileName);
+
+				FileStream file;
+				if (file.exists(fullName))
+				{
+					strncpy(outPath->path, fullName, TFE_MAX_PATH);
+					return true;
+				}
 			}
 		}
 
-		// Then archives: s_localArchives.
-		const size_t archiveCount = s_localArchives.size();
-		Archive** archive = s_localArchives.data();
-		for (size_t i = 0; i < archiveCount; i++, archive++)
+		// Then the local search paths before local archives, through the file index.
 		{
-			if (!(*archive)) { continue; }	// Avoid crashing if an archive is null.
-
-			u32 index = (*archive)->getFileIndex(fileName);
-			if (index != INVALID_FILE)
+			std::lock_guard<std::mutex> lock(s_fileIndexLock);
+			if (!TFE_VFS::isValid())
+			{
+				buildFileIndex();
+			}
+			if (TFE_VFS::findFile(fileName, outPath))
 			{
-				outPath->archive = *archive;
-				outPath->index = index;
 				return true;
 			}
 		}
@@ -0,0 +1,127 @@
+#include <cstring>
+#include <cctype>
+
+#include "vfs.h"
+#include "fileutil.h"
+#include <TFE_Archive/archive.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+namespace TFE_VFS
+{
+	struct VfsEntry
+	{
+		Archive* archive;			// archive or null for a loose file.
+		u32 index;					// file index into the archive or INVALID_FILE.
+		const std::string* dir;		// search path for a loose file.
+	};
+
+	typedef std::unordered_map<std::string, VfsEntry> VfsMap;
+	typedef std::map<std::string, FileList> DirectoryMap;
+
+	static VfsMap s_index;
+	static DirectoryMap s_directories;
+	static bool s_valid = false;
+
+	static void toLowerKey(const char* name, std::string& key)
+	{
+		key.assign(name);
+		for (size_t i = 0; i < key.length(); i++)
+		{
+			key[i] = tolower((u8)key[i]);
+		}
+	}
+
+	static void addEntry(const char* name, const VfsEntry& entry)
+	{
+		std::string key;
+		toLowerKey(name, key);
+		// emplace() does not replace an existing entry, so the first source wins.
+		s_index.emplace(key, entry);
+	}
+
+	void invalidate(bool rescanDirectories)
+	{
+		s_valid = false;
+		s_index.clear();
+		if (rescanDirectories)
+		{
+			s_directories.clear();
+		}
+	}
+
+	bool isValid()
+	{
+		return s_valid;
+	}
+
+	void beginBuild()
+	{
+		s_index.clear();
+		s_valid = false;
+	}
+
+	void addDirectory(const char* path)
+	{
+		DirectoryMap::iterator iDir = s_directories.find(path);
+		if (iDir == s_directories.end())
+		{
+			iDir = s_directories.insert(std::make_pair(std::string(path), FileList())).first;
+			FileUtil::readDirectoryFiles(path, iDir->second);
+		}
+
+		const VfsEntry entry = { nullptr, INVALID_FILE, &iDir->first };
+		const size_t count = iDir->second.size();
+		const std::string* file = iDir->second.data();
+		for (size_t i = 0; i < count; i++, file++)
+		{
+			addEntry(file->c_str(), entry);
+		}
+	}
+
+	void addArchive(Archive* archive)
+	{
+		if (!archive) { return; }
+
+		const u32 count = archive->getFileCount();
+		for (u32 i = 0; i < count; i++)
+		{
+			const char* name = archive->getFileName(i);
+			if (!name) { continue; }
+
+			const VfsEntry entry = { archive, i, nullptr };
+			addEntry(name, entry);
+		}
+	}
+
+	void endBuild()
+	{
+		s_valid = true;
+	}
+
+	bool findFile(const char* fileName, FilePath* outPath)
+	{
+		std::string key;
+		toLowerKey(fileName, key);
+
+		VfsMap::const_iterator iEntry = s_index.find(key);
+		if (iEntry == s_index.end()) { return false; }
+
+		const VfsEntry& entry = iEntry->second;
+		if (entry.archive)
+		{
+			outPath->archive = entry.archive;
+			outPath->index = entry.index;
+			outPath->path[0] = 0;
+		}
+		else
+		{
+			// Keep the requested name, as searching the paths directly did.
+			outPath->archive = nullptr;
+			outPath->index = INVALID_FILE;
+			snprintf(outPath->path, TFE_MAX_PATH, "%s%s", entry.dir->c_str(), fileName);
+		}
+		return true;
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Virtual File System Index
+// A single case-insensitive name -> (archive, index | path) map of the
+// loose files in the search paths and the files in the local archives.
+// It is built lazily by TFE_Paths and invalidated explicitly whenever
+// the search paths or archives change, so resolving a file name does
+// not touch the disk.
+//
+// Sources are added in precedence order and the first source to add
+// a name owns it, which matches searching the paths and then the
+// archives in order.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include "paths.h"
+
+class Archive;
+
+namespace TFE_VFS
+{
+	// Discard the index, it is rebuilt on the next lookup.
+	// If 'rescanDirectories' is true the cached directory listings are discarded as well,
+	// otherwise only the archives need to be re-indexed.
+	void invalidate(bool rescanDirectories);
+	bool isValid();
+
+	// Rebuild the index: clear it, then add each source in precedence order.
+	void beginBuild();
+	// Only the files directly in 'path' are indexed, the listing is cached until the directories are rescanned.
+	void addDirectory(const char* path);
+	void addArchive(Archive* archive);
+	void endBuild();
+
+	// Fill in 'outPath' with the first source that contains 'fileName'.
+	// Directories are not indexed recursively, so names that include a directory only match archive entries.
+	bool findFile(const char* fileName, FilePath* outPath);
+}
@@ -13,6 +13,7 @@
 #include <TFE_System/system.h>
 #include <TFE_System/parser.h>
 #include <TFE_System/frameLimiter.h>
+#include <TFE_System/jobSystem.h>
 #include <TFE_Jedi/IMuse/imuse.h>
 #include <TFE_FileSystem/fileutil.h>
 #include <TFE_FileSystem/paths.h>
@@ -20,6 +21,7 @@
 #include <TFE_Archive/archive.h>
 #include <TFE_Settings/settings.h>
 #include <TFE_Asset/imageAsset.h>
+#include <TFE_Asset/assetCache.h>
 #include <TFE_Archive/zipArchive.h>
 #include <TFE_Archive/gobMemoryArchive.h>
 #include <TFE_Input/inputMapping.h>
@@ -1096,6 +1098,20 @@ namespace TFE_FrontEndUI
 			gameSettings->df_ignoreInfLimit = ignoreInfLimit;
 		}
 
+		bool levelCache = gameSettings->df_levelCache;
+		if (ImGui::Checkbox("Cache Level Geometry", &levelCache))
+		{
+			gameSettings->df_levelCache = levelCache;
+		}
+
+		// Decoded level assets are kept between levels up to this budget.
+		ImGui::LabelText("##ConfigLabel", "Asset Cache (MB)"); ImGui::SameLine(150 * s_uiScale);
+		ImGui::SetNextItemWidth(196 * s_uiScale);
+		if (ImGui::SliderInt("##AssetCacheSize", &gameSettings->df_assetCacheSize, 0, 1024, "%d"))
+		{
+			TFE_AssetCache::setBudget(size_t(gameSettings->df_assetCacheSize) * 1024 * 1024);
+		}
+
 		if (s_drawNoGameDataMsg)
 		{
 			ImGui::Separator();
@@ -1177,6 +1193,8 @@ namespace TFE_FrontEndUI
 	///////////////////////////////////////////////////////////////////////////////
 	static std::vector<TFE_SaveSystem::SaveHeader> s_saveDir;
 	static TextureGpu* s_saveImageView = nullptr;
+	// Thumbnails are decoded in the background, the selected one is shown once it is ready.
+	static s32 s_saveImageIndex = -1;
 	static s32 s_selectedSave = -1;
 	static s32 s_selectedSaveSlot = -1;
 	static bool s_hasQuicksave = false;
@@ -1192,11 +1210,25 @@ namespace TFE_FrontEndUI
 		u32 zero[TFE_SaveSystem::SAVE_IMAGE_WIDTH * TFE_SaveSystem::SAVE_IMAGE_HEIGHT];
 		memset(zero, 0, sizeof(u32) * TFE_SaveSystem::SAVE_IMAGE_WIDTH * TFE_SaveSystem::SAVE_IMAGE_HEIGHT);
 		s_saveImageView->update(zero, TFE_SaveSystem::SAVE_IMAGE_WIDTH * TFE_SaveSystem::SAVE_IMAGE_HEIGHT * 4);
+		s_saveImageIndex = -1;
 	}
 
 	void updateSaveImage(s32 index)
 	{
-		s_saveImageView->update(s_saveDir[index].imageData, TFE_SaveSystem::SAVE_IMAGE_WIDTH * TFE_SaveSystem::SAVE_IMAGE_HEIGHT * 4);
+		clearSaveImage();
+		s_saveImageIndex = index;
+	}
+
+	void pollSaveImage()
+	{
+		if (s_saveImageIndex < 0 || s_saveImageIndex >= (s32)s_saveDir.size()) { return; }
+
+		const u32* image = TFE_SaveSystem::getSaveImage(&s_saveDir[s_saveImageIndex]);
+		if (image)
+		{
+			s_saveImageView->update(image, TFE_SaveSystem::SAVE_IMAGE_WIDTH * TFE_SaveSystem::SAVE_IMAGE_HEIGHT * 4);
+			s_saveImageIndex = -1;
+		}
 	}
 
 	void openSaveNameEditPopup(const char* prevName)
@@ -1268,6 +1300,7 @@ namespace TFE_FrontEndUI
 		{
 			configSaveLoadBegin(save);
 		}
+		pollSaveImage();
 
 		// Create the current display info to adjust menu sizes.
 		DisplayInfo displayInfo;
@@ -2186,6 +2219,13 @@ namespace TFE_FrontEndUI
 			graphics->asyncFramebuffer = true;
 			graphics->gpuColorConvert = true;
 			ImGui::Checkbox("Extend Adjoin/Portal Limits", &graphics->extendAjoinLimits);
+
+			// Render threads, the view is split into one strip per thread.
+			const s32 maxThreads = TFE_Jobs::getWorkerCount() + 1;
+			graphics->renderThreadCount = clamp(graphics->renderThreadCount, 1, maxThreads);
+			ImGui::LabelText("##ConfigLabel", "Render Threads"); ImGui::SameLine(150 * s_uiScale);
+			ImGui::SetNextItemWidth(196 * s_uiScale);
+			ImGui::SliderInt("##RenderThreads", &graphics->renderThreadCount, 1, maxThreads, "%d");
 		}
 		else if (graphics->rendererIndex == 1)
 		{
@@ -10,10 +10,16 @@
 #include <TFE_FileSystem/fileutil.h>
 #include <TFE_FileSystem/paths.h>
 #include <TFE_FileSystem/filestream.h>
+#include <TFE_FileSystem/bufferedstream.h>
+#include <TFE_FileSystem/deflatestream.h>
+#include <TFE_FileSystem/memorystream.h>
+#include <TFE_FileSystem/filewriterAsync.h>
+#include <TFE_System/jobSystem.h>
 #include <TFE_Archive/archive.h>
 #include <TFE_Settings/settings.h>
 #include <TFE_Asset/imageAsset.h>
 #include <TFE_Archive/zipArchive.h>
+#include <TFE_Archive/gobArchive.h>
 #include <TFE_Archive/gobMemoryArchive.h>
 #include <TFE_Input/inputMapping.h>
 #include <TFE_Asset/imageAsset.h>
@@ -23,6 +29,8 @@
 // Game
 #include <TFE_DarkForces/mission.h>
 #include <TFE_Jedi/Renderer/jediRenderer.h>
+#include <algorithm>
+#include <atomic>
 #include <map>
 
 using namespace TFE_Input;
@@ -41,6 +49,31 @@ namespace TFE_FrontEndUI
 		QueuedReadType type;
 		std::string path;
 		std::string fileName;
+		std::string name;		// Mod directory or zip file name, unique across the mod directories.
+	};
+
+	// Mod info cache, so archives are only opened and posters only decoded when a mod changes.
+	enum ModCacheConst
+	{
+		MOD_CACHE_MAGIC   = 0x43444f4d,	// "MODC"
+		MOD_CACHE_VERSION = 1,			// Bump whenever the cached data changes.
+		MOD_CACHE_STRING_COUNT = 5,
+		// Posters are shrunk to fit, they are never displayed larger than this at 100% UI scale.
+		MOD_POSTER_MAX_WIDTH  = 320,
+		MOD_POSTER_MAX_HEIGHT = 240,
+	};
+
+	struct ModCacheHeader
+	{
+		u32 magic;
+		u32 version;
+		// Modified time and size of the mod files, used to validate the cache.
+		u64 sourceTime;
+		u64 sourceSize;
+
+		u32 invertImage;
+		u32 posterWidth;
+		u32 posterHeight;
 	};
 
 	struct ModData
@@ -57,32 +90,53 @@ namespace TFE_FrontEndUI
 		bool invertImage = true;
 	};
 	static std::vector<ModData> s_mods;
-		
-	static std::vector<char> s_fileBuffer;
-	static std::vector<u8> s_readBuffer[2];
 	static s32 s_selectedMod;
 
-	static std::vector<QueuedRead> s_readQueue;
-	static std::vector<u8> s_imageBuffer;
+	// Poster pixels, the texture is created on the main thread.
+	struct ModPoster
+	{
+		std::vector<u32> pixels;
+		u32 width = 0;
+		u32 height = 0;
+	};
+
+	// A mod being read on a worker thread.
+	struct ModRead
+	{
+		QueuedRead read;
+		ModData mod;
+		ModPoster poster;
+		bool valid;
+		std::atomic<bool> ready;
+	};
+
+	// Mods are read in parallel and added to the list in order as they finish.
+	static std::vector<ModRead*> s_reads;
 	static size_t s_readIndex = 0;
+	static atomic_s32 s_readJobs(0);
+	static std::atomic<bool> s_cancelReads(false);
+	static char s_modCacheDir[TFE_MAX_PATH];
+	// Base game archives for the default poster, looked up on the main thread and read through handles.
+	static Archive* s_darkArchive = nullptr;
+	static Archive* s_texturesArchive = nullptr;
 
 	static ViewMode s_viewMode = VIEW_IMAGES;
 
 	void fixupName(char* name);
 	void readFromQueue(size_t itemsPerFrame);
+	void cancelReads();
+	void readModJob(void* userData);
 	bool parseNameFromText(const char* textFileName, const char* path, char* name, std::string* fullText);
-	void extractPosterFromImage(const char* baseDir, const char* zipFile, const char* imageFileName, EditorTexture* poster);
-	void extractPosterFromMod(const char* baseDir, const char* archiveFileName, EditorTexture* poster);
+	bool extractPosterFromImage(const char* baseDir, const char* zipFile, const char* imageFileName, ModPoster* poster);
+	bool extractPosterFromMod(const char* baseDir, const char* archiveFileName, ModPoster* poster);
 
 	void modLoader_read()
 	{
+		cancelReads();
 		s_mods.clear();
 		s_selectedMod = -1;
 		clearSelectedMod();
 
-		s_readQueue.clear();
-		s_readIndex = 0;
-
 		// There are 3 possible mod directory locations:
 		// In the TFE directory,
 		// In the original source data.
@@ -127,6 +181,7 @@ namespace TFE_FrontEndUI
 			return;
 		}
 
+		std::vector<QueuedRead> readQueue;
 		FileList dirList, zipList;
 		for (s32 i = 0; i < modPathCount; i++)
 		{
@@ -138,7 +193,7 @@ namespace TFE_FrontEndUI
 			const std::string* dir = dirList.data();
 			for (size_t d = 0; d < count; d++)
 			{
-				s_readQueue.push_back({ QREAD_DIR, dir[d], "" });
+				readQueue.push_back({ QREAD_DIR, dir[d], "", "" });
 			}
 		}
 		// Read Zip Files.
@@ -149,14 +204,14 @@ namespace TFE_FrontEndUI
 			size_t count = zipList.size();
 			for (size_t z = 0; z < count; z++)
 			{
-				s_readQueue.push_back({ QREAD_ZIP, modPaths[i], zipList[z] });
+				readQueue.push_back({ QREAD_ZIP, modPaths[i], zipList[z], "" });
 			}
 		}
 
 		// De-dup the read queue since mods can come from different directories.
 		std::map<std::string, s32> nameMap;
-		std::vector<QueuedRead>::iterator iEntry = s_readQueue.begin();
-		for (; iEntry != s_readQueue.end();)
+		std::vector<QueuedRead>::iterator iEntry = readQueue.begin();
+		for (; iEntry != readQueue.end();)
 		{
 			std::string modDirOrZip;
 			// If this is a zip file, we already have the file name.
@@ -189,19 +244,70 @@ namespace TFE_FrontEndUI
 			if (iExistingEntry != nameMap.end())
 			{
 				// This already exists and should be removed.
-				iEntry = s_readQueue.erase(iEntry);
+				iEntry = readQueue.erase(iEntry);
 			}
 			else
 			{
 				// Add it to the map.
 				nameMap[modDirOrZip] = 1;
+				iEntry->name = modDirOrZip;
 				++iEntry;
 			}
 		}
+
+		char cacheDir[TFE_MAX_PATH];
+		TFE_Paths::appendPath(PATH_PROGRAM_DATA, "Cache/", cacheDir);
+		if (!FileUtil::directoryExits(cacheDir))
+		{
+			FileUtil::makeDirectory(cacheDir);
+		}
+		TFE_Paths::appendPath(PATH_PROGRAM_DATA, "Cache/Mods/", s_modCacheDir);
+		if (!FileUtil::directoryExits(s_modCacheDir))
+		{
+			FileUtil::makeDirectory(s_modCacheDir);
+		}
+
+		char srcPath[TFE_MAX_PATH], srcPathTex[TFE_MAX_PATH];
+		sprintf(srcPath, "%s%s", TFE_Paths::getPath(PATH_SOURCE_DATA), "DARK.GOB");
+		sprintf(srcPathTex, "%s%s", TFE_Paths::getPath(PATH_SOURCE_DATA), "TEXTURES.GOB");
+		s_darkArchive = Archive::getArchive(ARCHIVE_GOB, "DARK.GOB", srcPath);
+		s_texturesArchive = Archive::getArchive(ARCHIVE_GOB, "TEXTURES.GOB", srcPathTex);
+
+		// Open the archives, parse the text and decode the posters in the background.
+		const size_t readCount = readQueue.size();
+		s_reads.resize(readCount);
+		for (size_t i = 0; i < readCount; i++)
+		{
+			ModRead* modRead = new ModRead();
+			modRead->read = readQueue[i];
+			modRead->valid = false;
+			modRead->ready = false;
+			s_reads[i] = modRead;
+		}
+		for (size_t i = 0; i < readCount; i++)
+		{
+			TFE_Jobs::addJob(readModJob, s_reads[i], &s_readJobs);
+		}
+	}
+
+	// Stop reading mods, reads that have not started yet are skipped.
+	void cancelReads()
+	{
+		s_cancelReads = true;
+		TFE_Jobs::waitForCounter(&s_readJobs);
+		s_cancelReads = false;
+
+		for (size_t i = 0; i < s_reads.size(); i++)
+		{
+			delete s_reads[i];
+		}
+		s_reads.clear();
+		s_readIndex = 0;
 	}
 
 	void modLoader_cleanupResources()
 	{
+		cancelReads();
 		for (size_t i = 0; i < s_mods.size(); i++)
 		{
 			if (s_mods[i].image.texture)
@@ -364,8 +470,8 @@ namespace TFE_FrontEndUI
 		bool stayOpen = true;
 		f32 uiScale = (f32)TFE_Ui::getUiScale() * 0.01f;
 
-		// Load in the mod data a few at a time so to limit waiting for loading.
-		readFromQueue(1);
+		// Mods are read in the background, add the ones that are ready a few at a time to limit texture uploads per frame.
+		readFromQueue(16);
 		clearSelectedMod();
 		if (s_mods.empty()) { return stayOpen; }
 
@@ -534,6 +640,7 @@ namespace TFE_FrontEndUI
 		const size_t len = strlen(textFileName);
 		const char* ext = &textFileName[len - 3];
 		size_t textLen = 0;
+		std::vector<char> fileBuffer;
 		if (strcasecmp(ext, "zip") == 0)
 		{
 			ZipArchive zipArchive;
@@ -558,9 +665,9 @@ namespace TFE_FrontEndUI
 				if (txtIndex >= 0 && zipArchive.openFile(txtIndex))
 				{
 					textLen = zipArchive.getFileLength();
-					s_fileBuffer.resize(textLen + 1);
-					s_fileBuffer[0] = 0;
-					zipArchive.readFile(s_fileBuffer.data(), textLen);
+					fileBuffer.resize(textLen + 1);
+					fileBuffer[0] = 0;
+					zipArchive.readFile(fileBuffer.data(), textLen);
 					zipArchive.closeFile();
 				}
 			}
@@ -576,12 +683,12 @@ namespace TFE_FrontEndUI
 				return false;
 			}
 			textLen = textFile.getSize();
-			s_fileBuffer.resize(textLen + 1);
-			s_fileBuffer[0] = 0;
-			textFile.readBuffer(s_fileBuffer.data(), (u32)textLen);
+			fileBuffer.resize(textLen + 1);
+			fileBuffer[0] = 0;
+			textFile.readBuffer(fileBuffer.data(), (u32)textLen);
 			textFile.close();
 		}
-		if (!textLen || s_fileBuffer[0] == 0)
+		if (!textLen || fileBuffer[0] == 0)
 		{
 			return false;
 		}
@@ -589,9 +696,9 @@ namespace TFE_FrontEndUI
 		// Some files start with garbage at the beginning...
 		// So try a small probe first to see if such fixup is reqiured.
 		bool needsFixup = false;
-		for (size_t i = 0; i < 10 && i < s_fileBuffer.size(); i++)
+		for (size_t i = 0; i < 10 && i < fileBuffer.size(); i++)
 		{
-			if (s_fileBuffer[i] == 0)
+			if (fileBuffer[i] == 0)
 			{
 				needsFixup = true;
 				break;
@@ -601,8 +708,8 @@ namespace TFE_FrontEndUI
 		size_t lastZero = 0;
 		if (needsFixup)
 		{
-			size_t len = s_fileBuffer.size();
-			const char* text = s_fileBuffer.data();
+			size_t len = fileBuffer.size();
+			const char* text = fileBuffer.data();
 			for (size_t i = 0; i < len - 1 && i < 128; i++)
 			{
 				if (text[i] == 0)
@@ -612,7 +719,7 @@ namespace TFE_FrontEndUI
 			}
 			if (lastZero) { lastZero++; }
 		}
-		*fullText = std::string(s_fileBuffer.data() + lastZero, s_fileBuffer.data() + s_fileBuffer.size());
+		*fullText = std::string(fileBuffer.data() + lastZero, fileBuffer.data() + fileBuffer.size());
 
 		TFE_Parser parser;
 		parser.init(fullText->c_str(), fullText->length());
@@ -731,171 +838,348 @@ namespace TFE_FrontEndUI
 		return false;
 	}
 
+
 	void readFromQueue(size_t itemsPerFrame)
 	{
-		FileList gobFiles, txtFiles, imgFiles;
-		const size_t readEnd = min(s_readIndex + itemsPerFrame, s_readQueue.size());
-		const QueuedRead* reads = s_readQueue.data();
-		for (size_t i = s_readIndex; i < readEnd; i++, s_readIndex++)
+		for (size_t i = 0; i < itemsPerFrame && s_readIndex < s_reads.size(); i++, s_readIndex++)
 		{
-			if (reads[i].type == QREAD_DIR)
+			ModRead* modRead = s_reads[s_readIndex];
+			if (!modRead->ready) { break; }
+
+			if (modRead->valid)
 			{
-				// Clear doesn't deallocate in most implementations, so doing it this way should reduce memory allocations.
-				gobFiles.clear();
-				txtFiles.clear();
-				imgFiles.clear();
-
-				const char* subDir = reads[i].path.c_str();
-				FileUtil::readDirectory(subDir, "gob", gobFiles);
-				FileUtil::readDirectory(subDir, "txt", txtFiles);
-				FileUtil::readDirectory(subDir, "jpg", imgFiles);
-
-				// No gob files = no mod.
-				if (gobFiles.size() != 1)
-				{
-					continue;
-				}
-				s_mods.push_back({});
+				s_mods.push_back(std::move(modRead->mod));
 				ModData& mod = s_mods.back();
 
-				mod.gobFiles = gobFiles;
-				mod.textFile = txtFiles.empty() ? "" : txtFiles[0];
-				mod.imageFile = imgFiles.empty() ? "" : imgFiles[0];
-				mod.text = "";
-
-				size_t fullDirLen = strlen(subDir);
-				for (size_t i = 0; i < fullDirLen; i++)
+				const ModPoster& poster = modRead->poster;
+				if (!poster.pixels.empty())
 				{
-					if (strncasecmp("Mods", &subDir[i], 4) == 0)
-					{
-						mod.relativePath = &subDir[i + 5];
-						break;
-					}
+					mod.image.texture = TFE_RenderBackend::createTexture(poster.width, poster.height, poster.pixels.data(), MAG_FILTER_LINEAR);
+					mod.image.width = poster.width;
+					mod.image.height = poster.height;
 				}
+			}
+			delete modRead;
+			s_reads[s_readIndex] = nullptr;
+		}
+	}
 
-				if (mod.imageFile.empty())
-				{
-					extractPosterFromMod(subDir, mod.gobFiles[0].c_str(), &mod.image);
-					mod.invertImage = true;
-				}
-				else
-				{
-					extractPosterFromImage(subDir, nullptr, mod.imageFile.c_str(), &mod.image);
-					mod.invertImage = false;
-				}
+	void setModName(ModData* mod, const char* textFileName, const char* path)
+	{
+		char name[TFE_MAX_PATH];
+		if (!parseNameFromText(textFileName, path, name, &mod->text))
+		{
+			const char* gobFileName = mod->gobFiles[0].c_str();
+			memcpy(name, gobFileName, strlen(gobFileName) - 4);
+			name[strlen(gobFileName) - 4] = 0;
+			fixupName(name);
+		}
+		mod->name = name;
+	}
 
-				char name[TFE_MAX_PATH];
-				if (!parseNameFromText(mod.textFile.c_str(), subDir, name, &mod.text))
-				{
-					const char* gobFileName = mod.gobFiles[0].c_str();
-					memcpy(name, gobFileName, strlen(gobFileName) - 4);
-					name[strlen(gobFileName) - 4] = 0;
-					fixupName(name);
-				}
+	// Shrink the poster to fit in MOD_POSTER_MAX_WIDTH x MOD_POSTER_MAX_HEIGHT, keeping the aspect ratio.
+	void fitPoster(ModPoster* poster)
+	{
+		if (poster->width <= MOD_POSTER_MAX_WIDTH && poster->height <= MOD_POSTER_MAX_HEIGHT) { return; }
 
-				mod.name = name;
+		const f32 scale = std::min(f32(MOD_POSTER_MAX_WIDTH) / f32(poster->width), f32(MOD_POSTER_MAX_HEIGHT) / f32(poster->height));
+		const u32 width  = std::max(1u, u32(f32(poster->width)  * scale));
+		const u32 height = std::max(1u, u32(f32(poster->height) * scale));
+
+		std::vector<u32> pixels(width * height);
+		for (u32 y = 0; y < height; y++)
+		{
+			const u32* src = &poster->pixels[(y * poster->height / height) * poster->width];
+			u32* dst = &pixels[y * width];
+			for (u32 x = 0; x < width; x++)
+			{
+				dst[x] = src[x * poster->width / width];
 			}
-			else
+		}
+		poster->pixels.swap(pixels);
+		poster->width = width;
+		poster->height = height;
+	}
+
+	void getModCachePath(const ModRead* modRead, char* cachePath)
+	{
+		// Directory names may end with a slash.
+		char name[TFE_MAX_PATH];
+		size_t len = 0;
+		const char* src = modRead->read.name.c_str();
+		for (; *src && len < TFE_MAX_PATH - 1; src++)
+		{
+			if (*src != '/' && *src != '\\') { name[len++] = *src; }
+		}
+		name[len] = 0;
+		snprintf(cachePath, TFE_MAX_PATH, "%s%s.mdc", s_modCacheDir, name);
+	}
+
+	// The source file names are filled in before the cache is read, the entry is only used if they match.
+	bool readModCache(ModRead* modRead, u64 sourceTime, u64 sourceSize)
+	{
+		char cachePath[TFE_MAX_PATH];
+		getModCachePath(modRead, cachePath);
+
+		BufferedStream file;
+		if (!file.open(cachePath, Stream::MODE_READ))
+		{
+			return false;
+		}
+
+		ModData& mod = modRead->mod;
+		ModPoster& poster = modRead->poster;
+		ModCacheHeader header = {};
+		std::string strings[MOD_CACHE_STRING_COUNT];
+		bool valid = file.readBuffer(&header, sizeof(ModCacheHeader)) == sizeof(ModCacheHeader) && header.magic == MOD_CACHE_MAGIC &&
+			header.version == MOD_CACHE_VERSION && header.sourceTime == sourceTime && header.sourceSize == sourceSize &&
+			header.posterWidth <= MOD_POSTER_MAX_WIDTH && header.posterHeight <= MOD_POSTER_MAX_HEIGHT;
+		if (valid)
+		{
+			// Same layout as Stream::read(std::string*), but the lengths are checked against the file size before
+			// allocating so a corrupt cache cannot request huge strings.
+			u32 lengths[MOD_CACHE_STRING_COUNT];
+			valid = file.readBuffer(lengths, sizeof(lengths)) == sizeof(lengths);
+			size_t remaining = valid ? file.getSize() - file.getLoc() : 0;
+			for (s32 i = 0; i < MOD_CACHE_STRING_COUNT && valid; i++)
 			{
-				ZipArchive zipArchive;
-				const char* modPath = reads[i].path.c_str();
-				const char* zipName = reads[i].fileName.c_str();
-
-				char zipPath[TFE_MAX_PATH];
-				sprintf(zipPath, "%s%s", modPath, zipName);
-				if (!zipArchive.open(zipPath)) { continue; }
-
-				s32 gobFileIndex = -1;
-				s32 txtFileIndex = -1;
-				s32 jpgFileIndex = -1;
-
-				// Look for the following:
-				// 1. Gob File.
-				// 2. Text File.
-				// 3. JPG
-				for (u32 f = 0; f < zipArchive.getFileCount(); f++)
-				{
-					const char* fileName = zipArchive.getFileName(f);
-					size_t len = strlen(fileName);
-					if (len <= 4)
-					{
-						continue;
-					}
-					const char* ext = &fileName[len - 3];
-					if (strcasecmp(ext, "gob") == 0)
-					{
-						gobFileIndex = s32(f);
-					}
-					else if (strcasecmp(ext, "txt") == 0)
-					{
-						txtFileIndex = s32(f);
-					}
-					else if (strcasecmp(ext, "jpg") == 0)
-					{
-						jpgFileIndex = s32(f);
-					}
-				}
-				if (gobFileIndex >= 0)
-				{
-					s_mods.push_back({});
-					ModData& mod = s_mods.back();
-					mod.gobFiles.push_back(zipName);
-					mod.text = "";
+				valid = lengths[i] <= remaining;
+				if (!valid) { break; }
+				remaining -= lengths[i];
 
-					char name[TFE_MAX_PATH];
-					if (!parseNameFromText(mod.gobFiles[0].c_str(), modPath, name, &mod.text))
-					{
-						const char* gobFileName = mod.gobFiles[0].c_str();
-						memcpy(name, gobFileName, strlen(gobFileName) - 4);
-						name[strlen(gobFileName) - 4] = 0;
-						fixupName(name);
-					}
-					mod.name = name;
+				strings[i].resize(lengths[i]);
+				valid = !lengths[i] || file.readBuffer(&strings[i][0], lengths[i]) == lengths[i];
+			}
+			valid = valid && strings[0] == mod.gobFiles[0] && strings[1] == mod.textFile && strings[2] == mod.imageFile;
+		}
+		if (valid && header.posterWidth && header.posterHeight)
+		{
+			// A stale or partially written cache is simply ignored and rebuilt from the mod.
+			poster.width = header.posterWidth;
+			poster.height = header.posterHeight;
+			poster.pixels.resize(poster.width * poster.height);
+
+			const u32 size = u32(poster.pixels.size() * sizeof(u32));
+			DeflateStream inflate;
+			valid = inflate.open(&file, Stream::MODE_READ) && inflate.readBuffer(poster.pixels.data(), size) == size;
+			valid = inflate.close() && valid;
+		}
+		file.close();
 
-					if (jpgFileIndex < 0)
-					{
-						extractPosterFromMod(modPath, mod.gobFiles[0].c_str(), &mod.image);
-						mod.invertImage = true;
-					}
-					else
-					{
-						extractPosterFromImage(modPath, mod.gobFiles[0].c_str(), zipArchive.getFileName(jpgFileIndex), &mod.image);
-						mod.invertImage = false;
-					}
-				}
+		if (!valid)
+		{
+			poster = {};
+			return false;
+		}
+		mod.name = strings[3];
+		mod.text = strings[4];
+		mod.invertImage = header.invertImage != 0;
+		return true;
+	}
 
-				zipArchive.close();
+	void writeModCache(const ModRead* modRead, u64 sourceTime, u64 sourceSize)
+	{
+		char cachePath[TFE_MAX_PATH];
+		getModCachePath(modRead, cachePath);
+
+		const ModData& mod = modRead->mod;
+		const ModPoster& poster = modRead->poster;
+		ModCacheHeader header = {};
+		header.magic = MOD_CACHE_MAGIC;
+		header.version = MOD_CACHE_VERSION;
+		header.sourceTime = sourceTime;
+		header.sourceSize = sourceSize;
+		header.invertImage = mod.invertImage ? 1 : 0;
+		header.posterWidth = poster.width;
+		header.posterHeight = poster.height;
+		const std::string strings[MOD_CACHE_STRING_COUNT] = { mod.gobFiles[0], mod.textFile, mod.imageFile, mod.name, mod.text };
+
+		MemoryStream stream;
+		stream.open(Stream::MODE_WRITE);
+		stream.writeBuffer(&header, sizeof(ModCacheHeader));
+		// Same layout as Stream::write(const std::string*), but MemoryStream uses a shared work buffer for strings which is not thread safe.
+		for (s32 i = 0; i < MOD_CACHE_STRING_COUNT; i++)
+		{
+			const u32 length = u32(strings[i].length());
+			stream.write(&length);
+		}
+		for (s32 i = 0; i < MOD_CACHE_STRING_COUNT; i++)
+		{
+			stream.writeBuffer(strings[i].data(), u32(strings[i].length()));
+		}
+		if (!poster.pixels.empty())
+		{
+			DeflateStream deflate;
+			deflate.open(&stream, Stream::MODE_WRITE, DeflateStream::DSTREAM_LEVEL_FASTEST);
+			deflate.writeBuffer(poster.pixels.data(), u32(poster.pixels.size() * sizeof(u32)));
+			deflate.close();
+		}
+		stream.close();
+
+		FileWriterAsync::writeFileToDisk(cachePath, (u8*)stream.data(), stream.getSize());
+	}
+
+	bool readModDirectory(ModRead* modRead)
+	{
+		FileList gobFiles, txtFiles, imgFiles;
+		const char* subDir = modRead->read.path.c_str();
+		FileUtil::readDirectory(subDir, "gob", gobFiles);
+		FileUtil::readDirectory(subDir, "txt", txtFiles);
+		FileUtil::readDirectory(subDir, "jpg", imgFiles);
+
+		// No gob files = no mod.
+		if (gobFiles.size() != 1)
+		{
+			return false;
+		}
+		ModData& mod = modRead->mod;
+		mod.gobFiles = gobFiles;
+		mod.textFile = txtFiles.empty() ? "" : txtFiles[0];
+		mod.imageFile = imgFiles.empty() ? "" : imgFiles[0];
+		mod.text = "";
+
+		size_t fullDirLen = strlen(subDir);
+		for (size_t i = 0; i < fullDirLen; i++)
+		{
+			if (strncasecmp("Mods", &subDir[i], 4) == 0)
+			{
+				mod.relativePath = &subDir[i + 5];
+				break;
+			}
+		}
+
+		// The cache entry is keyed by the newest modified time and the total size of the files used.
+		const std::string* files[] = { &mod.gobFiles[0], &mod.textFile, &mod.imageFile };
+		u64 sourceTime = 0, sourceSize = 0;
+		for (size_t i = 0; i < 3; i++)
+		{
+			if (files[i]->empty()) { continue; }
+
+			char filePath[TFE_MAX_PATH];
+			sprintf(filePath, "%s%s", subDir, files[i]->c_str());
+			sourceTime = std::max(sourceTime, FileUtil::getModifiedTime(filePath));
+			sourceSize += FileUtil::getFileSize(filePath);
+		}
+		if (readModCache(modRead, sourceTime, sourceSize))
+		{
+			return true;
+		}
+
+		if (mod.imageFile.empty())
+		{
+			extractPosterFromMod(subDir, mod.gobFiles[0].c_str(), &modRead->poster);
+			mod.invertImage = true;
+		}
+		else
+		{
+			extractPosterFromImage(subDir, nullptr, mod.imageFile.c_str(), &modRead->poster);
+			mod.invertImage = false;
+		}
+		setModName(&mod, mod.textFile.c_str(), subDir);
+
+		writeModCache(modRead, sourceTime, sourceSize);
+		return true;
+	}
+
+	bool readModZip(ModRead* modRead)
+	{
+		const char* modPath = modRead->read.path.c_str();
+		const char* zipName = modRead->read.fileName.c_str();
+		char zipPath[TFE_MAX_PATH];
+		sprintf(zipPath, "%s%s", modPath, zipName);
+
+		ModData& mod = modRead->mod;
+		mod.gobFiles.push_back(zipName);
+		mod.text = "";
+
+		const u64 sourceTime = FileUtil::getModifiedTime(zipPath);
+		const u64 sourceSize = FileUtil::getFileSize(zipPath);
+		if (readModCache(modRead, sourceTime, sourceSize))
+		{
+			return true;
+		}
+
+		ZipArchive zipArchive;
+		if (!zipArchive.open(zipPath)) { return false; }
+
+		s32 gobFileIndex = -1;
+		s32 txtFileIndex = -1;
+		s32 jpgFileIndex = -1;
+
+		// Look for the following:
+		// 1. Gob File.
+		// 2. Text File.
+		// 3. JPG
+		for (u32 f = 0; f < zipArchive.getFileCount(); f++)
+		{
+			const char* fileName = zipArchive.getFileName(f);
+			size_t len = strlen(fileName);
+			if (len <= 4)
+			{
+				continue;
 			}
+			const char* ext = &fileName[len - 3];
+			if (strcasecmp(ext, "gob") == 0)
+			{
+				gobFileIndex = s32(f);
+			}
+			else if (strcasecmp(ext, "txt") == 0)
+			{
+				txtFileIndex = s32(f);
+			}
+			else if (strcasecmp(ext, "jpg") == 0)
+			{
+				jpgFileIndex = s32(f);
+			}
+		}
+		if (gobFileIndex < 0)
+		{
+			zipArchive.close();
+			return false;
+		}
+
+		setModName(&mod, zipName, modPath);
+		if (jpgFileIndex < 0)
+		{
+			extractPosterFromMod(modPath, zipName, &modRead->poster);
+			mod.invertImage = true;
 		}
+		else
+		{
+			extractPosterFromImage(modPath, zipName, zipArchive.getFileName(jpgFileIndex), &modRead->poster);
+			mod.invertImage = false;
+		}
+		zipArchive.close();
+
+		writeModCache(modRead, sourceTime, sourceSize);
+		return true;
 	}
 
-	void extractPosterFromImage(const char* baseDir, const char* zipFile, const char* imageFileName, EditorTexture* poster)
+	void readModJob(void* userData)
 	{
+		ModRead* modRead = (ModRead*)userData;
+		if (!s_cancelReads)
+		{
+			modRead->valid = (modRead->read.type == QREAD_DIR) ? readModDirectory(modRead) : readModZip(modRead);
+		}
+		modRead->ready = true;
+	}
+
+	bool extractPosterFromImage(const char* baseDir, const char* zipFile, const char* imageFileName, ModPoster* poster)
+	{
+		std::vector<u8> imageBuffer;
 		if (zipFile && zipFile[0])
 		{
 			char zipPath[TFE_MAX_PATH];
 			sprintf(zipPath, "%s%s", baseDir, zipFile);
 
 			ZipArchive zipArchive;
-			if (!zipArchive.open(zipPath)) { return; }
+			if (!zipArchive.open(zipPath)) { return false; }
 			if (zipArchive.openFile(imageFileName))
 			{
-				size_t imageSize = zipArchive.getFileLength();
-				s_imageBuffer.resize(imageSize);
-				zipArchive.readFile(s_imageBuffer.data(), imageSize);
+				imageBuffer.resize(zipArchive.getFileLength());
+				imageBuffer.resize(zipArchive.readFile(imageBuffer.data(), imageBuffer.size()));
 				zipArchive.closeFile();
-
-				Image* image = TFE_Image::loadFromMemory((u8*)s_imageBuffer.data(), imageSize);
-				if (image)
-				{
-					TextureGpu* gpuImage = TFE_RenderBackend::createTexture(image->width, image->height, image->data, MAG_FILTER_LINEAR);
-					poster->texture = gpuImage;
-					poster->width = image->width;
-					poster->height = image->height;
-
-					delete[] image->data;
-					delete image;
-				}
 			}
 			zipArchive.close();
 		}
@@ -904,35 +1188,57 @@ namespace TFE_FrontEndUI
 			char imagePath[TFE_MAX_PATH];
 			sprintf(imagePath, "%s%s", baseDir, imageFileName);
 
-			Image* image = TFE_Image::get(imagePath);
-			if (image)
+			FileStream imageFile;
+			if (imageFile.open(imagePath, Stream::MODE_READ))
 			{
-				TextureGpu* gpuImage = TFE_RenderBackend::createTexture(image->width, image->height, image->data, MAG_FILTER_LINEAR);
-				poster->texture = gpuImage;
-				poster->width = image->width;
-				poster->height = image->height;
+				imageBuffer.resize(imageFile.getSize());
+				imageBuffer.resize(imageFile.readBuffer(imageBuffer.data(), 1, (u32)imageBuffer.size()));
+				imageFile.close();
 			}
 		}
+		if (imageBuffer.empty()) { return false; }
+
+		Image* image = TFE_Image::loadFromMemory(imageBuffer.data(), imageBuffer.size());
+		if (!image) { return false; }
+
+		poster->width = image->width;
+		poster->height = image->height;
+		poster->pixels.assign(image->data, image->data + image->width * image->height);
+		fitPoster(poster);
+
+		delete[] image->data;
+		delete image;
+		return true;
 	}
 
-	void extractPosterFromMod(const char* baseDir, const char* archiveFileName, EditorTexture* poster)
+	// Read a whole file through a handle, so the shared base archives can be read from any thread.
+	bool readArchiveFile(Archive* archive, const char* fileName, std::vector<u8>& buffer)
+	{
+		if (!archive) { return false; }
+		const u32 index = archive->findFile(fileName);
+		if (index == INVALID_FILE) { return false; }
+		ArchiveFile* handle = archive->openHandle(index);
+		if (!handle) { return false; }
+
+		buffer.resize(archive->getLength(handle));
+		buffer.resize(archive->read(handle, buffer.data(), 0, buffer.size()));
+		archive->closeHandle(handle);
+		return !buffer.empty();
+	}
+
+	bool extractPosterFromMod(const char* baseDir, const char* archiveFileName, ModPoster* poster)
 	{
 		// Extract a "poster", if possible, from the GOB file.
-		// And then save it as a JPG in /ProgramData/TheForceEngine/ModPosters/NAME.jpg
-		char modPath[TFE_MAX_PATH], srcPath[TFE_MAX_PATH], srcPathTex[TFE_MAX_PATH];
+		char modPath[TFE_MAX_PATH];
 		sprintf(modPath, "%s%s", baseDir, archiveFileName);
-		sprintf(srcPath, "%s%s", TFE_Paths::getPath(PATH_SOURCE_DATA), "DARK.GOB");
-		sprintf(srcPathTex, "%s%s", TFE_Paths::getPath(PATH_SOURCE_DATA), "TEXTURES.GOB");
 
+		GobArchive gobArchive;
 		GobMemoryArchive gobMemArchive;
 		const size_t len = strlen(archiveFileName);
 		const char* archiveExt = &archiveFileName[len - 3];
 		Archive* archiveMod = nullptr;
-		bool archiveIsGob = true;
 		if (strcasecmp(archiveExt, "zip") == 0)
 		{
-			archiveIsGob = false;
-
 			ZipArchive zipArchive;
 			if (zipArchive.open(modPath))
 			{
@@ -959,9 +1265,9 @@ namespace TFE_FrontEndUI
 					const size_t lengthRead = zipArchive.readFile(buffer, bufferLen);
 					zipArchive.closeFile();
 
-					if (lengthRead > 0)
+					// The memory archive takes ownership of the buffer.
+					if (lengthRead > 0 && gobMemArchive.open(buffer, bufferLen))
 					{
-						gobMemArchive.open(buffer, bufferLen);
 						archiveMod = &gobMemArchive;
 					}
 					else
@@ -973,55 +1279,38 @@ namespace TFE_FrontEndUI
 				zipArchive.close();
 			}
 		}
-		else
+		else if (gobArchive.open(modPath))
 		{
-			archiveMod = Archive::getArchive(ARCHIVE_GOB, archiveFileName, modPath);
+			archiveMod = &gobArchive;
 		}
-		Archive* archiveTex = Archive::getArchive(ARCHIVE_GOB, "TEXTURES.GOB", srcPathTex);
-		Archive* archiveBase = Archive::getArchive(ARCHIVE_GOB, "DARK.GOB", srcPath);
 
-		s_readBuffer[0].clear();
-		s_readBuffer[1].clear();
-		if (archiveMod || archiveBase)
+		std::vector<u8> bitmap, palette;
+		if (!readArchiveFile(archiveMod, "wait.bm", bitmap))
 		{
-			if (archiveMod && archiveMod->fileExists("wait.bm") && archiveMod->openFile("wait.bm"))
-			{
-				s_readBuffer[0].resize(archiveMod->getFileLength());
-				archiveMod->readFile(s_readBuffer[0].data(), archiveMod->getFileLength());
-				archiveMod->closeFile();
-			}
-			else if (archiveTex->openFile("wait.bm"))
-			{
-				s_readBuffer[0].resize(archiveTex->getFileLength());
-				archiveTex->readFile(s_readBuffer[0].data(), archiveTex->getFileLength());
-				archiveTex->closeFile();
-			}
-
-			if (archiveMod && archiveMod->fileExists("wait.pal") && archiveMod->openFile("wait.pal"))
-			{
-				s_readBuffer[1].resize(archiveMod->getFileLength());
-				archiveMod->readFile(s_readBuffer[1].data(), archiveMod->getFileLength());
-				archiveMod->closeFile();
-			}
-			else if (archiveBase->openFile("wait.pal"))
-			{
-				s_readBuffer[1].resize(archiveBase->getFileLength());
-				archiveBase->readFile(s_readBuffer[1].data(), archiveBase->getFileLength());
-				archiveBase->closeFile();
-			}
+			readArchiveFile(s_texturesArchive, "wait.bm", bitmap);
 		}
-
-		if (!s_readBuffer[0].empty() && !s_readBuffer[1].empty())
+		if (!readArchiveFile(archiveMod, "wait.pal", palette))
 		{
-			TextureData* imageData = bitmap_loadFromMemory(s_readBuffer[0].data(), s_readBuffer[0].size(), 1);
-			u32 palette[256];
-			convertPalette(s_readBuffer[1].data(), palette);
-			createTexture(imageData, palette, poster, MAG_FILTER_LINEAR);
+			readArchiveFile(s_darkArchive, "wait.pal", palette);
 		}
-
-		if (archiveMod && archiveIsGob)
+		if (bitmap.empty() || palette.size() < 768)
 		{
-			Archive::freeArchive(archiveMod);
+			return false;
 		}
+
+		TextureData* imageData = bitmap_loadFromMemory(bitmap.data(), bitmap.size(), 1);
+		if (!imageData) { return false; }
+
+		u32 colors[256];
+		convertPalette(palette.data(), colors);
+		poster->width = imageData->width;
+		poster->height = imageData->height;
+		poster->pixels.resize(poster->width * poster->height);
+		convertDfTextureToTrueColor(imageData, colors, poster->pixels.data());
+		fitPoster(poster);
+
+		free(imageData->image);
+		free(imageData);
+		return true;
 	}
-}
\ No newline at end of file
+}
@@ -16,6 +16,171 @@
 namespace TFE_ProfilerView
 {
 	static bool s_open = false;
+	static s32 s_captureFrameCount = 60;
+	static s32 s_captureIndex = 0;
+	static bool s_showLastFrame = false;
+
+	// Paths that have not been called for a while are hidden.
+	static const f64 c_minVisibleTime = 0.000001;
+	static const f32 c_flameRowHeight = 18.0f;
+
+	void getNodeTimes(const TFE_NodeInfo& info, f64* total, f64* self)
+	{
+		*total = s_showLastFrame ? info.timeTotal : info.timeTotalAve;
+		*self  = s_showLastFrame ? info.timeSelf  : info.timeSelfAve;
+	}
+
+	bool isNodeVisible(const TFE_NodeInfo& info)
+	{
+		return info.callCount > 0 || info.timeTotalAve >= c_minVisibleTime;
+	}
+
+	void drawTreeNode(u32 node)
+	{
+		TFE_NodeInfo info;
+		if (!TFE_Profiler::getNodeInfo(node, &info) || !isNodeVisible(info)) { return; }
+
+		f64 total, self;
+		getNodeTimes(info, &total, &self);
+
+		ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow;
+		if (info.child == NULL_NODE) { flags |= ImGuiTreeNodeFlags_Leaf; }
+		if (info.depth == 0) { flags |= ImGuiTreeNodeFlags_DefaultOpen; }
+
+		const bool open = ImGui::TreeNodeEx((void*)(uintptr_t)node, flags, "%s", info.name);
+		if (info.zoneId != NULL_ZONE && ImGui::IsItemHovered())
+		{
+			ImGui::SetTooltip("%s:%u", info.func, info.lineNumber);
+		}
+		ImGui::NextColumn();
+		ImGui::Text("%0.3fms", total * 1000.0);  ImGui::NextColumn();
+		ImGui::Text("%0.3fms", self * 1000.0);   ImGui::NextColumn();
+		if (info.depth > 0) { ImGui::Text("%6.02f%%", info.fractOfParentAve * 100.0); }
+		ImGui::NextColumn();
+		if (info.depth > 0) { ImGui::Text("%u", info.callCount); }
+		ImGui::NextColumn();
+
+		if (open)
+		{
+			for (u32 child = info.child; child != NULL_NODE;)
+			{
+				drawTreeNode(child);
+				TFE_NodeInfo childInfo;
+				TFE_Profiler::getNodeInfo(child, &childInfo);
+				child = childInfo.sibling;
+			}
+			ImGui::TreePop();
+		}
+	}
+
+	void drawCallTree()
+	{
+		ImGui::Columns(5, "##CallTree");
+		ImGui::SetColumnWidth(0, 360.0f);
+		ImGui::Text("Zone");  ImGui::NextColumn();
+		ImGui::Text("Total"); ImGui::NextColumn();
+		ImGui::Text("Self");  ImGui::NextColumn();
+		ImGui::Text("Parent"); ImGui::NextColumn();
+		ImGui::Text("Calls"); ImGui::NextColumn();
+		ImGui::Separator();
+
+		const u32 threadCount = TFE_Profiler::getThreadCount();
+		for (u32 t = 0; t < threadCount; t++)
+		{
+			const u32 root = TFE_Profiler::getThreadRootNode(t);
+			if (root != NULL_NODE) { drawTreeNode(root); }
+		}
+		ImGui::Columns(1);
+	}
+
+	u32 getFlameDepth(u32 node)
+	{
+		TFE_NodeInfo info;
+		if (!TFE_Profiler::getNodeInfo(node, &info) || !isNodeVisible(info)) { return 0; }
+
+		u32 depth = 1;
+		for (u32 child = info.child; child != NULL_NODE;)
+		{
+			depth = std::max(depth, getFlameDepth(child) + 1);
+			TFE_NodeInfo childInfo;
+			TFE_Profiler::getNodeInfo(child, &childInfo);
+			child = childInfo.sibling;
+		}
+		return depth;
+	}
+
+	// Each zone is drawn as a bar whose width is its total time, with its children placed left to right underneath.
+	void drawFlameNode(ImDrawList* drawList, u32 node, ImVec2 pos, f32 scale)
+	{
+		TFE_NodeInfo info;
+		if (!TFE_Profiler::getNodeInfo(node, &info) || !isNodeVisible(info)) { return; }
+
+		f64 total, self;
+		getNodeTimes(info, &total, &self);
+		const f32 width = f32(total) * scale;
+		if (width < 1.0f) { return; }
+
+		const ImVec2 p0(pos.x, pos.y);
+		const ImVec2 p1(pos.x + width, pos.y + c_flameRowHeight - 1.0f);
+		const f32 hue = info.zoneId == NULL_ZONE ? 0.0f : f32((info.zoneId * 37) % 64) / 64.0f;
+		const ImU32 color = info.zoneId == NULL_ZONE ? IM_COL32(96, 96, 96, 255) : (ImU32)ImColor::HSV(hue, 0.5f, 0.75f);
+		drawList->AddRectFilled(p0, p1, color);
+		drawList->AddRect(p0, p1, IM_COL32(0, 0, 0, 128));
+
+		drawList->PushClipRect(p0, p1, true);
+		drawList->AddText(ImVec2(p0.x + 3.0f, p0.y + 2.0f), IM_COL32_WHITE, info.name);
+		drawList->PopClipRect();
+
+		if (ImGui::IsMouseHoveringRect(p0, p1))
+		{
+			if (info.zoneId == NULL_ZONE) { ImGui::SetTooltip("%s\nTotal: %0.3fms", info.name, total * 1000.0); }
+			else { ImGui::SetTooltip("%s  [%s:%u]\nTotal: %0.3fms\nSelf: %0.3fms\nCalls: %u", info.name, info.func, info.lineNumber, total * 1000.0, self * 1000.0, info.callCount); }
+		}
+
+		ImVec2 childPos(pos.x, pos.y + c_flameRowHeight);
+		for (u32 child = info.child; child != NULL_NODE;)
+		{
+			TFE_NodeInfo childInfo;
+			TFE_Profiler::getNodeInfo(child, &childInfo);
+			drawFlameNode(drawList, child, childPos, scale);
+
+			f64 childTotal, childSelf;
+			getNodeTimes(childInfo, &childTotal, &childSelf);
+			childPos.x += f32(childTotal) * scale;
+			child = childInfo.sibling;
+		}
+	}
+
+	void drawFlameGraph()
+	{
+		// All threads share the same scale, so the full width is the longest of the frame and the thread times.
+		f64 maxTime = TFE_Profiler::getTimeInFrame();
+		const u32 threadCount = TFE_Profiler::getThreadCount();
+		for (u32 t = 0; t < threadCount; t++)
+		{
+			TFE_NodeInfo info;
+			if (!TFE_Profiler::getNodeInfo(TFE_Profiler::getThreadRootNode(t), &info)) { continue; }
+
+			f64 total, self;
+			getNodeTimes(info, &total, &self);
+			maxTime = std::max(maxTime, total);
+		}
+		if (maxTime <= 0.0) { return; }
+
+		const f32 width = std::max(ImGui::GetContentRegionAvail().x, 64.0f);
+		const f32 scale = width / f32(maxTime);
+		ImDrawList* drawList = ImGui::GetWindowDrawList();
+		for (u32 t = 0; t < threadCount; t++)
+		{
+			const u32 root = TFE_Profiler::getThreadRootNode(t);
+			const u32 depth = getFlameDepth(root);
+			if (!depth) { continue; }
+
+			drawFlameNode(drawList, root, ImGui::GetCursorScreenPos(), scale);
+			ImGui::Dummy(ImVec2(width, f32(depth) * c_flameRowHeight));
+			ImGui::Spacing();
+		}
+	}
 
 	bool init()
 	{
@@ -34,6 +199,32 @@ namespace TFE_ProfilerView
 		ImGui::SetNextWindowSize(ImVec2(800, 768));
 		ImGui::Begin("Profiler View", &s_open);
 
+		// Capture a trace from all threads, which can be opened with chrome://tracing or ui.perfetto.dev
+		ImGui::LabelText("##Label", "Trace Capture");
+		ImGui::Separator();
+		ImGui::Indent();
+		ImGui::SetNextItemWidth(128.0f);
+		ImGui::InputInt("Frames", &s_captureFrameCount);
+		s_captureFrameCount = std::max(1, std::min(s_captureFrameCount, 3600));
+		ImGui::SameLine();
+		if (TFE_Profiler::isCapturing())
+		{
+			ImGui::Text("Capturing...");
+		}
+		else if (ImGui::Button("Capture Trace"))
+		{
+			char fileName[TFE_MAX_PATH];
+			char capturePath[TFE_MAX_PATH];
+			sprintf(fileName, "tfe_trace_%d.json", s_captureIndex);
+			TFE_Paths::appendPath(PATH_USER_DOCUMENTS, fileName, capturePath);
+			if (TFE_Profiler::beginCapture(u32(s_captureFrameCount), capturePath))
+			{
+				s_captureIndex++;
+			}
+		}
+		ImGui::Unindent();
+		ImGui::Spacing();
+
 		ImGui::LabelText("##Label", "Counters");
 		ImGui::Separator();
 		u32 counterCount = TFE_Profiler::getCounterCount();
@@ -56,30 +247,24 @@ namespace TFE_ProfilerView
 		ImGui::Text("%0.3fms", timeInFrame * 1000.0);
 		ImGui::SameLine(f32(128));
 		ImGui::Text("Frame");
+		ImGui::SameLine(f32(256));
+		ImGui::Checkbox("Show Last Frame", &s_showLastFrame);
 
-		u32 zoneCount = TFE_Profiler::getZoneCount();
-		ImGui::Indent();
-		for (u32 z = 0; z < zoneCount; z++)
+		if (ImGui::BeginTabBar("##ZoneViews"))
 		{
-			TFE_ZoneInfo info;
-			TFE_Profiler::getZoneInfo(z, &info);
-
-			for (u32 l = 0; l < info.level; l++)
+			if (ImGui::BeginTabItem("Call Tree"))
 			{
-				ImGui::Indent();
+				drawCallTree();
+				ImGui::EndTabItem();
 			}
-
-			ImGui::Text("%0.3fms (%6.03f%%)", info.timeInZoneAve * 1000.0, info.fractOfParentAve * 100.0);
-			ImGui::SameLine(f32(180 + 16*(info.level + 1)));
-			ImGui::Text("%s  [%s:%u]", info.name, info.func, info.lineNumber);
-
-			for (u32 l = 0; l < info.level; l++)
+			if (ImGui::BeginTabItem("Flame Graph"))
 			{
-				ImGui::Unindent();
+				drawFlameGraph();
+				ImGui::EndTabItem();
 			}
+			ImGui::EndTabBar();
 		}
 		ImGui::Unindent();
-		ImGui::Unindent();
 
 		ImGui::End();
 	}
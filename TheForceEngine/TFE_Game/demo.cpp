@@ -0,0 +1,456 @@
+#include "demo.h"
+#include <TFE_Input/input.h>
+#include <TFE_System/system.h>
+#include <TFE_FileSystem/bufferedstream.h>
+#include <TFE_DarkForces/random.h>
+#include <TFE_DarkForces/time.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace TFE_Input;
+
+namespace TFE_Demo
+{
+	enum DemoConst
+	{
+		DEMO_MAGIC = 0x44454654,	// "TFED"
+	};
+
+	enum DemoVersion
+	{
+		DVER_INIT = 1,
+		DVER_CUR = DVER_INIT
+	};
+
+	enum DemoMode
+	{
+		DEMO_NONE = 0,
+		DEMO_RECORD,
+		DEMO_PLAYBACK,
+	};
+
+	struct DemoHeader
+	{
+		u32 magic;
+		u32 version;
+		s32 startupGame;
+		u32 randomSeed;
+		u32 frameCount;
+	};
+
+	struct DemoFrame
+	{
+		// Frame timing, as returned by TFE_System.
+		f64 dt;
+		f64 dtRaw;
+		f64 time;
+		InputState input;
+		// Simulation state at the end of the frame, used to detect desyncs.
+		u32 curTick;
+		u32 randomSeed;
+	};
+
+	struct TimeStats
+	{
+		f64 minTime;
+		f64 avgTime;
+		f64 p99Time;
+		f64 maxTime;
+	};
+
+	static DemoMode s_mode = DEMO_NONE;
+	// Frames are written and read one field at a time.
+	static BufferedStream s_file;
+	static DemoHeader s_header;
+	static DemoFrame s_frame;
+	static u32 s_frameIndex = 0;
+	static s32 s_desyncFrame = -1;
+	// Seeking, the location of the current frame in the file and the position to continue from on the next frame.
+	static u32 s_frameLoc = 0;
+	static u32 s_seekFrame = 0;
+	static bool s_frameSeeking = false;
+	static bool s_hasPendingPos = false;
+	static DemoPosition s_pendingPos;
+	static char s_demoFilename[TFE_MAX_PATH];
+	static char s_reportFilename[TFE_MAX_PATH];
+
+	// Timing, in seconds.
+	static u64 s_frameStart = 0;
+	static u64 s_simStart = 0;
+	static f64 s_simTime = 0.0;
+	static std::vector<f64> s_frameTimes;
+	static std::vector<f64> s_simTimes;
+
+	void writeIndexList(const u8* values, u32 count);
+	void readIndexList(u8* values, u32 count);
+	void writeFrame();
+	bool readFrame();
+	void computeStats(std::vector<f64>& times, TimeStats* stats);
+	void writeReport();
+
+	bool beginRecording(const char* filename, s32 startupGame)
+	{
+		if (s_mode != DEMO_NONE) { return false; }
+		if (!s_file.open(filename, Stream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_ERROR, "Demo", "Cannot open demo '%s' for writing.", filename);
+			return false;
+		}
+		if (startupGame < 0)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Demo", "No startup game was given, menu interaction before the game starts cannot be played back.");
+		}
+
+		s_header.magic = DEMO_MAGIC;
+		s_header.version = DVER_CUR;
+		s_header.startupGame = startupGame;
+		s_header.randomSeed = TFE_DarkForces::random_getSeed();
+		s_header.frameCount = 0;
+		s_file.writeBuffer(&s_header, sizeof(DemoHeader));
+
+		strcpy(s_demoFilename, filename);
+		s_frameIndex = 0;
+		s_mode = DEMO_RECORD;
+		TFE_System::logWrite(LOG_MSG, "Demo", "Recording demo '%s'.", filename);
+		return true;
+	}
+
+	bool beginPlayback(const char* filename, const char* reportFilename, s32* startupGame)
+	{
+		if (s_mode != DEMO_NONE) { return false; }
+		if (!s_file.open(filename, Stream::MODE_READ))
+		{
+			TFE_System::logWrite(LOG_ERROR, "Demo", "Cannot open demo '%s'.", filename);
+			return false;
+		}
+
+		s_file.readBuffer(&s_header, sizeof(DemoHeader));
+		if (s_header.magic != DEMO_MAGIC || s_header.version > DVER_CUR)
+		{
+			TFE_System::logWrite(LOG_ERROR, "Demo", "'%s' is not a valid demo or is from a newer version.", filename);
+			s_file.close();
+			return false;
+		}
+		if (s_header.frameCount == 0)
+		{
+			TFE_System::logWrite(LOG_ERROR, "Demo", "Demo '%s' is empty or was not closed properly.", filename);
+			s_file.close();
+			return false;
+		}
+
+		strcpy(s_demoFilename, filename);
+		if (reportFilename) { strcpy(s_reportFilename, reportFilename); }
+		else { sprintf(s_reportFilename, "%s.json", filename); }
+
+		*startupGame = s_header.startupGame;
+		TFE_DarkForces::random_seed(s_header.randomSeed);
+		TFE_System::setTimeOverride(true);
+
+		s_frameIndex = 0;
+		s_desyncFrame = -1;
+		s_seekFrame = 0;
+		s_frameSeeking = false;
+		s_hasPendingPos = false;
+		s_frameStart = 0;
+		s_frameTimes.clear();
+		s_simTimes.clear();
+		s_frameTimes.reserve(s_header.frameCount);
+		s_simTimes.reserve(s_header.frameCount);
+
+		s_mode = DEMO_PLAYBACK;
+		TFE_System::logWrite(LOG_MSG, "Demo", "Playing back demo '%s', %u frames.", filename, s_header.frameCount);
+		return true;
+	}
+
+	void end()
+	{
+		if (s_mode == DEMO_RECORD)
+		{
+			// Patch the frame count now that it is known.
+			s_header.frameCount = s_frameIndex;
+			s_file.seek(0);
+			s_file.writeBuffer(&s_header, sizeof(DemoHeader));
+			s_file.close();
+			TFE_System::logWrite(LOG_MSG, "Demo", "Recorded %u frames to '%s'.", s_frameIndex, s_demoFilename);
+		}
+		else if (s_mode == DEMO_PLAYBACK)
+		{
+			s_file.close();
+			TFE_System::setTimeOverride(false);
+			writeReport();
+		}
+		s_mode = DEMO_NONE;
+	}
+
+	bool isRecording()
+	{
+		return s_mode == DEMO_RECORD;
+	}
+
+	bool isPlaying()
+	{
+		return s_mode == DEMO_PLAYBACK;
+	}
+
+	u32 getFrameIndex()
+	{
+		return s_frameIndex;
+	}
+
+	u32 getFrameCount()
+	{
+		return s_mode == DEMO_PLAYBACK ? s_header.frameCount : s_frameIndex;
+	}
+
+	void getPosition(DemoPosition* pos)
+	{
+		pos->frameIndex = s_frameIndex;
+		pos->fileLoc = s_frameLoc;
+	}
+
+	void setPosition(const DemoPosition* pos)
+	{
+		if (s_mode != DEMO_PLAYBACK) { return; }
+		s_pendingPos = *pos;
+		s_hasPendingPos = true;
+	}
+
+	void seekTo(u32 frame)
+	{
+		if (s_mode != DEMO_PLAYBACK) { return; }
+		s_seekFrame = std::min(frame, s_header.frameCount);
+	}
+
+	bool isSeeking()
+	{
+		return s_mode == DEMO_PLAYBACK && s_frameIndex < s_seekFrame;
+	}
+
+	bool beginFrame()
+	{
+		if (s_mode == DEMO_RECORD)
+		{
+			getState(&s_frame.input);
+		}
+		else if (s_mode == DEMO_PLAYBACK)
+		{
+			// The time for the previous frame covers everything between two calls, including rendering.
+			const u64 curTime = TFE_System::getCurrentTimeInTicks();
+			if (s_frameStart && !s_frameSeeking)
+			{
+				s_frameTimes.push_back(TFE_System::convertFromTicksToSeconds(curTime - s_frameStart));
+			}
+			s_frameStart = curTime;
+
+			// A snapshot is being restored this frame, so continue from the frame it was captured on.
+			if (s_hasPendingPos)
+			{
+				s_hasPendingPos = false;
+				s_file.seek(s32(s_pendingPos.fileLoc));
+				s_frameIndex = s_pendingPos.frameIndex;
+			}
+			s_frameSeeking = s_frameIndex < s_seekFrame;
+			s_frameLoc = u32(s_file.getLoc());
+
+			if (s_frameIndex >= s_header.frameCount || !readFrame())
+			{
+				return false;
+			}
+			setState(&s_frame.input);
+			TFE_System::setFrameTime(s_frame.dt, s_frame.dtRaw, s_frame.time);
+		}
+		s_simTime = 0.0;
+		return true;
+	}
+
+	void recordFrameTime()
+	{
+		if (s_mode != DEMO_RECORD) { return; }
+		s_frame.dt = TFE_System::getDeltaTime();
+		s_frame.dtRaw = TFE_System::getDeltaTimeRaw();
+		s_frame.time = TFE_System::getTime();
+	}
+
+	void beginSimulation()
+	{
+		s_simStart = TFE_System::getCurrentTimeInTicks();
+	}
+
+	void endFrame()
+	{
+		if (s_mode == DEMO_NONE) { return; }
+		if (s_simStart)
+		{
+			s_simTime = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - s_simStart);
+			s_simStart = 0;
+		}
+
+		const u32 curTick = TFE_DarkForces::s_curTick;
+		const u32 randomSeed = TFE_DarkForces::random_getSeed();
+		if (s_mode == DEMO_RECORD)
+		{
+			s_frame.curTick = curTick;
+			s_frame.randomSeed = randomSeed;
+			writeFrame();
+		}
+		else
+		{
+			if (s_desyncFrame < 0 && (curTick != s_frame.curTick || randomSeed != s_frame.randomSeed))
+			{
+				TFE_System::logWrite(LOG_ERROR, "Demo", "Playback desync at frame %u: tick %u / %u, seed 0x%08x / 0x%08x.",
+					s_frameIndex, curTick, s_frame.curTick, randomSeed, s_frame.randomSeed);
+				s_desyncFrame = s32(s_frameIndex);
+			}
+			if (!s_frameSeeking) { s_simTimes.push_back(s_simTime); }
+		}
+		s_frameIndex++;
+	}
+
+	////////////////////////////////////////////
+	// Internal
+	////////////////////////////////////////////
+	// Most keys are up at any given time, so only the indices of the set values are stored.
+	void writeIndexList(const u8* values, u32 count)
+	{
+		u16 setCount = 0;
+		for (u32 i = 0; i < count; i++)
+		{
+			if (values[i]) { setCount++; }
+		}
+		s_file.write(&setCount);
+		for (u32 i = 0; i < count; i++)
+		{
+			if (!values[i]) { continue; }
+			const u16 index = u16(i);
+			s_file.write(&index);
+		}
+	}
+
+	void readIndexList(u8* values, u32 count)
+	{
+		memset(values, 0, count);
+
+		u16 setCount;
+		s_file.read(&setCount);
+		for (u32 i = 0; i < setCount; i++)
+		{
+			u16 index;
+			s_file.read(&index);
+			if (index < count) { values[index] = 1; }
+		}
+	}
+
+	void writeFrame()
+	{
+		const InputState* input = &s_frame.input;
+		s_file.write(&s_frame.dt);
+		s_file.write(&s_frame.dtRaw);
+		s_file.write(&s_frame.time);
+
+		s_file.write(input->axis, AXIS_COUNT);
+		s_file.write(input->buttonDown, CONTROLLER_BUTTON_COUNT);
+		s_file.write(input->buttonPressed, CONTROLLER_BUTTON_COUNT);
+		writeIndexList(input->keyDown, KEY_COUNT);
+		writeIndexList(input->keyPressed, KEY_COUNT);
+		writeIndexList(input->bufferedKey, KEY_COUNT);
+		const u8 textLen = u8(strnlen(input->bufferedText, INPUT_BUFFERED_TEXT_LEN - 1));
+		s_file.write(&textLen);
+		s_file.writeBuffer(input->bufferedText, textLen);
+		s_file.write(input->mouseDown, MBUTTON_COUNT);
+		s_file.write(input->mousePressed, MBUTTON_COUNT);
+		s_file.write(input->mouseWheel, 2);
+		s_file.write(input->mouseMove, 2);
+		s_file.write(input->mouseMoveAccum, 2);
+		s_file.write(input->mousePos, 2);
+		s_file.write(&input->relativeMode);
+
+		s_file.write(&s_frame.curTick);
+		s_file.write(&s_frame.randomSeed);
+	}
+
+	bool readFrame()
+	{
+		InputState* input = &s_frame.input;
+		s_file.read(&s_frame.dt);
+		s_file.read(&s_frame.dtRaw);
+		s_file.read(&s_frame.time);
+
+		s_file.read(input->axis, AXIS_COUNT);
+		s_file.read(input->buttonDown, CONTROLLER_BUTTON_COUNT);
+		s_file.read(input->buttonPressed, CONTROLLER_BUTTON_COUNT);
+		readIndexList(input->keyDown, KEY_COUNT);
+		readIndexList(input->keyPressed, KEY_COUNT);
+		readIndexList(input->bufferedKey, KEY_COUNT);
+		u8 textLen;
+		s_file.read(&textLen);
+		memset(input->bufferedText, 0, INPUT_BUFFERED_TEXT_LEN);
+		s_file.readBuffer(input->bufferedText, std::min(u32(textLen), u32(INPUT_BUFFERED_TEXT_LEN - 1)));
+		s_file.read(input->mouseDown, MBUTTON_COUNT);
+		s_file.read(input->mousePressed, MBUTTON_COUNT);
+		s_file.read(input->mouseWheel, 2);
+		s_file.read(input->mouseMove, 2);
+		s_file.read(input->mouseMoveAccum, 2);
+		s_file.read(input->mousePos, 2);
+		s_file.read(&input->relativeMode);
+
+		s_file.read(&s_frame.curTick);
+		s_file.read(&s_frame.randomSeed);
+
+		if (s_file.getLoc() > s_file.getSize())
+		{
+			TFE_System::logWrite(LOG_ERROR, "Demo", "Demo '%s' is truncated at frame %u.", s_demoFilename, s_frameIndex);
+			return false;
+		}
+		return true;
+	}
+
+	void computeStats(std::vector<f64>& times, TimeStats* stats)
+	{
+		memset(stats, 0, sizeof(TimeStats));
+		if (times.empty()) { return; }
+
+		std::sort(times.begin(), times.end());
+		const size_t count = times.size();
+		f64 total = 0.0;
+		for (size_t i = 0; i < count; i++)
+		{
+			total += times[i];
+		}
+		const size_t p99Index = std::min(count - 1, size_t(ceil(f64(count) * 0.99)) - 1);
+
+		// Report in milliseconds.
+		stats->minTime = times[0] * 1000.0;
+		stats->avgTime = total * 1000.0 / f64(count);
+		stats->p99Time = times[p99Index] * 1000.0;
+		stats->maxTime = times[count - 1] * 1000.0;
+	}
+
+	void writeReport()
+	{
+		TimeStats frameStats, simStats;
+		computeStats(s_frameTimes, &frameStats);
+		computeStats(s_simTimes, &simStats);
+
+		TFE_System::logWrite(LOG_MSG, "Demo", "Timedemo finished: %u frames, frame ms min %.3f avg %.3f p99 %.3f, sim ms min %.3f avg %.3f p99 %.3f.",
+			s_frameIndex, frameStats.minTime, frameStats.avgTime, frameStats.p99Time, simStats.minTime, simStats.avgTime, simStats.p99Time);
+
+		FileStream report;
+		if (!report.open(s_reportFilename, Stream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_ERROR, "Demo", "Cannot write the timedemo report '%s'.", s_reportFilename);
+			return;
+		}
+		report.writeString("{\n");
+		report.writeString("  \"frames\": %u,\n", s_frameIndex);
+		report.writeString("  \"completed\": %s,\n", s_frameIndex >= s_header.frameCount ? "true" : "false");
+		report.writeString("  \"desyncFrame\": %d,\n", s_desyncFrame);
+		report.writeString("  \"frameTimeMs\": { \"min\": %.4f, \"avg\": %.4f, \"p99\": %.4f, \"max\": %.4f },\n",
+			frameStats.minTime, frameStats.avgTime, frameStats.p99Time, frameStats.maxTime);
+		report.writeString("  \"simTimeMs\": { \"min\": %.4f, \"avg\": %.4f, \"p99\": %.4f, \"max\": %.4f }\n",
+			simStats.minTime, simStats.avgTime, simStats.p99Time, simStats.maxTime);
+		report.writeString("}\n");
+		report.close();
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Demo recording and timedemo playback.
+// A demo stores the raw input state and frame timing for every frame,
+// so that playing it back reproduces the same simulation exactly.
+// During playback frames run as fast as possible and the frame and
+// simulation times are written out as a report once the demo ends.
+// Playback can seek: rewind snapshots store the demo position, so a
+// snapshot can be restored and the frames after it played again.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+namespace TFE_Demo
+{
+	// The frame about to be simulated and where it starts in the demo file.
+	struct DemoPosition
+	{
+		u32 frameIndex;
+		u32 fileLoc;
+	};
+
+	// Start recording to 'filename', the startup game is stored in the demo header.
+	bool beginRecording(const char* filename, s32 startupGame);
+	// Start playing back 'filename', the timing report is written to 'reportFilename'
+	// or to '<filename>.json' if it is null. Returns the startup game stored in the demo.
+	bool beginPlayback(const char* filename, const char* reportFilename, s32* startupGame);
+	// Finish recording or playback, writing the report if playing back.
+	void end();
+
+	bool isRecording();
+	bool isPlaying();
+	u32  getFrameIndex();
+	u32  getFrameCount();
+
+	// Playback only. The position of the current frame, stored with rewind snapshots.
+	void getPosition(DemoPosition* pos);
+	// Continue playback from 'pos' on the next frame, when the matching snapshot is restored.
+	void setPosition(const DemoPosition* pos);
+	// Play frames until 'frame' is reached, frames played while seeking are left out of the report.
+	void seekTo(u32 frame);
+	bool isSeeking();
+
+	// Called once input has been gathered from the OS, before TFE_System::update().
+	// During playback the input and frame time are replaced with the recorded values.
+	// Returns false once the end of the demo has been reached.
+	bool beginFrame();
+	// Called after TFE_System::update() to store the frame time while recording.
+	void recordFrameTime();
+	// Bracket the game simulation for the timing report.
+	void beginSimulation();
+	// Called after the game update to store or verify the simulation state.
+	void endFrame();
+}
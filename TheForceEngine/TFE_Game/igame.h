@@ -27,6 +27,8 @@ struct IGame
 	virtual void restartMusic() = 0;
 	virtual void loopGame() {};
 	virtual bool serializeGameState(Stream* stream, const char* filename, bool writeState) { return false; };
+	// Write the game state for the rewind buffer, games can reuse data from the previous capture to make this cheaper.
+	virtual bool captureGameState(Stream* stream) { return serializeGameState(stream, nullptr, true); }
 	virtual bool canSave() { return false; }
 	virtual bool isPaused() { return false; }
 	virtual void getLevelName(char* name) {};
@@ -0,0 +1,297 @@
+#include "rewind.h"
+#include "saveSystem.h"
+#include "demo.h"
+#include <TFE_FileSystem/memorystream.h>
+#include <TFE_FrontEndUI/console.h>
+#include <TFE_System/system.h>
+#include <TFE_System/profiler.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace TFE_Rewind
+{
+	enum RewindConst
+	{
+		REWIND_MAX_SNAPSHOTS = 1024,
+	};
+
+	struct Snapshot
+	{
+		MemoryStream state;
+		f64 time;		// Play time when the snapshot was captured.
+		TFE_Demo::DemoPosition demo;	// Demo frame the snapshot was captured on, when playing back a demo.
+	};
+
+	static IGame* s_game = nullptr;
+	// Ring buffer, the buffers are kept and reused once it wraps around.
+	static std::vector<Snapshot*> s_snapshots;
+	static u32 s_head = 0;		// Next slot to write.
+	static u32 s_count = 0;
+
+	// Play time in seconds, which does not advance while the game is paused.
+	static f64 s_time = 0.0;
+	static f64 s_lastCapture = 0.0;
+	static f32 s_rewindSeconds = 0.0f;
+	static s32 s_seekFrame = -1;
+	static Snapshot* s_restore = nullptr;
+
+	// Capture cost.
+	static f64 s_captureTime = 0.0;
+	static f64 s_maxCaptureTime = 0.0;
+	static u32 s_captureCount = 0;
+
+	// Console variables.
+	static f32 s_interval = 2.0f;
+	static f32 s_demoInterval = 1.0f;
+	static f32 s_length = 60.0f;
+
+	void console_rewind(const ConsoleArgList& args);
+	void console_demoSeek(const ConsoleArgList& args);
+	void console_rewindInfo(const ConsoleArgList& args);
+
+	void init()
+	{
+		CVAR_FLOAT(s_interval, "g_rewindInterval", CVFLAG_DO_NOT_SERIALIZE, "Seconds of play between rewind snapshots, 0 disables rewind.");
+		CVAR_FLOAT(s_demoInterval, "g_demoSeekInterval", CVFLAG_DO_NOT_SERIALIZE, "Seconds of demo playback between snapshots, used to seek backwards. 0 disables seeking backwards.");
+		CVAR_FLOAT(s_length, "g_rewindLength", CVFLAG_DO_NOT_SERIALIZE, "Seconds of play kept in the rewind buffer.");
+		CCMD("rewind", console_rewind, 0, "rewind(seconds) - restore the game state from 'seconds' ago, 5 seconds by default.");
+		CCMD("demoSeek", console_demoSeek, 1, "demoSeek(frame) - continue demo playback from 'frame', earlier frames are reached through the rewind buffer.");
+		CCMD("rewindInfo", console_rewindInfo, 0, "Display the contents of the rewind buffer and the cost of capturing snapshots.");
+	}
+
+	void destroy()
+	{
+		clear();
+		for (size_t i = 0; i < s_snapshots.size(); i++)
+		{
+			delete s_snapshots[i];
+		}
+		s_snapshots.clear();
+		s_game = nullptr;
+	}
+
+	void clear()
+	{
+		s_head = 0;
+		s_count = 0;
+		s_time = 0.0;
+		s_lastCapture = 0.0;
+		s_rewindSeconds = 0.0f;
+		s_seekFrame = -1;
+		s_restore = nullptr;
+	}
+
+	void setCurrentGame(IGame* game)
+	{
+		s_game = game;
+		if (!s_restore)
+		{
+			clear();
+		}
+	}
+
+	// Index 0 is the newest snapshot.
+	Snapshot* getSnapshot(u32 index)
+	{
+		const u32 capacity = (u32)s_snapshots.size();
+		return s_snapshots[(s_head + capacity - 1 - index) % capacity];
+	}
+
+	// Demo playback uses its own interval, so seeking works without enabling rewind during play.
+	f32 getInterval()
+	{
+		return TFE_Demo::isPlaying() ? s_demoInterval : s_interval;
+	}
+
+	u32 getCapacity()
+	{
+		const f32 interval = getInterval();
+		// Rewinding while recording would leave the recorded input out of step with the game.
+		if (interval <= 0.0f || s_length <= 0.0f || TFE_Demo::isRecording()) { return 0; }
+		const u32 count = u32(ceilf(s_length / interval));
+		return std::max(1u, std::min(count, u32(REWIND_MAX_SNAPSHOTS)));
+	}
+
+	void capture()
+	{
+		TFE_ZONE("Rewind Capture");
+		const u32 capacity = getCapacity();
+		if (capacity != s_snapshots.size())
+		{
+			// The settings changed, start over.
+			for (size_t i = capacity; i < s_snapshots.size(); i++)
+			{
+				delete s_snapshots[i];
+			}
+			s_snapshots.resize(capacity, nullptr);
+			s_head = 0;
+			s_count = 0;
+		}
+		if (!s_snapshots[s_head])
+		{
+			s_snapshots[s_head] = new Snapshot();
+		}
+
+		const u64 start = TFE_System::getCurrentTimeInTicks();
+		Snapshot* snapshot = s_snapshots[s_head];
+		snapshot->time = s_time;
+		TFE_Demo::getPosition(&snapshot->demo);
+		snapshot->state.clear();
+		snapshot->state.open(Stream::MODE_WRITE);
+		const bool ret = s_game->captureGameState(&snapshot->state);
+		snapshot->state.close();
+		s_lastCapture = s_time;
+		if (!ret) { return; }
+
+		s_head = (s_head + 1) % capacity;
+		s_count = std::min(s_count + 1, capacity);
+
+		const f64 captureTime = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - start);
+		s_captureTime += captureTime;
+		s_maxCaptureTime = std::max(s_maxCaptureTime, captureTime);
+		s_captureCount++;
+	}
+
+	void restore(u32 index)
+	{
+		s_restore = getSnapshot(index);
+
+		// Play continues from the restored snapshot, so the later ones are discarded.
+		const u32 capacity = (u32)s_snapshots.size();
+		s_head = (s_head + capacity - index) % capacity;
+		s_count -= index;
+		s_time = s_restore->time;
+		s_lastCapture = s_restore->time;
+
+		// Demo playback continues from the frame the snapshot was captured on.
+		TFE_Demo::setPosition(&s_restore->demo);
+		TFE_SaveSystem::postLoadRequest(c_rewindStateName);
+	}
+
+	void rewind()
+	{
+		const f64 target = s_time - f64(s_rewindSeconds);
+		s_rewindSeconds = 0.0f;
+		if (!s_count)
+		{
+			TFE_Console::addToHistory("The rewind buffer is empty.");
+			return;
+		}
+
+		// Use the newest snapshot at or before the target time, or the oldest if the buffer does not reach back that far.
+		u32 index = 0;
+		while (index + 1 < s_count && getSnapshot(index)->time > target)
+		{
+			index++;
+		}
+		restore(index);
+	}
+
+	void seekDemo()
+	{
+		const u32 target = std::min(u32(s_seekFrame), TFE_Demo::getFrameCount());
+		s_seekFrame = -1;
+
+		// Later frames are played until the target is reached, earlier frames start from the newest snapshot before the target.
+		if (target < TFE_Demo::getFrameIndex())
+		{
+			if (!s_count)
+			{
+				TFE_Console::addToHistory("There are no demo snapshots to seek back to.");
+				return;
+			}
+			u32 index = 0;
+			while (index + 1 < s_count && getSnapshot(index)->demo.frameIndex > target)
+			{
+				index++;
+			}
+			if (getSnapshot(index)->demo.frameIndex > target)
+			{
+				TFE_Console::addToHistory("The rewind buffer does not reach back that far, seeking to the oldest snapshot.");
+			}
+			restore(index);
+		}
+		TFE_Demo::seekTo(target);
+	}
+
+	void update()
+	{
+		if (!s_game || s_restore) { return; }
+		if (s_seekFrame >= 0)
+		{
+			seekDemo();
+			return;
+		}
+		if (s_rewindSeconds > 0.0f)
+		{
+			rewind();
+			return;
+		}
+		if (!getCapacity() || !s_game->canSave() || s_game->isPaused()) { return; }
+
+		s_time += TFE_System::getDeltaTime();
+		if (s_count && s_time - s_lastCapture < f64(getInterval())) { return; }
+		capture();
+	}
+
+	void requestRewind(f32 seconds)
+	{
+		if (TFE_Demo::isRecording())
+		{
+			TFE_Console::addToHistory("Rewind is disabled while recording a demo.");
+			return;
+		}
+		s_rewindSeconds = std::max(seconds, 0.001f);
+	}
+
+	void requestDemoSeek(u32 frame)
+	{
+		if (!TFE_Demo::isPlaying())
+		{
+			TFE_Console::addToHistory("No demo is being played back.");
+			return;
+		}
+		s_seekFrame = s32(std::min(frame, u32(INT32_MAX)));
+	}
+
+	Stream* getRestoreState()
+	{
+		if (!s_restore) { return nullptr; }
+
+		Stream* state = &s_restore->state;
+		s_restore->state.open(Stream::MODE_READ);
+		s_restore = nullptr;
+		return state;
+	}
+
+	void console_rewind(const ConsoleArgList& args)
+	{
+		const f32 seconds = args.size() > 1 ? f32(atof(args[1].c_str())) : 5.0f;
+		requestRewind(seconds);
+	}
+
+	void console_demoSeek(const ConsoleArgList& args)
+	{
+		if (args.size() < 2) { return; }
+		requestDemoSeek(u32(strtoul(args[1].c_str(), nullptr, 10)));
+	}
+
+	void console_rewindInfo(const ConsoleArgList& args)
+	{
+		size_t memory = 0;
+		for (size_t i = 0; i < s_snapshots.size(); i++)
+		{
+			if (s_snapshots[i]) { memory += s_snapshots[i]->state.getSize(); }
+		}
+		const f64 span = s_count ? s_time - getSnapshot(s_count - 1)->time : 0.0;
+		const f64 avgTime = s_captureCount ? s_captureTime / f64(s_captureCount) : 0.0;
+
+		char msg[256];
+		sprintf(msg, "Rewind: %u / %u snapshots covering %0.1f seconds, %zu bytes.", s_count, getCapacity(), span, memory);
+		TFE_Console::addToHistory(msg);
+		sprintf(msg, "Capture: %u snapshots, avg %0.3fms, max %0.3fms.", s_captureCount, avgTime * 1000.0, s_maxCaptureTime * 1000.0);
+		TFE_Console::addToHistory(msg);
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Rewind buffer
+// Snapshots of the game state are captured at a fixed interval of
+// play time and kept in a ring buffer in memory, so the game can be
+// rewound by a number of seconds without going through save files.
+// Snapshots use the same serialization as save games and are restored
+// through the regular load path. Captures are incremental where the
+// game supports it (IGame::captureGameState()), Dark Forces copies the
+// data of sectors that did not change since the previous snapshot.
+//
+// While a demo is played back, snapshots are captured every
+// g_demoSeekInterval seconds together with the demo position, which is
+// used to seek: seeking forward plays the frames in between, seeking
+// backwards restores the newest snapshot before the target first.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_FileSystem/stream.h>
+#include "igame.h"
+
+namespace TFE_Rewind
+{
+	// Passed to TFE_SaveSystem::loadGame() to restore the requested snapshot.
+	static const char* c_rewindStateName = "<rewind>";
+
+	void init();
+	void destroy();
+
+	// Called when a game is created, the buffer is cleared unless the game is being restored from it.
+	void setCurrentGame(IGame* game);
+	// Called once per frame before the game update, captures snapshots and handles rewind requests.
+	void update();
+	void clear();
+
+	// Rewind by 'seconds' of play time, the game is restored on the next update.
+	void requestRewind(f32 seconds);
+	// Continue demo playback from 'frame', the game is restored on the next update if it is behind the current frame.
+	void requestDemoSeek(u32 frame);
+	// The snapshot being restored, read by TFE_SaveSystem::loadGame().
+	Stream* getRestoreState();
+}
@@ -1,13 +1,21 @@
 #include "saveSystem.h"
+#include "rewind.h"
 #include <TFE_Input/inputMapping.h>
 #include <TFE_System/system.h>
 #include <TFE_Settings/gameSourceData.h>
+#include <TFE_FileSystem/bufferedstream.h>
+#include <TFE_FileSystem/deflatestream.h>
 #include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/filewriterAsync.h>
+#include <TFE_FileSystem/memorystream.h>
+#include <TFE_FrontEndUI/console.h>
+#include <TFE_System/jobSystem.h>
 
 #include <TFE_RenderBackend/renderBackend.h>
 #include <TFE_Asset/imageAsset.h>
 #include <cassert>
 #include <cstring>
+#include <unordered_map>
 
 using namespace TFE_Input;
 
@@ -23,36 +31,107 @@ namespace TFE_SaveSystem
 	enum SaveMasterVersion
 	{
 		SVER_INIT = 1,
-		SVER_CUR = SVER_INIT
+		SVER_COMPRESSION,	// The game state may be compressed.
+		SVER_CUR = SVER_COMPRESSION
 	};
 
+	// Only the game state is compressed, the header and screenshot are left as is so the save directory can be read quickly.
+	enum SaveCompression
+	{
+		SCOMPRESS_NONE = 0,
+		SCOMPRESS_DEFLATE,
+		SCOMPRESS_COUNT
+	};
+
+	// The save index caches the headers of every save in the directory, so the save/load menu
+	// does not need to open each file. Entries are validated against the file time and size.
+	enum SaveIndexVersion
+	{
+		SINDEX_INIT = 1,
+		SINDEX_CUR = SINDEX_INIT
+	};
+	static const char* c_saveIndexName = "saveIndex.dat";
+	static const u32 c_saveIndexMagic = 0x58444953;	// "SIDX"
+	static const u32 c_saveIndexMaxCount = 65536;
+
+	// Decoded thumbnails, the least recently requested are freed first.
+	static const size_t c_maxThumbnails = 16;
+
 	static SaveRequest s_req = SF_REQ_NONE;
 	static char s_reqFilename[TFE_MAX_PATH];
 	static char s_reqSavename[TFE_MAX_PATH];
 	static char s_gameSavePath[TFE_MAX_PATH];
 	static IGame* s_game = nullptr;
 	static s32 s_saveDelay = 0;
+	// Console variable.
+	static bool s_compressSaves = true;
 
-	static u32* s_imageBuffer[2] = { nullptr, nullptr };
-	static size_t s_imageBufferSize[2] = { 0 };
 
-	void saveHeader(Stream* stream, const char* saveName)
+	// A save in flight. The game state and the screen are captured on the main thread,
+	// the screenshot is scaled and encoded and the file written on the file writer thread.
+	struct SaveJob
 	{
-		// Generate a screenshot.
-		DisplayInfo displayInfo;
-		TFE_RenderBackend::getDisplayInfo(&displayInfo);
-		size_t size = displayInfo.width * displayInfo.height * 4;
-		if (size > s_imageBufferSize[0])
+		s32 screenWidth;
+		s32 screenHeight;
+		std::vector<u32> screen;
+		MemoryStream info;		// Save info, written before the screenshot.
+		MemoryStream state;		// Serialized game state, written after the screenshot.
+		bool compress;			// Compress the game state before writing it.
+	};
+
+	struct SaveThumbnail
+	{
+		char filePath[TFE_MAX_PATH];
+		u64 fileTime;
+		u64 fileSize;
+		u32 imageOffset;
+		u32 imageSize;
+		std::vector<u32> image;
+		bool valid;
+		std::atomic<bool> ready;
+	};
+	static std::vector<SaveThumbnail*> s_thumbnails;
+	static atomic_s32 s_thumbnailJobs(0);
+
+	// The serialized game state of the most recent quicksave is kept in memory, so quickloading
+	// does not wait for the save to be written and then read it back from disk. The state is
+	// still restored field by field: the game is rebuilt on load and the memory regions point
+	// at state outside of them, so the regions cannot be snapshotted and restored wholesale.
+	static MemoryStream s_quickSaveState;
+	static char s_quickSavePath[TFE_MAX_PATH] = { 0 };
+
+	// Iterations of the serialization benchmark to run on the next update.
+	static s32 s_benchmarkIterations = 0;
+
+	// Records the size of every field written, so loading can be replayed field by field.
+	class FieldLogStream : public MemoryStream
+	{
+	public:
+		std::vector<u32> fieldSizes;
+
+		void writeBuffer(const void* ptr, u32 size, u32 count = 1) override
 		{
-			s_imageBuffer[0] = (u32*)realloc(s_imageBuffer[0], size);
-			s_imageBufferSize[0] = size;
+			fieldSizes.push_back(size * count);
+			MemoryStream::writeBuffer(ptr, size, count);
 		}
-		TFE_RenderBackend::captureScreenToMemory(s_imageBuffer[0]);
+	};
 
-		// Scale and crop the image to fit inside 426 x 240 (widescreen).
-		s64 scale = SAVE_IMAGE_HEIGHT * 65536 / displayInfo.height;
-		s64 invScale = displayInfo.height * 65536 / SAVE_IMAGE_HEIGHT;
-		s32 scaledWidth = s32((displayInfo.width * scale) >> 16ll);
+	void captureScreenshot(SaveJob* job)
+	{
+		DisplayInfo displayInfo;
+		TFE_RenderBackend::getDisplayInfo(&displayInfo);
+		job->screenWidth  = displayInfo.width;
+		job->screenHeight = displayInfo.height;
+		job->screen.resize(displayInfo.width * displayInfo.height);
+		TFE_RenderBackend::captureScreenToMemory(job->screen.data());
+	}
+
+	// Scale and crop the image to fit inside 426 x 240 (widescreen).
+	void scaleScreenshot(const u32* screen, s32 width, s32 height, u32* dst)
+	{
+		s64 scale = SAVE_IMAGE_HEIGHT * 65536 / height;
+		s64 invScale = height * 65536 / SAVE_IMAGE_HEIGHT;
+		s32 scaledWidth = s32((width * scale) >> 16ll);
 		s32 newWidth = SAVE_IMAGE_WIDTH, newHeight = SAVE_IMAGE_HEIGHT;
 
 		s32 dstOffset = 0;
@@ -66,34 +145,25 @@ namespace TFE_SaveSystem
 			srcOffset = (scaledWidth - newWidth) / 2;
 			srcOffset = srcOffset * invScale;
 		}
-
-		size_t newSize = newWidth * newHeight * 4;
-		if (newSize > s_imageBufferSize[1])
-		{
-			s_imageBuffer[1] = (u32*)realloc(s_imageBuffer[1], newSize);
-			s_imageBufferSize[1] = newSize;
-		}
-
-		const u32 *src;
-		u32* dst = s_imageBuffer[1];
 		memset(dst, 0, newWidth * newHeight * 4);
 
+		const u32 *src;
 		s64 u  = srcOffset, v = 0;
 		s64 du = invScale, dv = invScale;
 		for (s32 y = 0; y < newHeight; y++, v += dv, dst += newWidth)
 		{
 			u = srcOffset;
-			src = &s_imageBuffer[0][(v >> 16ll) * displayInfo.width];
+			src = &screen[(v >> 16ll) * width];
 			for (s32 x = dstOffset; x < newWidth - dstOffset; x++, u += du)
 			{
 				dst[x] = src[u >> 16ll];
 			}
 		}
+	}
 
-		// Save to memory.
-		u8* png;
-		u32 pngSize = (u32)TFE_Image::writeImageToMemory(png, newWidth, newHeight, s_imageBuffer[1]);
-
+	// Everything in the header except for the screenshot, which is encoded later.
+	void saveHeaderInfo(Stream* stream, const char* saveName)
+	{
 		// Master version.
 		u32 version = SVER_CUR;
 		stream->write(&version);
@@ -125,13 +195,57 @@ namespace TFE_SaveSystem
 		len = (u8)strlen(modList);
 		stream->write(&len);
 		stream->writeBuffer(modList, len);
+	}
+
+	void buildSaveFile(std::vector<u8>& file, void* buildData)
+	{
+		SaveJob* job = (SaveJob*)buildData;
+
+		std::vector<u32> image(SAVE_IMAGE_WIDTH * SAVE_IMAGE_HEIGHT);
+		scaleScreenshot(job->screen.data(), job->screenWidth, job->screenHeight, image.data());
+		std::vector<u8> png;
+		const u32 pngSize = (u32)TFE_Image::writeImageToMemory(png, SAVE_IMAGE_WIDTH, SAVE_IMAGE_HEIGHT, image.data());
 
-		// Image.
-		stream->write(&pngSize);
-		stream->writeBuffer(png, pngSize);
+		u32 compression = SCOMPRESS_NONE;
+		MemoryStream* state = &job->state;
+		MemoryStream compressedState;
+		if (job->compress)
+		{
+			compressedState.open(Stream::MODE_WRITE);
+			DeflateStream deflate;
+			if (deflate.open(&compressedState, Stream::MODE_WRITE))
+			{
+				deflate.writeBuffer(job->state.data(), (u32)job->state.getSize());
+				if (deflate.close())
+				{
+					compression = SCOMPRESS_DEFLATE;
+					state = &compressedState;
+				}
+			}
+			compressedState.close();
+		}
+
+		// Assemble the file: save info, image, compression and then the game state.
+		const size_t infoSize = job->info.getSize();
+		const size_t stateSize = state->getSize();
+		file.resize(infoSize + sizeof(u32) + pngSize + sizeof(u32) + stateSize);
+		u8* out = file.data();
+		memcpy(out, job->info.data(), infoSize);  out += infoSize;
+		memcpy(out, &pngSize, sizeof(u32));        out += sizeof(u32);
+		memcpy(out, png.data(), pngSize);          out += pngSize;
+		memcpy(out, &compression, sizeof(u32));    out += sizeof(u32);
+		memcpy(out, state->data(), stateSize);
+		delete job;
+	}
+
+	// Saves are written in the background, wait for them before reading save files.
+	void waitForSaves()
+	{
+		FileWriterAsync::waitForWrites();
 	}
 
-	void loadHeader(Stream* stream, SaveHeader* header, const char* fileName)
+	// The stream is left at the start of the game state, which is compressed as described by 'compression'.
+	void loadHeader(Stream* stream, SaveHeader* header, const char* fileName, u32* compression = nullptr)
 	{
 		// Master version.
 		u32 version;
@@ -166,49 +280,391 @@ namespace TFE_SaveSystem
 		stream->readBuffer(header->modNames, len);
 		header->modNames[len] = 0;
 
-		// Image, re-use buffer 0 for the PNG.
-		u32 pngSize;
+		// Image, only its location is recorded here. It is decoded by getSaveImage() when needed.
+		u32 pngSize = 0;
 		stream->read(&pngSize);
-		if (pngSize > s_imageBufferSize[0])
+		header->imageOffset = (u32)stream->getLoc();
+		header->imageSize = pngSize;
+		stream->seek(pngSize, Stream::ORIGIN_CURRENT);
+
+		// Game state compression.
+		u32 stateCompression = SCOMPRESS_NONE;
+		if (version >= SVER_COMPRESSION)
 		{
-			s_imageBuffer[0] = (u32*)realloc(s_imageBuffer[0], pngSize);
-			s_imageBufferSize[0] = pngSize;
+			stream->read(&stateCompression);
 		}
-		stream->readBuffer(s_imageBuffer[0], pngSize);
+		if (compression)
+		{
+			*compression = stateCompression;
+		}
+	}
 
-		Image image = { 0 };
-		image.data = header->imageData;
-		TFE_Image::readImageFromMemory(&image, pngSize, s_imageBuffer[0]);
-		assert(image.width == SAVE_IMAGE_WIDTH && image.height == SAVE_IMAGE_HEIGHT);
+	void writeIndexString(Stream* stream, const char* str)
+	{
+		size_t strLen = strlen(str);
+		if (strLen > 255) { strLen = 255; }
+		u8 len = (u8)strLen;
+		stream->write(&len);
+		stream->writeBuffer(str, len);
+	}
+
+	bool readIndexString(Stream* stream, char* str, size_t bufferSize)
+	{
+		u8 len = 0;
+		stream->read(&len);
+		if (len >= bufferSize || stream->readBuffer(str, len) != len)
+		{
+			return false;
+		}
+		str[len] = 0;
+		return true;
+	}
+
+	// Returns false if the index is missing, out of date or damaged, in which case every save is read directly.
+	bool readSaveIndex(std::vector<SaveHeader>& index)
+	{
+		char indexPath[TFE_MAX_PATH];
+		sprintf(indexPath, "%s%s", s_gameSavePath, c_saveIndexName);
+
+		BufferedStream stream;
+		if (!stream.open(indexPath, Stream::MODE_READ))
+		{
+			return false;
+		}
+
+		u32 magic = 0, version = 0, count = 0;
+		stream.read(&magic);
+		stream.read(&version);
+		stream.read(&count);
+		bool valid = magic == c_saveIndexMagic && version == SINDEX_CUR && count <= c_saveIndexMaxCount;
+		if (valid)
+		{
+			index.resize(count);
+			for (u32 i = 0; i < count && valid; i++)
+			{
+				SaveHeader* header = &index[i];
+				valid = readIndexString(&stream, header->fileName, sizeof(header->fileName)) &&
+						readIndexString(&stream, header->saveName, sizeof(header->saveName)) &&
+						readIndexString(&stream, header->dateTime, sizeof(header->dateTime)) &&
+						readIndexString(&stream, header->levelName, sizeof(header->levelName)) &&
+						readIndexString(&stream, header->modNames, sizeof(header->modNames));
+				stream.read(&header->fileTime);
+				stream.read(&header->fileSize);
+				stream.read(&header->imageOffset);
+				stream.read(&header->imageSize);
+			}
+			valid = valid && stream.getLoc() == stream.getSize();
+		}
+		stream.close();
+
+		if (!valid)
+		{
+			TFE_System::logWrite(LOG_WARNING, "SaveSystem", "The save index '%s' is invalid and will be rebuilt.", indexPath);
+			index.clear();
+		}
+		return valid;
+	}
+
+	void writeSaveIndex(const std::vector<SaveHeader>& dir)
+	{
+		char indexPath[TFE_MAX_PATH];
+		sprintf(indexPath, "%s%s", s_gameSavePath, c_saveIndexName);
+
+		MemoryStream stream;
+		stream.open(Stream::MODE_WRITE);
+		const u32 version = SINDEX_CUR;
+		const u32 count = (u32)dir.size();
+		stream.write(&c_saveIndexMagic);
+		stream.write(&version);
+		stream.write(&count);
+		for (u32 i = 0; i < count; i++)
+		{
+			const SaveHeader* header = &dir[i];
+			writeIndexString(&stream, header->fileName);
+			writeIndexString(&stream, header->saveName);
+			writeIndexString(&stream, header->dateTime);
+			writeIndexString(&stream, header->levelName);
+			writeIndexString(&stream, header->modNames);
+			stream.write(&header->fileTime);
+			stream.write(&header->fileSize);
+			stream.write(&header->imageOffset);
+			stream.write(&header->imageSize);
+		}
+		stream.close();
+
+		FileWriterAsync::writeFileToDisk(indexPath, (u8*)stream.data(), stream.getSize());
 	}
 
 	void populateSaveDirectory(std::vector<SaveHeader>& dir)
 	{
+		waitForSaves();
 		dir.clear();
 		FileList fileList;
 		FileUtil::readDirectory(s_gameSavePath, "tfe", fileList);
 		size_t saveCount = fileList.size();
 		dir.resize(saveCount);
 
+		std::vector<SaveHeader> index;
+		bool indexChanged = !readSaveIndex(index) || index.size() != saveCount;
+		std::unordered_map<std::string, const SaveHeader*> indexMap;
+		for (size_t i = 0; i < index.size(); i++)
+		{
+			indexMap[index[i].fileName] = &index[i];
+		}
+
 		const std::string* filenames = fileList.data();
 		SaveHeader* headers = dir.data();
 		for (size_t i = 0; i < saveCount; i++)
 		{
-			loadGameHeader(filenames[i].c_str(), &headers[i]);
+			char filePath[TFE_MAX_PATH];
+			sprintf(filePath, "%s%s", s_gameSavePath, filenames[i].c_str());
+			const u64 fileTime = FileUtil::getModifiedTime(filePath);
+			const u64 fileSize = FileUtil::getFileSize(filePath);
+
+			std::unordered_map<std::string, const SaveHeader*>::iterator iEntry = indexMap.find(filenames[i]);
+			if (iEntry != indexMap.end() && iEntry->second->fileTime == fileTime && iEntry->second->fileSize == fileSize)
+			{
+				headers[i] = *iEntry->second;
+			}
+			else
+			{
+				loadGameHeader(filenames[i].c_str(), &headers[i]);
+				indexChanged = true;
+			}
+		}
+
+		if (indexChanged)
+		{
+			writeSaveIndex(dir);
 		}
 	}
 
-	void init()
+	void decodeThumbnailJob(void* userData)
 	{
+		SaveThumbnail* thumbnail = (SaveThumbnail*)userData;
+
+		std::vector<u8> png(thumbnail->imageSize);
+		FileStream stream;
+		if (stream.open(thumbnail->filePath, Stream::MODE_READ))
+		{
+			stream.seek(thumbnail->imageOffset);
+			const bool read = stream.readBuffer(png.data(), thumbnail->imageSize) == thumbnail->imageSize;
+			stream.close();
+
+			if (read)
+			{
+				thumbnail->image.resize(SAVE_IMAGE_WIDTH * SAVE_IMAGE_HEIGHT);
+				Image image = { 0 };
+				image.data = thumbnail->image.data();
+				thumbnail->valid = TFE_Image::readImageFromMemory(&image, png.size(), (const u32*)png.data(), thumbnail->image.size()) &&
+					image.width == SAVE_IMAGE_WIDTH && image.height == SAVE_IMAGE_HEIGHT;
+			}
+		}
+		thumbnail->ready = true;
 	}
 
-	void destroy()
+	// Free the least recently requested thumbnails, thumbnails still being decoded are kept.
+	void trimThumbnails(size_t maxCount)
+	{
+		for (size_t i = 0; i < s_thumbnails.size() && s_thumbnails.size() > maxCount;)
+		{
+			if (s_thumbnails[i]->ready)
+			{
+				delete s_thumbnails[i];
+				s_thumbnails.erase(s_thumbnails.begin() + i);
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+
+	const u32* getSaveImage(const SaveHeader* header)
 	{
-		for (s32 i = 0; i < 2; i++)
+		char filePath[TFE_MAX_PATH];
+		sprintf(filePath, "%s%s", s_gameSavePath, header->fileName);
+
+		const size_t count = s_thumbnails.size();
+		for (size_t i = 0; i < count; i++)
+		{
+			SaveThumbnail* thumbnail = s_thumbnails[i];
+			if (strcmp(thumbnail->filePath, filePath) == 0 && thumbnail->fileTime == header->fileTime &&
+				thumbnail->fileSize == header->fileSize && thumbnail->imageOffset == header->imageOffset)
+			{
+				// Move to the back, so it is freed last.
+				s_thumbnails.erase(s_thumbnails.begin() + i);
+				s_thumbnails.push_back(thumbnail);
+				return (thumbnail->ready && thumbnail->valid) ? thumbnail->image.data() : nullptr;
+			}
+		}
+		if (!header->imageSize)
 		{
-			free(s_imageBuffer[i]);
-			s_imageBufferSize[i] = 0;
+			return nullptr;
 		}
+
+		trimThumbnails(c_maxThumbnails - 1);
+		SaveThumbnail* thumbnail = new SaveThumbnail();
+		strcpy(thumbnail->filePath, filePath);
+		thumbnail->fileTime = header->fileTime;
+		thumbnail->fileSize = header->fileSize;
+		thumbnail->imageOffset = header->imageOffset;
+		thumbnail->imageSize = header->imageSize;
+		thumbnail->valid = false;
+		thumbnail->ready = false;
+		s_thumbnails.push_back(thumbnail);
+
+		TFE_Jobs::addJob(decodeThumbnailJob, thumbnail, &s_thumbnailJobs);
+		return nullptr;
+	}
+
+	void reportBenchmark(const char* name, u64 ticks, s32 iterations, size_t bytes, size_t fields)
+	{
+		const f64 seconds = TFE_System::convertFromTicksToSeconds(ticks) / f64(iterations);
+		char msg[256];
+		sprintf(msg, "%-24s %9.3fms %9.1f MB/s %9.2f M fields/s", name, seconds * 1000.0,
+			f64(bytes) / (seconds * 1024.0 * 1024.0), f64(fields) / (seconds * 1000000.0));
+		TFE_Console::addToHistory(msg);
+		TFE_System::logWrite(LOG_MSG, "SaveSystem", "%s", msg);
+	}
+
+	// Saving is timed by serializing the running game, loading by reading the same fields back
+	// from the file. Actually restoring the game state would also reload the level each time.
+	void runSerializationBenchmark(s32 iterations)
+	{
+		FieldLogStream fieldLog;
+		fieldLog.open(Stream::MODE_WRITE);
+		s_game->serializeGameState(&fieldLog, nullptr, true);
+		fieldLog.close();
+
+		const size_t bytes = fieldLog.getSize();
+		const size_t fields = fieldLog.fieldSizes.size();
+		u32 maxFieldSize = 0;
+		for (size_t f = 0; f < fields; f++)
+		{
+			maxFieldSize = std::max(maxFieldSize, fieldLog.fieldSizes[f]);
+		}
+		std::vector<u8> fieldBuffer(maxFieldSize);
+
+		char msg[256];
+		sprintf(msg, "Serialization benchmark: %zu bytes, %zu fields, %d iterations.", bytes, fields, iterations);
+		TFE_Console::addToHistory(msg);
+
+		char filePath[TFE_MAX_PATH];
+		sprintf(filePath, "%sserializationBenchmark.tmp", s_gameSavePath);
+
+		// Save.
+		u64 start = TFE_System::getCurrentTimeInTicks();
+		for (s32 i = 0; i < iterations; i++)
+		{
+			MemoryStream stream;
+			stream.open(Stream::MODE_WRITE);
+			s_game->serializeGameState(&stream, nullptr, true);
+			stream.close();
+		}
+		reportBenchmark("Save to MemoryStream", TFE_System::getCurrentTimeInTicks() - start, iterations, bytes, fields);
+
+		start = TFE_System::getCurrentTimeInTicks();
+		for (s32 i = 0; i < iterations; i++)
+		{
+			FileStream stream;
+			if (!stream.open(filePath, Stream::MODE_WRITE)) { break; }
+			s_game->serializeGameState(&stream, nullptr, true);
+			stream.close();
+		}
+		reportBenchmark("Save to FileStream", TFE_System::getCurrentTimeInTicks() - start, iterations, bytes, fields);
+
+		start = TFE_System::getCurrentTimeInTicks();
+		for (s32 i = 0; i < iterations; i++)
+		{
+			BufferedStream stream;
+			if (!stream.open(filePath, Stream::MODE_WRITE)) { break; }
+			s_game->serializeGameState(&stream, nullptr, true);
+			stream.close();
+		}
+		reportBenchmark("Save to BufferedStream", TFE_System::getCurrentTimeInTicks() - start, iterations, bytes, fields);
+
+		MemoryStream compressed;
+		start = TFE_System::getCurrentTimeInTicks();
+		for (s32 i = 0; i < iterations; i++)
+		{
+			compressed.clear();
+			compressed.open(Stream::MODE_WRITE);
+			DeflateStream stream;
+			if (!stream.open(&compressed, Stream::MODE_WRITE)) { break; }
+			s_game->serializeGameState(&stream, nullptr, true);
+			stream.close();
+			compressed.close();
+		}
+		reportBenchmark("Save to DeflateStream", TFE_System::getCurrentTimeInTicks() - start, iterations, bytes, fields);
+		sprintf(msg, "Compressed size: %zu bytes (%0.1f%%).", compressed.getSize(), bytes ? 100.0 * f64(compressed.getSize()) / f64(bytes) : 0.0);
+		TFE_Console::addToHistory(msg);
+
+		// Load.
+		start = TFE_System::getCurrentTimeInTicks();
+		for (s32 i = 0; i < iterations; i++)
+		{
+			FileStream stream;
+			if (!stream.open(filePath, Stream::MODE_READ)) { break; }
+			for (size_t f = 0; f < fields; f++)
+			{
+				stream.readBuffer(fieldBuffer.data(), fieldLog.fieldSizes[f]);
+			}
+			stream.close();
+		}
+		reportBenchmark("Load from FileStream", TFE_System::getCurrentTimeInTicks() - start, iterations, bytes, fields);
+
+		start = TFE_System::getCurrentTimeInTicks();
+		for (s32 i = 0; i < iterations; i++)
+		{
+			BufferedStream stream;
+			if (!stream.open(filePath, Stream::MODE_READ)) { break; }
+			for (size_t f = 0; f < fields; f++)
+			{
+				stream.readBuffer(fieldBuffer.data(), fieldLog.fieldSizes[f]);
+			}
+			stream.close();
+		}
+		reportBenchmark("Load from BufferedStream", TFE_System::getCurrentTimeInTicks() - start, iterations, bytes, fields);
+
+		start = TFE_System::getCurrentTimeInTicks();
+		for (s32 i = 0; i < iterations; i++)
+		{
+			compressed.open(Stream::MODE_READ);
+			DeflateStream stream;
+			if (!stream.open(&compressed, Stream::MODE_READ)) { break; }
+			for (size_t f = 0; f < fields; f++)
+			{
+				stream.readBuffer(fieldBuffer.data(), fieldLog.fieldSizes[f]);
+			}
+			stream.close();
+			compressed.close();
+		}
+		reportBenchmark("Load from DeflateStream", TFE_System::getCurrentTimeInTicks() - start, iterations, bytes, fields);
+
+		FileUtil::deleteFile(filePath);
+	}
+
+	void console_serializationBenchmark(const ConsoleArgList& args)
+	{
+		s_benchmarkIterations = args.size() > 1 ? std::max(1, atoi(args[1].c_str())) : 10;
+	}
+
+	void init()
+	{
+		TFE_Rewind::init();
+		CVAR_BOOL(s_compressSaves, "g_compressSaves", CVFLAG_NONE, "Compress the game state in save files, which makes them several times smaller.");
+		CCMD("serializationBenchmark", console_serializationBenchmark, 0, "serializationBenchmark(iterations) - times saving the current game state to memory, to disk with and without buffering and compressed, and reading it back. 10 iterations by default.");
+	}
+
+	void destroy()
+	{
+		waitForSaves();
+		TFE_Jobs::waitForCounter(&s_thumbnailJobs);
+		trimThumbnails(0);
+		s_quickSaveState.clear();
+		s_quickSavePath[0] = 0;
+		TFE_Rewind::destroy();
 	}
 
 	bool saveGame(const char* filename, const char* saveName)
@@ -216,29 +672,79 @@ namespace TFE_SaveSystem
 		char filePath[TFE_MAX_PATH];
 		sprintf(filePath, "%s%s", s_gameSavePath, filename);
 
-		bool ret = false;
-		FileStream stream;
-		if (stream.open(filePath, Stream::MODE_WRITE))
+		// Only capture the state here, so saving does not stall the frame.
+		SaveJob* job = new SaveJob();
+		job->compress = s_compressSaves;
+		captureScreenshot(job);
+
+		job->info.open(Stream::MODE_WRITE);
+		saveHeaderInfo(&job->info, saveName);
+		job->info.close();
+
+		job->state.open(Stream::MODE_WRITE);
+		const bool ret = s_game->serializeGameState(&job->state, filename, true);
+		job->state.close();
+		if (!ret)
 		{
-			saveHeader(&stream, saveName);
-			ret = s_game->serializeGameState(&stream, filename, true);
-			stream.close();
+			delete job;
+			return false;
 		}
-		return ret;
+
+		if (strcasecmp(filename, c_quickSaveName) == 0)
+		{
+			s_quickSaveState.load(job->state.getSize(), job->state.data());
+			strcpy(s_quickSavePath, filePath);
+		}
+		FileWriterAsync::writeFileToDisk(filePath, buildSaveFile, job);
+		return true;
 	}
 
 	bool loadGame(const char* filename)
 	{
+		if (strcmp(filename, TFE_Rewind::c_rewindStateName) == 0)
+		{
+			Stream* state = TFE_Rewind::getRestoreState();
+			return state && s_game->serializeGameState(state, nullptr, false);
+		}
+		// Loading a save starts a new timeline.
+		TFE_Rewind::clear();
+
 		char filePath[TFE_MAX_PATH];
 		sprintf(filePath, "%s%s", s_gameSavePath, filename);
+		if (s_quickSavePath[0] && strcmp(filePath, s_quickSavePath) == 0)
+		{
+			s_quickSaveState.open(Stream::MODE_READ);
+			const bool ret = s_game->serializeGameState(&s_quickSaveState, filename, false);
+			s_quickSaveState.close();
+			return ret;
+		}
+		waitForSaves();
 
 		bool ret = false;
-		FileStream stream;
+		BufferedStream stream;
 		if (stream.open(filePath, Stream::MODE_READ))
 		{
 			SaveHeader header;
-			loadHeader(&stream, &header, filename);
-			ret = s_game->serializeGameState(&stream, filename, false);
+			u32 compression = SCOMPRESS_NONE;
+			loadHeader(&stream, &header, filename, &compression);
+			if (compression == SCOMPRESS_DEFLATE)
+			{
+				// The game state is decompressed as it is read.
+				DeflateStream inflate;
+				if (inflate.open(&stream, Stream::MODE_READ))
+				{
+					ret = s_game->serializeGameState(&inflate, filename, false);
+					ret = inflate.close() && ret;
+				}
+			}
+			else if (compression == SCOMPRESS_NONE)
+			{
+				ret = s_game->serializeGameState(&stream, filename, false);
+			}
+			else
+			{
+				TFE_System::logWrite(LOG_ERROR, "SaveSystem", "Cannot load '%s', unknown compression type %u.", filePath, compression);
+			}
 			stream.close();
 		}
 		return ret;
@@ -248,6 +754,7 @@ namespace TFE_SaveSystem
 	{
 		char filePath[TFE_MAX_PATH];
 		sprintf(filePath, "%s%s", s_gameSavePath, filename);
+		waitForSaves();
 
 		bool ret = false;
 		FileStream stream;
@@ -256,6 +763,9 @@ namespace TFE_SaveSystem
 			loadHeader(&stream, header, filename);
 			strcpy(header->fileName, filename);
 			stream.close();
+
+			header->fileTime = FileUtil::getModifiedTime(filePath);
+			header->fileSize = FileUtil::getFileSize(filePath);
 			ret = true;
 		}
 		return ret;
@@ -331,11 +841,25 @@ namespace TFE_SaveSystem
 	{
 		s_game = game;
 		setCurrentGame(game->id);
+		TFE_Rewind::setCurrentGame(game);
 	}
 
 	void update()
 	{
 		if (!s_game) { return; }
+		TFE_Rewind::update();
+		if (s_benchmarkIterations)
+		{
+			if (s_game->canSave())
+			{
+				runSerializationBenchmark(s_benchmarkIterations);
+			}
+			else
+			{
+				TFE_Console::addToHistory("The serialization benchmark needs a level to be running.");
+			}
+			s_benchmarkIterations = 0;
+		}
 
 		static s32 lastState = 0;
 		const char* saveFilename = saveRequestFilename();
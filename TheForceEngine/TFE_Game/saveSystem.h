@@ -21,7 +21,12 @@ namespace TFE_SaveSystem
 		char dateTime[256];
 		char levelName[256];
 		char modNames[256];
-		u32  imageData[SAVE_IMAGE_WIDTH * SAVE_IMAGE_HEIGHT];
+		// Used to validate the save index entry.
+		u64  fileTime;
+		u64  fileSize;
+		// Location of the PNG thumbnail inside of the save file, it is only decoded on request.
+		u32  imageOffset;
+		u32  imageSize;
 	};
 
 	void init();
@@ -31,6 +36,7 @@ namespace TFE_SaveSystem
 	void setCurrentGame(GameID id);
 	void update();
 	bool saveGame(const char* filename, const char* saveName);
+	// Loading the quicksave uses the in-memory copy of the last quicksave made this session, if there is one.
 	bool loadGame(const char* filename);
 	// Load only the header for UI.
 	bool loadGameHeader(const char* filename, SaveHeader* header);
@@ -42,5 +48,8 @@ namespace TFE_SaveSystem
 
 	void getSaveFilenameFromIndex(s32 index, char* name);
 
+	// Headers are read from the save index and only the saves that changed since it was written are opened.
 	void populateSaveDirectory(std::vector<SaveHeader>& dir);
+	// Thumbnails are decoded in the background, this returns null until the image is ready.
+	const u32* getSaveImage(const SaveHeader* header);
 }
\ No newline at end of file
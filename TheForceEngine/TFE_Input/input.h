@@ -14,12 +14,37 @@
 
 typedef void(*KeyBindingCallback)(f32 value);
 
+#define INPUT_BUFFERED_TEXT_LEN 64
+
+// A full copy of the raw input state, used to record and play back input.
+struct InputState
+{
+	f32 axis[AXIS_COUNT];
+	u8  buttonDown[CONTROLLER_BUTTON_COUNT];
+	u8  buttonPressed[CONTROLLER_BUTTON_COUNT];
+	u8  keyDown[KEY_COUNT];
+	u8  keyPressed[KEY_COUNT];
+	u8  bufferedKey[KEY_COUNT];
+	char bufferedText[INPUT_BUFFERED_TEXT_LEN];
+	u8  mouseDown[MBUTTON_COUNT];
+	u8  mousePressed[MBUTTON_COUNT];
+	s32 mouseWheel[2];
+	s32 mouseMove[2];
+	s32 mouseMoveAccum[2];
+	s32 mousePos[2];
+	u8  relativeMode;
+};
+
 namespace TFE_Input
 {
 	// Call this once at the end of each frame
 	// to reset transient key events.
 	void endFrame();
 
+	// Copy the current input state or replace it wholesale.
+	void getState(InputState* state);
+	void setState(const InputState* state);
+
 	// Set, from the OS
 	void setAxis(Axis axis, f32 value);
 	void setButtonDown(Button button);
@@ -449,10 +449,11 @@ namespace TFE_Jedi
 		fixed16_16 z1 = origin.z + radius;
 
 		fixed16_16 secHeightThreshold = origin.y - COL_SEC_HEIGHT_OFFSET;
-		RSector* curSector = s_levelState.sectors;
 
-		for (u32 i = 0; i < s_levelState.sectorCount; i++, curSector++)
+		// Only sectors containing objects can pass, so empty sectors are skipped.
+		for (s32 i = sector_getNextOccupied(0); i >= 0; i = sector_getNextOccupied(i + 1))
 		{
+			RSector* curSector = &s_levelState.sectors[i];
 			///////////////////////////////////////////////
 			// These tests should only happen once I think,
 			// unless x0, x1, z0, z1 change over time.
@@ -524,9 +525,11 @@ namespace TFE_Jedi
 		const fixed16_16 z1 = origin.z + range;
 
 		const fixed16_16 secHeightThreshold = origin.y - COL_SEC_HEIGHT_OFFSET;
-		RSector* sector = s_levelState.sectors;
-		for (u32 i = 0; i < s_levelState.sectorCount; i++, sector++)
+		// Only sectors containing objects can pass, so empty sectors are skipped.
+		// The occupied list is checked as the loop goes, so objects added or removed by effectFunc() are handled the same way.
+		for (s32 i = sector_getNextOccupied(0); i >= 0; i = sector_getNextOccupied(i + 1))
 		{
+			RSector* sector = &s_levelState.sectors[i];
 			// Checks the start sector, should be pulled out of the loop.
 			if (x0 > startSector->boundsMax.x || x1 < startSector->boundsMin.x || z0 > startSector->boundsMax.z || z1 < startSector->boundsMin.z)
 			{
@@ -584,9 +587,11 @@ namespace TFE_Jedi
 		const fixed16_16 z1 = origin.z + range;
 
 		const fixed16_16 secHeightThreshold = origin.y - COL_SEC_HEIGHT_OFFSET;
-		RSector* sector = s_levelState.sectors;
-		for (u32 i = 0; i < s_levelState.sectorCount; i++, sector++)
+		// Only sectors containing objects can pass, so empty sectors are skipped.
+		// The occupied list is checked as the loop goes, so objects added or removed by effectFunc() are handled the same way.
+		for (s32 i = sector_getNextOccupied(0); i >= 0; i = sector_getNextOccupied(i + 1))
 		{
+			RSector* sector = &s_levelState.sectors[i];
 			// Checks the start sector, should be pulled out of the loop.
 			if (x0 > startSector->boundsMax.x || x1 < startSector->boundsMin.x || z0 > startSector->boundsMax.z || z1 < startSector->boundsMin.z)
 			{
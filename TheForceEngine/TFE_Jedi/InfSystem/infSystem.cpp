@@ -861,7 +861,7 @@ namespace TFE_Jedi
 			}
 
 			char id[256];
-			s32 argCount = sscanf(line, " %s %s %s %s %s %s %s", id, s_infArg0, s_infArg1, s_infArg2, s_infArg3, s_infArg4, s_infArgExtra);
+			s32 argCount = TFE_LineScanner::scan(line, " %s %s %s %s %s %s %s", id, s_infArg0, s_infArg1, s_infArg2, s_infArg3, s_infArg4, s_infArgExtra);
 			KEYWORD action = getKeywordIndex(id);
 			if (action == KW_UNKNOWN)
 			{
@@ -904,7 +904,7 @@ namespace TFE_Jedi
 			}
 			
 			char id[256];
-			argCount = sscanf(line, " %s %s %s %s %s", id, s_infArg0, s_infArg1, s_infArg2, s_infArg3);
+			argCount = TFE_LineScanner::scan(line, " %s %s %s %s %s", id, s_infArg0, s_infArg1, s_infArg2, s_infArg3);
 			KEYWORD itemId = getKeywordIndex(id);
 			assert(itemId != KW_UNKNOWN);
 
@@ -1022,7 +1022,7 @@ namespace TFE_Jedi
 			}
 
 			char name[256];
-			sscanf(line, " %s %s %s %s %s", name, s_infArg0, s_infArg1, s_infArg2, s_infArg3);
+			TFE_LineScanner::scan(line, " %s %s %s %s %s", name, s_infArg0, s_infArg1, s_infArg2, s_infArg3);
 			KEYWORD kw = getKeywordIndex(name);
 
 			if (kw == KW_TARGET)
@@ -1119,7 +1119,7 @@ namespace TFE_Jedi
 			}
 
 			char id[256];
-			argCount = sscanf(line, " %s %s %s %s %s", id, s_infArg0, s_infArg1, s_infArg2, s_infArg3);
+			argCount = TFE_LineScanner::scan(line, " %s %s %s %s %s", id, s_infArg0, s_infArg1, s_infArg2, s_infArg3);
 			KEYWORD itemId = getKeywordIndex(id);
 			if (itemId == KW_UNKNOWN)
 			{
@@ -1249,7 +1249,7 @@ namespace TFE_Jedi
 		}
 
 		f32 version;
-		if (sscanf(line, "INF %f", &version) != 1)
+		if (TFE_LineScanner::scan(line, "INF %f", &version) != 1)
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadINF", "Cannot read INF version.");
 			return JFALSE;
@@ -1271,7 +1271,7 @@ namespace TFE_Jedi
 				return JFALSE;
 			}
 
-			if (sscanf(line, "ITEMS %d", &itemCount) == 1)
+			if (TFE_LineScanner::scan(line, "ITEMS %d", &itemCount) == 1)
 			{
 				break;
 			}
@@ -1299,7 +1299,7 @@ namespace TFE_Jedi
 			}
 
 			char item[256], name[256];
-			while (sscanf(line, " ITEM: %s NAME: %s NUM: %d", item, name, &wallNum) < 1)
+			while (TFE_LineScanner::scan(line, " ITEM: %s NAME: %s NUM: %d", item, name, &wallNum) < 1)
 			{
 				line = parser.readLine(bufferPos);
 				if (!line)
@@ -1321,7 +1321,7 @@ namespace TFE_Jedi
 						while (line = parser.readLine(bufferPos))
 						{
 							char itemName[256];
-							s32 argCount = sscanf(line, " %s %s %s %s %s %s %s", itemName, s_infArg0, s_infArg1, s_infArg2, s_infArg3, s_infArgExtra, s_infArgExtra);
+							s32 argCount = TFE_LineScanner::scan(line, " %s %s %s %s %s %s %s", itemName, s_infArg0, s_infArg1, s_infArg2, s_infArg3, s_infArgExtra, s_infArgExtra);
 							KEYWORD levelItem = getKeywordIndex(itemName);
 							switch (levelItem)
 							{
@@ -1355,7 +1355,7 @@ namespace TFE_Jedi
 						}
 
 						char id[256];
-						s32 argCount = sscanf(line, " %s %s %s %s %s %s %s", id, s_infArg0, s_infArg1, s_infArg2, s_infArg3, s_infArg4, s_infArgExtra);
+						s32 argCount = TFE_LineScanner::scan(line, " %s %s %s %s %s %s %s", id, s_infArg0, s_infArg1, s_infArg2, s_infArg3, s_infArg4, s_infArgExtra);
 						KEYWORD itemClass = getKeywordIndex(s_infArg0);
 						assert(itemClass != KW_UNKNOWN);
 
@@ -1405,7 +1405,7 @@ namespace TFE_Jedi
 						}
 
 						char id[256];
-						s32 argCount = sscanf(line, " %s %s %s %s %s", id, s_infArg0, s_infArg1, s_infArg2, s_infArg3);
+						s32 argCount = TFE_LineScanner::scan(line, " %s %s %s %s %s", id, s_infArg0, s_infArg1, s_infArg2, s_infArg3);
 						if (parseLineTrigger(parser, bufferPos, argCount, name, wallNum))
 						{
 							break;
@@ -5,6 +5,7 @@
 #include "levelData.h"
 #include "rwall.h"
 #include "rtexture.h"
+#include "levelCache.h"
 #include <TFE_Game/igame.h>
 #include <TFE_Asset/assetSystem.h>
 #include <TFE_Asset/dfKeywords.h>
@@ -16,6 +17,8 @@
 #include <TFE_FileSystem/paths.h>
 #include <TFE_System/parser.h>
 #include <TFE_System/system.h>
+#include <TFE_System/jobSystem.h>
+#include <TFE_Settings/settings.h>
 
 #include <TFE_Jedi/InfSystem/infSystem.h>
 #include <TFE_Jedi/InfSystem/infTypesInternal.h>
@@ -42,8 +45,27 @@ namespace TFE_Jedi
 			
 	// Temp State.
 	static s32 s_dataIndex;
-	static char s_readBuffer[256];
 	static std::vector<char> s_buffer;
+	static std::vector<u8> s_levelBuffer;
+	static LevelCacheGeometry s_levelGeometry;
+
+	// The next level, prepared on worker jobs while the briefing or cutscenes are running.
+	// The geometry is parsed first, the textures it uses are then decoded along with the sprites and frames listed in the .O file.
+	// Asset decoding starts from level_updatePreload(), after the previous level's assets have been freed.
+	struct LevelPreload
+	{
+		char levelName[TFE_MAX_PATH];
+		std::vector<u8> source;
+		std::vector<u8> objectSource;
+		LevelCacheGeometry geometry;
+		bool useCache;
+		JBool valid;
+		JBool objectsPrefetched;
+		JBool texturesPrefetched;
+		atomic_s32 geometryCounter;
+		atomic_s32 counter;		// asset decode jobs.
+	};
+	static LevelPreload s_preload;
 
 	JBool level_loadGeometry(const char* levelName);
 	JBool level_loadObjects(const char* levelName, u8 difficulty);
@@ -63,6 +85,8 @@ namespace TFE_Jedi
 			s_levelState.complete[COMPL_ITEM][i] = JFALSE;
 		}
 
+		// Textures, sprites and frames decoded during the briefing must be finished before they are used.
+		TFE_Jobs::waitForCounter(&s_preload.counter);
 		if (!level_loadGeometry(levelName)) { return JFALSE; }
 		level_loadObjects(levelName, difficulty);
 		inf_load(levelName);
@@ -88,46 +112,24 @@ namespace TFE_Jedi
 		s_palModified = JTRUE;
 	}
 		
-	JBool level_loadGeometry(const char* levelName)
+	// Parse the .LEV text into a flat description without touching any runtime state,
+	// so that it can be cached and the same build step used for both paths.
+	static JBool level_parseGeometry(const char* data, size_t len, LevelCacheGeometry* geo)
 	{
-		s_levelState.secretCount = 0;
-		s_dataIndex = 0;
-		s_levelState.minLayer = INT_MAX;
-		s_levelState.maxLayer = INT_MIN;
-		message_free();
-
-		char levelPath[TFE_MAX_PATH];
-		strcpy(levelPath, levelName);
-		strcat(levelPath, ".LEV");
-
-		FilePath filePath;
-		if (!TFE_Paths::getFilePath(levelPath, &filePath))
-		{
-			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot find level geometry '%s'.", levelName);
-			return false;
-		}
-		FileStream file;
-		if (!file.open(&filePath, Stream::MODE_READ))
-		{
-			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot open level geometry '%s'.", levelName);
-			return false;
-		}
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
-		file.close();
+		levelCache_clear(geo);
 
 		TFE_Parser parser;
 		size_t bufferPos = 0;
-		parser.init(s_buffer.data(), s_buffer.size());
+		parser.init(data, len);
 		parser.addCommentString("#");
 		parser.convertToUpperCase(true);
 
 		// Only use the parser "read line" functionality and otherwise read in the same was as the DOS code.
 		const char* line;
+		char readBuffer[256];
 		line = parser.readLine(bufferPos);
 		s32 versionMajor, versionMinor;
-		if (sscanf(line, " LEV %d.%d", &versionMajor, &versionMinor) != 2)
+		if (TFE_LineScanner::scan(line, " LEV %d.%d", &versionMajor, &versionMinor) != 2)
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read version.");
 			return false;
@@ -139,7 +141,7 @@ namespace TFE_Jedi
 		}
 		
 		line = parser.readLine(bufferPos);
-		if (sscanf(line, " LEVELNAME %s", s_readBuffer) != 1)
+		if (TFE_LineScanner::scan(line, " LEVELNAME %s", readBuffer) != 1)
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read level name.");
 			return false;
@@ -147,17 +149,17 @@ namespace TFE_Jedi
 
 		// This gets read here just to be overwritten later... so just ignore for now.
 		line = parser.readLine(bufferPos);
-		if (sscanf(line, " PALETTE %s", s_levelState.levelPaletteName) != 1)
+		char paletteName[256];
+		if (TFE_LineScanner::scan(line, " PALETTE %s", paletteName) != 1)
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read palette name.");
 			return false;
 		}
-
-		level_loadPalette();
+		geo->paletteName = levelCache_addString(geo, paletteName);
 		
 		// Another value that is ignored.
 		line = parser.readLine(bufferPos);
-		if (sscanf(line, " MUSIC %s", s_readBuffer) != 1)
+		if (TFE_LineScanner::scan(line, " MUSIC %s", readBuffer) != 1)
 		{
 			TFE_System::logWrite(LOG_WARNING, "level_loadGeometry", "Cannot read music name.");
 		}
@@ -167,86 +169,63 @@ namespace TFE_Jedi
 		}
 
 		// Sky Parallax.
-		f32 parallax0, parallax1;
-		if (sscanf(line, " PARALLAX %f %f", &parallax0, &parallax1) != 2)
+		if (TFE_LineScanner::scan(line, " PARALLAX %f %f", &geo->parallax0, &geo->parallax1) != 2)
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read parallax values.");
 			return false;
 		}
-		s_levelState.parallax0 = floatToFixed16(parallax0);
-		s_levelState.parallax1 = floatToFixed16(parallax1);
 
 		// Number of textures used by the level.
 		line = parser.readLine(bufferPos);
-		if (sscanf(line, " TEXTURES %d", &s_levelState.textureCount) != 1)
+		s32 textureCount;
+		if (TFE_LineScanner::scan(line, " TEXTURES %d", &textureCount) != 1)
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read texture count.");
 			return false;
 		}
-		s_levelState.textures = (TextureData**)level_alloc(2 * s_levelState.textureCount * sizeof(TextureData**));
-		memset(s_levelState.textures, 0, 2 * s_levelState.textureCount * sizeof(TextureData**));
+		geo->textures.resize(max(textureCount, 0));
 
-		// Load Textures.
-		TextureData** texture = s_levelState.textures;
-		TextureData** texBase = s_levelState.textures + s_levelState.textureCount;
-		for (s32 i = 0; i < s_levelState.textureCount; i++, texture++, texBase++)
+		// Textures.
+		for (s32 i = 0; i < textureCount; i++)
 		{
+			LevelCacheTexture* texture = &geo->textures[i];
 			line = parser.readLine(bufferPos);
 			char textureName[256];
-			if (sscanf(line, " TEXTURE: %s ", textureName) != 1)
+			if (TFE_LineScanner::scan(line, " TEXTURE: %s ", textureName) != 1)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read texture name.");
-				*texture = bitmap_load("default.bm", 1);
+				texture->type = LTEX_DEFAULT;
+				texture->name = -1;
 			}
 			else if (strcasecmp(textureName, "<NoTexture>") == 0)
 			{
-				*texture = nullptr;
+				texture->type = LTEX_NONE;
+				texture->name = -1;
 			}
 			else
 			{
-				TextureData* tex = bitmap_load(textureName, 1);
-				if (!tex)
-				{
-					TFE_System::logWrite(LOG_WARNING, "level_loadGeometry", "Could not open '%s', using 'default.bm' instead.", textureName);
-					tex = bitmap_load("default.bm", 1);
-					if (!tex)
-					{
-						TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "'default.bm' is not a valid BM file!");
-						assert(0);
-						return false;
-					}
-				}
-				*texture = tex;
-				// This version never gets modified, so serialization is simpler.
-				*texBase = tex;
-
-				// Setup an animated texture.
-				if (tex->uvWidth == BM_ANIMATED_TEXTURE)
-				{
-					bitmap_setupAnimatedTexture(texture, i);
-				}
+				texture->type = LTEX_NAMED;
+				texture->name = levelCache_addString(geo, textureName);
 			}
 		}
 
-		// Load Sectors.
+		// Sectors.
 		line = parser.readLine(bufferPos);
-		if (sscanf(line, "NUMSECTORS %d", &s_levelState.sectorCount) != 1)
+		s32 sectorCount;
+		if (TFE_LineScanner::scan(line, "NUMSECTORS %d", &sectorCount) != 1)
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector count.");
 			return false;
 		}
 
-		s_levelState.sectors = (RSector*)level_alloc(sizeof(RSector) * s_levelState.sectorCount);
-		memset(s_levelState.sectors, 0, sizeof(RSector) * s_levelState.sectorCount);
-		for (u32 i = 0; i < s_levelState.sectorCount; i++)
+		geo->sectors.resize(max(sectorCount, 0));
+		for (s32 i = 0; i < sectorCount; i++)
 		{
-			RSector* sector = &s_levelState.sectors[i];
-			sector_clear(sector);
-			sector->index = i;
+			LevelCacheSector* sector = &geo->sectors[i];
 
 			// Sector ID and Name
 			line = parser.readLine(bufferPos);
-			if (sscanf(line, " SECTOR %d", &sector->id) != 1)
+			if (TFE_LineScanner::scan(line, " SECTOR %d", &sector->id) != 1)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector id.");
 				return false;
@@ -254,107 +233,253 @@ namespace TFE_Jedi
 
 			// Allow names to have '#' in them.
 			line = parser.readLine(bufferPos, false, true);
-			// Sectors missing a name are valid but do not get "addresses" - and thus cannot be
-			// used by the INF system (except in the case of doors and exploding walls, see the flags section below).
 			char name[256];
-			if (sscanf(line, " NAME %s", name) == 1)
+			sector->name = -1;
+			if (TFE_LineScanner::scan(line, " NAME %s", name) == 1)
 			{
-				// Add the sector "address" for later use by the INF system.
-				message_addAddress(name, 0, 0, sector);
-
-				// Track special elevators.
-				if (!strcasecmp(name, "complete"))
-				{
-					s_levelState.completeSector = sector;
-				}
-				else if (!strcasecmp(name, "boss"))
-				{
-					s_levelState.bossSector = sector;
-				}
-				else if (!strcasecmp(name, "mohc"))
-				{
-					s_levelState.mohcSector = sector;
-				}
+				sector->name = levelCache_addString(geo, name);
 			}
 
 			// Lighting
 			line = parser.readLine(bufferPos);
-			s32 ambient;
-			if (sscanf(line, " AMBIENT %d", &ambient) != 1)
+			if (TFE_LineScanner::scan(line, " AMBIENT %d", &sector->ambient) != 1)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector ambient.");
 				return false;
 			}
-			sector->ambient = intToFixed16(ambient);
 
 			// Floor Texture & Offset
 			line = parser.readLine(bufferPos);
-			s32 index, tmp;
-			f32 offsetX, offsetZ;
-			if (sscanf(line, " FLOOR TEXTURE %d %f %f %d", &index, &offsetX, &offsetZ, &tmp) != 4)
+			s32 tmp;
+			if (TFE_LineScanner::scan(line, " FLOOR TEXTURE %d %f %f %d", &sector->floorTex, &sector->floorOffset[0], &sector->floorOffset[1], &tmp) != 4)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read floor texture.");
 				return false;
 			}
 
-			sector->floorTex = nullptr;
-			if (index != -1)
-			{
-				sector->floorTex = &s_levelState.textures[index];
-			}
-			sector->floorOffset.x = floatToFixed16(offsetX);
-			sector->floorOffset.z = floatToFixed16(offsetZ);
-
 			// Floor Altitude
 			line = parser.readLine(bufferPos);
-			f32 alt;
-			if (sscanf(line, " FLOOR ALTITUDE %f", &alt) != 1)
+			if (TFE_LineScanner::scan(line, " FLOOR ALTITUDE %f", &sector->floorAlt) != 1)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read floor altitude.");
 				return false;
 			}
-			sector->floorHeight = floatToFixed16(alt);
 
 			// Ceiling Texture & Offset
 			line = parser.readLine(bufferPos);
-			if (sscanf(line, " CEILING TEXTURE %d %f %f %d", &index, &offsetX, &offsetZ, &tmp) != 4)
+			if (TFE_LineScanner::scan(line, " CEILING TEXTURE %d %f %f %d", &sector->ceilTex, &sector->ceilOffset[0], &sector->ceilOffset[1], &tmp) != 4)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read ceiling texture.");
 				return false;
 			}
-			sector->ceilTex = nullptr;
-			if (index != -1)
-			{
-				sector->ceilTex = &s_levelState.textures[index];
-			}
-			sector->ceilOffset.x = floatToFixed16(offsetX);
-			sector->ceilOffset.z = floatToFixed16(offsetZ);
 
 			// Ceiling Altitude
 			line = parser.readLine(bufferPos);
-			if (sscanf(line, " CEILING ALTITUDE %f", &alt) != 1)
+			if (TFE_LineScanner::scan(line, " CEILING ALTITUDE %f", &sector->ceilAlt) != 1)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read ceiling altitude.");
 				return false;
 			}
-			sector->ceilingHeight = floatToFixed16(alt);
 
 			// Second Altitude
 			line = parser.readLine(bufferPos);
-			if (sscanf(line, " SECOND ALTITUDE %f", &alt) != 1)
+			if (TFE_LineScanner::scan(line, " SECOND ALTITUDE %f", &sector->secondAlt) != 1)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read second altitude.");
 				return false;
 			}
-			sector->secHeight = floatToFixed16(alt);
 
 			// Sector flags
 			line = parser.readLine(bufferPos);
-			if (sscanf(line, " FLAGS %d %d %d", &sector->flags1, &sector->flags2, &sector->flags3) != 3)
+			if (TFE_LineScanner::scan(line, " FLAGS %d %d %d", &sector->flags[0], &sector->flags[1], &sector->flags[2]) != 3)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector flags.");
 				return false;
 			}
+
+			// Layer
+			line = parser.readLine(bufferPos);
+			if (TFE_LineScanner::scan(line, " LAYER %d", &sector->layer) != 1)
+			{
+				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector layer.");
+				return false;
+			}
+
+			// Vertices
+			line = parser.readLine(bufferPos);
+			if (TFE_LineScanner::scan(line, " VERTICES %d", &sector->vertexCount) != 1)
+			{
+				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector vertices.");
+				return false;
+			}
+			for (s32 v = 0; v < sector->vertexCount; v++)
+			{
+				line = parser.readLine(bufferPos);
+
+				f32 x = 0.0f, z = 0.0f;
+				TFE_LineScanner::scan(line, " X: %f Z: %f ", &x, &z);
+				geo->vertices.push_back(x);
+				geo->vertices.push_back(z);
+			}
+
+			// Walls
+			line = parser.readLine(bufferPos);
+			if (TFE_LineScanner::scan(line, " WALLS %d", &sector->wallCount) != 1)
+			{
+				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector walls.");
+				return false;
+			}
+			for (s32 w = 0; w < sector->wallCount; w++)
+			{
+				LevelCacheWall wall;
+				s32 walk, unused;
+
+				line = parser.readLine(bufferPos);
+				if (TFE_LineScanner::scan(line, " WALL LEFT: %d RIGHT: %d MID: %d %f %f %d TOP: %d %f %f %d BOT: %d %f %f %d SIGN: %d %f %f ADJOIN: %d MIRROR: %d WALK: %d FLAGS: %d %d %d LIGHT: %d",
+					&wall.left, &wall.right, &wall.midTex, &wall.midOffset[0], &wall.midOffset[1], &unused, &wall.topTex, &wall.topOffset[0], &wall.topOffset[1], &unused,
+					&wall.botTex, &wall.botOffset[0], &wall.botOffset[1], &unused, &wall.signTex, &wall.signOffset[0], &wall.signOffset[1], &wall.adjoin, &wall.mirror, &walk,
+					&wall.flags[0], &wall.flags[1], &wall.flags[2], &wall.light) != 24)
+				{
+					TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read wall.");
+					return false;
+				}
+				geo->walls.push_back(wall);
+			}
+		}
+		return true;
+	}
+
+	// Build the runtime sectors, walls and textures from the parsed (or cached) description.
+	static JBool level_buildGeometry(const LevelCacheGeometry* geo)
+	{
+		const char* strings = geo->strings.data();
+		strcpy(s_levelState.levelPaletteName, &strings[geo->paletteName]);
+		level_loadPalette();
+
+		s_levelState.parallax0 = floatToFixed16(geo->parallax0);
+		s_levelState.parallax1 = floatToFixed16(geo->parallax1);
+
+		s_levelState.textureCount = (s32)geo->textures.size();
+		s_levelState.textures = (TextureData**)level_alloc(2 * s_levelState.textureCount * sizeof(TextureData**));
+		memset(s_levelState.textures, 0, 2 * s_levelState.textureCount * sizeof(TextureData**));
+
+		// Decode the textures on worker threads, bitmap_load() below then picks them up in the original order.
+		atomic_s32 texturesInFlight(0);
+		for (s32 i = 0; i < s_levelState.textureCount; i++)
+		{
+			if (geo->textures[i].type == LTEX_NAMED)
+			{
+				bitmap_prefetch(&strings[geo->textures[i].name], 1, &texturesInFlight);
+			}
+		}
+		TFE_Jobs::waitForCounter(&texturesInFlight);
+
+		// Load Textures.
+		TextureData** texture = s_levelState.textures;
+		TextureData** texBase = s_levelState.textures + s_levelState.textureCount;
+		for (s32 i = 0; i < s_levelState.textureCount; i++, texture++, texBase++)
+		{
+			const LevelCacheTexture* texDesc = &geo->textures[i];
+			if (texDesc->type == LTEX_DEFAULT)
+			{
+				*texture = bitmap_load("default.bm", 1);
+			}
+			else if (texDesc->type == LTEX_NONE)
+			{
+				*texture = nullptr;
+			}
+			else
+			{
+				const char* textureName = &strings[texDesc->name];
+				TextureData* tex = bitmap_load(textureName, 1);
+				if (!tex)
+				{
+					TFE_System::logWrite(LOG_WARNING, "level_loadGeometry", "Could not open '%s', using 'default.bm' instead.", textureName);
+					tex = bitmap_load("default.bm", 1);
+					if (!tex)
+					{
+						TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "'default.bm' is not a valid BM file!");
+						assert(0);
+						return false;
+					}
+				}
+				*texture = tex;
+				// This version never gets modified, so serialization is simpler.
+				*texBase = tex;
+
+				// Setup an animated texture.
+				if (tex->uvWidth == BM_ANIMATED_TEXTURE)
+				{
+					bitmap_setupAnimatedTexture(texture, i);
+				}
+			}
+		}
+
+		// Load Sectors.
+		s_levelState.sectorCount = (u32)geo->sectors.size();
+		s_levelState.sectors = (RSector*)level_alloc(sizeof(RSector) * s_levelState.sectorCount);
+		memset(s_levelState.sectors, 0, sizeof(RSector) * s_levelState.sectorCount);
+
+		const f32* vertexDesc = geo->vertices.data();
+		const LevelCacheWall* wallDesc = geo->walls.data();
+		for (u32 i = 0; i < s_levelState.sectorCount; i++)
+		{
+			const LevelCacheSector* secDesc = &geo->sectors[i];
+			RSector* sector = &s_levelState.sectors[i];
+			sector_clear(sector);
+			sector->index = i;
+			sector->id = secDesc->id;
+
+			// Sectors missing a name are valid but do not get "addresses" - and thus cannot be
+			// used by the INF system (except in the case of doors and exploding walls, see the flags section below).
+			if (secDesc->name >= 0)
+			{
+				const char* name = &strings[secDesc->name];
+				// Add the sector "address" for later use by the INF system.
+				message_addAddress(name, 0, 0, sector);
+
+				// Track special elevators.
+				if (!strcasecmp(name, "complete"))
+				{
+					s_levelState.completeSector = sector;
+				}
+				else if (!strcasecmp(name, "boss"))
+				{
+					s_levelState.bossSector = sector;
+				}
+				else if (!strcasecmp(name, "mohc"))
+				{
+					s_levelState.mohcSector = sector;
+				}
+			}
+
+			// Lighting
+			sector->ambient = intToFixed16(secDesc->ambient);
+
+			// Floor & Ceiling
+			sector->floorTex = nullptr;
+			if (secDesc->floorTex != -1)
+			{
+				sector->floorTex = &s_levelState.textures[secDesc->floorTex];
+			}
+			sector->floorOffset.x = floatToFixed16(secDesc->floorOffset[0]);
+			sector->floorOffset.z = floatToFixed16(secDesc->floorOffset[1]);
+			sector->floorHeight = floatToFixed16(secDesc->floorAlt);
+
+			sector->ceilTex = nullptr;
+			if (secDesc->ceilTex != -1)
+			{
+				sector->ceilTex = &s_levelState.textures[secDesc->ceilTex];
+			}
+			sector->ceilOffset.x = floatToFixed16(secDesc->ceilOffset[0]);
+			sector->ceilOffset.z = floatToFixed16(secDesc->ceilOffset[1]);
+			sector->ceilingHeight = floatToFixed16(secDesc->ceilAlt);
+			sector->secHeight = floatToFixed16(secDesc->secondAlt);
+
+			// Sector flags
+			sector->flags1 = secDesc->flags[0];
+			sector->flags2 = secDesc->flags[1];
+			sector->flags3 = secDesc->flags[2];
 			// Create a door if needed.
 			if (sector->flags1 & SEC_FLAGS1_DOOR)
 			{
@@ -373,135 +498,97 @@ namespace TFE_Jedi
 			}
 
 			// Layer
-			line = parser.readLine(bufferPos);
-			if (sscanf(line, " LAYER %d", &sector->layer) != 1)
-			{
-				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector layer.");
-				return false;
-			}
+			sector->layer = secDesc->layer;
 			s_levelState.minLayer = min(s_levelState.minLayer, sector->layer);
 			s_levelState.maxLayer = max(s_levelState.maxLayer, sector->layer);
 
 			// Vertices
-			line = parser.readLine(bufferPos);
-			s32 vertexCount;
-			if (sscanf(line, " VERTICES %d", &vertexCount) != 1)
-			{
-				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector vertices.");
-				return false;
-			}
+			const s32 vertexCount = secDesc->vertexCount;
 			const size_t vtxSize = vertexCount * sizeof(vec2_fixed);
 			sector->verticesWS = (vec2_fixed*)level_alloc(vtxSize);
 			sector->verticesVS = (vec2_fixed*)level_alloc(vtxSize);
 			sector->vertexCount = vertexCount;
 
-			for (s32 v = 0; v < vertexCount; v++)
+			for (s32 v = 0; v < vertexCount; v++, vertexDesc += 2)
 			{
-				line = parser.readLine(bufferPos);
-
-				f32 x, z;
-				sscanf(line, " X: %f Z: %f ", &x, &z);
-				sector->verticesWS[v].x = floatToFixed16(x);
-				sector->verticesWS[v].z = floatToFixed16(z);
+				sector->verticesWS[v].x = floatToFixed16(vertexDesc[0]);
+				sector->verticesWS[v].z = floatToFixed16(vertexDesc[1]);
 			}
 
 			// Walls
-			line = parser.readLine(bufferPos);
-			s32 wallCount;
-			if (sscanf(line, " WALLS %d", &wallCount) != 1)
-			{
-				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector walls.");
-				return false;
-			}
+			const s32 wallCount = secDesc->wallCount;
 			sector->walls = (RWall*)level_alloc(wallCount * sizeof(RWall));
 			sector->wallCount = wallCount;
 
-			for (s32 w = 0; w < wallCount; w++)
+			for (s32 w = 0; w < wallCount; w++, wallDesc++)
 			{
-				s32 light, flags3, flags2, flags1, walk, mirror, adjoin;
-				s32 signTex, unused;
-				s32 botTex, topTex, midTex, right, left;
-				f32 signOffsetZ, signOffsetX;
-				f32 botOffsetZ, botOffsetX;
-				f32 topOffsetZ, topOffsetX;
-				f32 midOffsetZ, midOffsetX;
-
-				line = parser.readLine(bufferPos);
-				if (sscanf(line, " WALL LEFT: %d RIGHT: %d MID: %d %f %f %d TOP: %d %f %f %d BOT: %d %f %f %d SIGN: %d %f %f ADJOIN: %d MIRROR: %d WALK: %d FLAGS: %d %d %d LIGHT: %d",
-					&left, &right, &midTex, &midOffsetX, &midOffsetZ, &unused, &topTex, &topOffsetX, &topOffsetZ, &unused, &botTex, &botOffsetX, &botOffsetZ, &unused,
-					&signTex, &signOffsetX, &signOffsetZ, &adjoin, &mirror, &walk, &flags1, &flags2, &flags3, &light) != 24)
-				{
-					TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read wall.");
-					return false;
-				}
-
 				RWall* wall = &sector->walls[w];
 				wall->id = w;
 				wall->sector = sector;
 				wall->mirrorWall = nullptr;
 				wall->seen = JFALSE;
-				wall->flags1 = flags1;
-				wall->flags2 = flags2;
-				wall->flags3 = flags3;
+				wall->flags1 = wallDesc->flags[0];
+				wall->flags2 = wallDesc->flags[1];
+				wall->flags3 = wallDesc->flags[2];
 
-				vec2_fixed* leftVtxWS = &sector->verticesWS[left];
-				vec2_fixed* rightVtxWS = &sector->verticesWS[right];
+				vec2_fixed* leftVtxWS = &sector->verticesWS[wallDesc->left];
+				vec2_fixed* rightVtxWS = &sector->verticesWS[wallDesc->right];
 				wall->w0 = leftVtxWS;
 				wall->w1 = rightVtxWS;
-				wall->v0 = &sector->verticesVS[left];
-				wall->v1 = &sector->verticesVS[right];
+				wall->v0 = &sector->verticesVS[wallDesc->left];
+				wall->v1 = &sector->verticesVS[wallDesc->right];
 				// Store the original position 0 in the wall since it is used by the sector rotation INF.
 				wall->worldPos0.x = leftVtxWS->x;
 				wall->worldPos0.z = leftVtxWS->z;
 
 				wall->nextSector = nullptr;
 				wall->mirror = -1;
-				if (adjoin != -1)
+				if (wallDesc->adjoin != -1)
 				{
-					wall->nextSector = &s_levelState.sectors[adjoin];
-					if (mirror == -1)
+					wall->nextSector = &s_levelState.sectors[wallDesc->adjoin];
+					if (wallDesc->mirror == -1)
 					{
 						TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Adjoining wall missing mirror.");
 					}
-					wall->mirror = mirror;
+					wall->mirror = wallDesc->mirror;
 				}
 
 				wall->infLink = nullptr;
 				wall->collisionFrame = 0;
 				wall->drawFrame = 0;
 				wall->drawFlags = 0;
-				wall->wallLight = intToFixed16(light);
+				wall->wallLight = intToFixed16(wallDesc->light);
 
 				wall->midTex = nullptr;
-				if (midTex != -1)
+				if (wallDesc->midTex != -1)
 				{
-					wall->midTex = &s_levelState.textures[midTex];
-					wall->midOffset.x = floatToFixed16(midOffsetX) * 8;
-					wall->midOffset.z = floatToFixed16(midOffsetZ) * 8;
+					wall->midTex = &s_levelState.textures[wallDesc->midTex];
+					wall->midOffset.x = floatToFixed16(wallDesc->midOffset[0]) * 8;
+					wall->midOffset.z = floatToFixed16(wallDesc->midOffset[1]) * 8;
 				}
 
 				wall->topTex = nullptr;
-				if (topTex != -1)
+				if (wallDesc->topTex != -1)
 				{
-					wall->topTex = &s_levelState.textures[topTex];
-					wall->topOffset.x = floatToFixed16(topOffsetX) * 8;
-					wall->topOffset.z = floatToFixed16(topOffsetZ) * 8;
+					wall->topTex = &s_levelState.textures[wallDesc->topTex];
+					wall->topOffset.x = floatToFixed16(wallDesc->topOffset[0]) * 8;
+					wall->topOffset.z = floatToFixed16(wallDesc->topOffset[1]) * 8;
 				}
 
 				wall->botTex = nullptr;
-				if (botTex != -1)
+				if (wallDesc->botTex != -1)
 				{
-					wall->botTex = &s_levelState.textures[botTex];
-					wall->botOffset.x = floatToFixed16(botOffsetX) * 8;
-					wall->botOffset.z = floatToFixed16(botOffsetZ) * 8;
+					wall->botTex = &s_levelState.textures[wallDesc->botTex];
+					wall->botOffset.x = floatToFixed16(wallDesc->botOffset[0]) * 8;
+					wall->botOffset.z = floatToFixed16(wallDesc->botOffset[1]) * 8;
 				}
 
 				wall->signTex = nullptr;
-				if (signTex != -1)
+				if (wallDesc->signTex != -1)
 				{
-					wall->signTex = &s_levelState.textures[signTex];
-					wall->signOffset.x = floatToFixed16(signOffsetX) * 8;
-					wall->signOffset.z = floatToFixed16(signOffsetZ) * 8;
+					wall->signTex = &s_levelState.textures[wallDesc->signTex];
+					wall->signOffset.x = floatToFixed16(wallDesc->signOffset[0]) * 8;
+					wall->signOffset.z = floatToFixed16(wallDesc->signOffset[1]) * 8;
 				}
 
 				fixed16_16 dx = rightVtxWS->x - leftVtxWS->x;
@@ -536,6 +623,7 @@ namespace TFE_Jedi
 			// TFE: Added to support non-fixed-point rendering.
 			sector->dirtyFlags = SDF_ALL;
 		}
+		sector_buildSpatialIndex();
 
 		// Setup the control sector.
 		s_levelState.controlSector->id = s_levelState.sectorCount;
@@ -544,8 +632,256 @@ namespace TFE_Jedi
 		return true;
 	}
 
+	static void level_preloadJob(void* userData)
+	{
+		LevelPreload* preload = (LevelPreload*)userData;
+		const u8* data = preload->source.data();
+		const size_t len = preload->source.size();
+
+		const u64 sourceHash = preload->useCache ? levelCache_hash(data, len) : 0;
+		preload->valid = JTRUE;
+		if (!preload->useCache || !levelCache_read(preload->levelName, sourceHash, (u32)len, &preload->geometry))
+		{
+			preload->valid = level_parseGeometry((const char*)data, len, &preload->geometry);
+			if (preload->valid && preload->useCache)
+			{
+				levelCache_write(preload->levelName, sourceHash, (u32)len, &preload->geometry);
+			}
+		}
+	}
+
+	// Decode the sprites and frames listed at the start of the .O file, the objects themselves still need the level to be built.
+	static void level_prefetchObjectAssets(const u8* data, size_t len, atomic_s32* counter)
+	{
+		TFE_Parser parser;
+		size_t bufferPos = 0;
+		parser.init((const char*)data, len);
+		parser.enableBlockComments();
+		parser.addCommentString("//");
+		parser.addCommentString("#");
+		parser.convertToUpperCase(true);
+
+		const char* line = parser.readLine(bufferPos);
+		s32 versionMajor, versionMinor;
+		if (TFE_LineScanner::scan(line, "O %d.%d", &versionMajor, &versionMinor) != 2) { return; }
+
+		s32 count;
+		char name[32];
+		while ((line = parser.readLine(bufferPos)) != nullptr)
+		{
+			if (TFE_LineScanner::scan(line, "SPRS %d", &count) == 1)
+			{
+				for (s32 i = 0; i < count && (line = parser.readLine(bufferPos)) != nullptr; i++)
+				{
+					if (TFE_LineScanner::scan(line, " SPR: %s ", name) == 1)
+					{
+						TFE_Sprite_Jedi::prefetchWax(name, counter);
+					}
+				}
+			}
+			else if (TFE_LineScanner::scan(line, "FMES %d", &count) == 1)
+			{
+				for (s32 i = 0; i < count && (line = parser.readLine(bufferPos)) != nullptr; i++)
+				{
+					if (TFE_LineScanner::scan(line, " FME: %s ", name) == 1)
+					{
+						TFE_Sprite_Jedi::prefetchFrame(name, counter);
+					}
+				}
+			}
+			else if (TFE_LineScanner::scan(line, "OBJECTS %d", &count) == 1)
+			{
+				// The asset lists come before the objects.
+				break;
+			}
+		}
+	}
+
+	void level_preload(const char* levelName)
+	{
+		if (!levelName || !levelName[0]) { return; }
+		// The same level may be requested again by each cutscene leading up to the mission.
+		if (s_preload.levelName[0] && strcasecmp(s_preload.levelName, levelName) == 0) { return; }
+		level_cancelPreload();
+
+		char levelPath[TFE_MAX_PATH];
+		snprintf(levelPath, TFE_MAX_PATH, "%s.LEV", levelName);
+
+		// The files are read on the main thread, archives are not safe to access from the jobs.
+		FilePath filePath;
+		size_t len;
+		const u8* data = TFE_Paths::getFilePath(levelPath, &filePath) ? FileStream::readContentsView(&filePath, s_preload.source, &len) : nullptr;
+		if (!data) { return; }
+		if (data != s_preload.source.data())
+		{
+			s_preload.source.assign(data, data + len);
+		}
+
+		strncpy(s_preload.levelName, levelName, TFE_MAX_PATH - 1);
+		s_preload.levelName[TFE_MAX_PATH - 1] = 0;
+		s_preload.useCache = TFE_Settings::getGameSettings()->df_levelCache;
+		s_preload.valid = JFALSE;
+		s_preload.objectsPrefetched = JFALSE;
+		s_preload.texturesPrefetched = JFALSE;
+		TFE_Jobs::addJob(level_preloadJob, &s_preload, &s_preload.geometryCounter);
+
+		snprintf(levelPath, TFE_MAX_PATH, "%s.O", levelName);
+		data = TFE_Paths::getFilePath(levelPath, &filePath) ? FileStream::readContentsView(&filePath, s_preload.objectSource, &len) : nullptr;
+		if (data && data != s_preload.objectSource.data())
+		{
+			s_preload.objectSource.assign(data, data + len);
+		}
+	}
+
+	void level_updatePreload()
+	{
+		if (!s_preload.levelName[0]) { return; }
+		// Sprites and frames are allocated with malloc(), so they can be decoded before the level memory is setup.
+		// This waits for the first update since a mission that just ended frees its assets after the preload is started.
+		if (!s_preload.objectsPrefetched)
+		{
+			s_preload.objectsPrefetched = JTRUE;
+			if (!s_preload.objectSource.empty())
+			{
+				level_prefetchObjectAssets(s_preload.objectSource.data(), s_preload.objectSource.size(), &s_preload.counter);
+			}
+		}
+		if (s_preload.texturesPrefetched || s_preload.geometryCounter.load() != 0) { return; }
+		s_preload.texturesPrefetched = JTRUE;
+		if (!s_preload.valid) { return; }
+
+		// The level memory is empty until the mission starts, so the textures can be allocated there now.
+		// bitmap_load() picks them up when the level is loaded, and they are freed with the level like any other texture.
+		MemoryRegion* prevRegion = bitmap_getAllocator();
+		bitmap_setAllocator(s_levelRegion);
+		const LevelCacheGeometry* geo = &s_preload.geometry;
+		const size_t textureCount = geo->textures.size();
+		for (size_t i = 0; i < textureCount; i++)
+		{
+			if (geo->textures[i].type == LTEX_NAMED)
+			{
+				bitmap_prefetch(&geo->strings[geo->textures[i].name], 1, &s_preload.counter);
+			}
+		}
+		bitmap_setAllocator(prevRegion);
+	}
+
+	static void level_resetPreload()
+	{
+		TFE_Jobs::waitForCounter(&s_preload.geometryCounter);
+		TFE_Jobs::waitForCounter(&s_preload.counter);
+		s_preload.levelName[0] = 0;
+		s_preload.valid = JFALSE;
+		s_preload.objectsPrefetched = JFALSE;
+		s_preload.texturesPrefetched = JFALSE;
+		s_preload.source.clear();
+		s_preload.objectSource.clear();
+		levelCache_clear(&s_preload.geometry);
+	}
+
+	void level_cancelPreload()
+	{
+		// The textures are already allocated in the level memory, which is only cleared when the next level ends.
+		const JBool releaseTextures = s_preload.texturesPrefetched;
+		level_resetPreload();
+		if (releaseTextures)
+		{
+			bitmap_releasePending(POOL_LEVEL);
+		}
+	}
+
+	// Take the preloaded geometry if it matches the level being loaded, waiting for the job if it is still running.
+	static JBool level_takePreload(const char* levelName, const u8* data, size_t len, LevelCacheGeometry* geo)
+	{
+		if (!s_preload.levelName[0]) { return JFALSE; }
+
+		TFE_Jobs::waitForCounter(&s_preload.geometryCounter);
+		const JBool match = s_preload.valid && strcasecmp(s_preload.levelName, levelName) == 0 &&
+			s_preload.source.size() == len && memcmp(s_preload.source.data(), data, len) == 0;
+		if (match)
+		{
+			std::swap(*geo, s_preload.geometry);
+		}
+		// The prefetched textures are picked up by bitmap_load() as the level is built.
+		level_resetPreload();
+		return match;
+	}
+
+	JBool level_loadGeometry(const char* levelName)
+	{
+		s_levelState.secretCount = 0;
+		s_dataIndex = 0;
+		s_levelState.minLayer = INT_MAX;
+		s_levelState.maxLayer = INT_MIN;
+		message_free();
+
+		char levelPath[TFE_MAX_PATH];
+		strcpy(levelPath, levelName);
+		strcat(levelPath, ".LEV");
+
+		FilePath filePath;
+		if (!TFE_Paths::getFilePath(levelPath, &filePath))
+		{
+			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot find level geometry '%s'.", levelName);
+			return false;
+		}
+		// Parse directly from the archive when it is memory-mapped.
+		size_t len;
+		const u8* data = FileStream::readContentsView(&filePath, s_levelBuffer, &len);
+		if (!data)
+		{
+			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot open level geometry '%s'.", levelName);
+			return false;
+		}
+
+		// Use the geometry preloaded during the briefing if it was parsed from this exact file.
+		if (level_takePreload(levelName, data, len, &s_levelGeometry))
+		{
+			return level_buildGeometry(&s_levelGeometry);
+		}
+
+		// Skip parsing the text if the cooked geometry for this exact file is already cached.
+		const bool useCache = TFE_Settings::getGameSettings()->df_levelCache;
+		const u64 sourceHash = useCache ? levelCache_hash(data, len) : 0;
+		if (!useCache || !levelCache_read(levelName, sourceHash, (u32)len, &s_levelGeometry))
+		{
+			if (!level_parseGeometry((const char*)data, len, &s_levelGeometry))
+			{
+				return false;
+			}
+			if (useCache)
+			{
+				levelCache_write(levelName, sourceHash, (u32)len, &s_levelGeometry);
+			}
+		}
+		return level_buildGeometry(&s_levelGeometry);
+	}
+
+	f64 level_benchmarkGeometryParse(const char* levelName, s32 iterations)
+	{
+		char levelPath[TFE_MAX_PATH];
+		snprintf(levelPath, TFE_MAX_PATH, "%s.LEV", levelName);
+
+		FilePath filePath;
+		std::vector<u8> buffer;
+		size_t len;
+		const u8* data = TFE_Paths::getFilePath(levelPath, &filePath) ? FileStream::readContentsView(&filePath, buffer, &len) : nullptr;
+		if (!data || iterations < 1) { return -1.0; }
+
+		// Only the text parsing is timed, nothing is built and the cache is not used.
+		LevelCacheGeometry geo;
+		const u64 start = TFE_System::getCurrentTimeInTicks();
+		for (s32 i = 0; i < iterations; i++)
+		{
+			if (!level_parseGeometry((const char*)data, len, &geo)) { return -1.0; }
+		}
+		return TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - start) / f64(iterations);
+	}
+
 	void level_freeAllAssets()
 	{
+		// Sprites and frames being decoded for the next level are in the same pools.
+		TFE_Jobs::waitForCounter(&s_preload.counter);
 		TFE_Sprite_Jedi::freeLevelData();
 		TFE_Model_Jedi::freeLevelData();
 	}
@@ -601,7 +937,7 @@ namespace TFE_Jedi
 		const char* line;
 		line = parser.readLine(bufferPos);
 		s32 versionMajor, versionMinor;
-		if (sscanf(line, "GOL %d.%d", &versionMajor, &versionMinor) != 2)
+		if (TFE_LineScanner::scan(line, "GOL %d.%d", &versionMajor, &versionMinor) != 2)
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot parse version for Goal file '%s'.", levelName);
 			return false;
@@ -612,7 +948,7 @@ namespace TFE_Jedi
 		{
 			s32 goalNum, typeNum;
 			char type[32];
-			if (sscanf(line, " GOAL: %d %s %d", &goalNum, type, &typeNum) == 3)
+			if (TFE_LineScanner::scan(line, " GOAL: %d %s %d", &goalNum, type, &typeNum) == 3)
 			{
 				if (typeNum < 0 || typeNum >= NUM_COMPLETE)
 				{
@@ -713,7 +1049,7 @@ namespace TFE_Jedi
 		const char* line;
 		line = parser.readLine(bufferPos);
 		s32 versionMajor, versionMinor;
-		if (sscanf(line, "O %d.%d", &versionMajor, &versionMinor) != 2)
+		if (TFE_LineScanner::scan(line, "O %d.%d", &versionMajor, &versionMinor) != 2)
 		{
 			TFE_System::logWrite(LOG_ERROR, "Level Load", "Cannot parse version for Object file '%s'.", levelName);
 			return false;
@@ -721,7 +1057,7 @@ namespace TFE_Jedi
 
 		while (line = parser.readLine(bufferPos))
 		{
-			if (sscanf(line, "PODS %d", &s_levelIntState.podCount) == 1)
+			if (TFE_LineScanner::scan(line, "PODS %d", &s_levelIntState.podCount) == 1)
 			{
 				s_levelIntState.pods = (JediModel**)level_alloc(sizeof(JediModel*)*s_levelIntState.podCount);
 				for (s32 p = 0; p < s_levelIntState.podCount; p++)
@@ -732,7 +1068,7 @@ namespace TFE_Jedi
 					if (line)
 					{
 						char podName[32];
-						if (sscanf(line, " POD: %s", podName) == 1)
+						if (TFE_LineScanner::scan(line, " POD: %s", podName) == 1)
 						{
 							s_levelIntState.pods[p] = TFE_Model_Jedi::get(podName);
 							if (!s_levelIntState.pods[p])
@@ -747,9 +1083,12 @@ namespace TFE_Jedi
 					}
 				}
 			}
-			else if (sscanf(line, "SPRS %d", &s_levelIntState.spriteCount) == 1)
+			else if (TFE_LineScanner::scan(line, "SPRS %d", &s_levelIntState.spriteCount) == 1)
 			{
 				s_levelIntState.sprites = (JediWax**)level_alloc(sizeof(JediWax*)*s_levelIntState.spriteCount);
+				// Read the whole list first and build the sprites on worker threads, getWax() then picks them up in order.
+				std::vector<std::string> names(s_levelIntState.spriteCount);
+				atomic_s32 assetsInFlight(0);
 				for (s32 s = 0; s < s_levelIntState.spriteCount; s++)
 				{
 					line = parser.readLine(bufferPos);
@@ -758,13 +1097,10 @@ namespace TFE_Jedi
 					if (line)
 					{
 						char name[32];
-						if (sscanf(line, " SPR: %s ", name) == 1)
+						if (TFE_LineScanner::scan(line, " SPR: %s ", name) == 1)
 						{
-							s_levelIntState.sprites[s] = TFE_Sprite_Jedi::getWax(name);
-							if (!s_levelIntState.sprites[s])
-							{
-								s_levelIntState.sprites[s] = TFE_Sprite_Jedi::getWax("default.wax");
-							}
+							names[s] = name;
+							TFE_Sprite_Jedi::prefetchWax(name, &assetsInFlight);
 						}
 						else
 						{
@@ -772,10 +1108,24 @@ namespace TFE_Jedi
 						}
 					}
 				}
+				TFE_Jobs::waitForCounter(&assetsInFlight);
+
+				for (s32 s = 0; s < s_levelIntState.spriteCount; s++)
+				{
+					if (names[s].empty()) { continue; }
+					s_levelIntState.sprites[s] = TFE_Sprite_Jedi::getWax(names[s].c_str());
+					if (!s_levelIntState.sprites[s])
+					{
+						s_levelIntState.sprites[s] = TFE_Sprite_Jedi::getWax("default.wax");
+					}
+				}
 			}
-			else if (sscanf(line, "FMES %d", &s_levelIntState.fmeCount) == 1)
+			else if (TFE_LineScanner::scan(line, "FMES %d", &s_levelIntState.fmeCount) == 1)
 			{
 				s_levelIntState.frames = (JediFrame**)level_alloc(sizeof(JediFrame*)*s_levelIntState.fmeCount);
+				// Same as the sprites: read the list, build the frames on worker threads and then pick them up in order.
+				std::vector<std::string> names(s_levelIntState.fmeCount);
+				atomic_s32 assetsInFlight(0);
 				for (s32 f = 0; f < s_levelIntState.fmeCount; f++)
 				{
 					line = parser.readLine(bufferPos);
@@ -784,13 +1134,10 @@ namespace TFE_Jedi
 					if (line)
 					{
 						char name[32];
-						if (sscanf(line, " FME: %s ", name) == 1)
+						if (TFE_LineScanner::scan(line, " FME: %s ", name) == 1)
 						{
-							s_levelIntState.frames[f] = TFE_Sprite_Jedi::getFrame(name);
-							if (!s_levelIntState.frames[f])
-							{
-								s_levelIntState.frames[f] = TFE_Sprite_Jedi::getFrame("default.fme");
-							}
+							names[f] = name;
+							TFE_Sprite_Jedi::prefetchFrame(name, &assetsInFlight);
 						}
 						else
 						{
@@ -798,8 +1145,19 @@ namespace TFE_Jedi
 						}
 					}
 				}
+				TFE_Jobs::waitForCounter(&assetsInFlight);
+
+				for (s32 f = 0; f < s_levelIntState.fmeCount; f++)
+				{
+					if (names[f].empty()) { continue; }
+					s_levelIntState.frames[f] = TFE_Sprite_Jedi::getFrame(names[f].c_str());
+					if (!s_levelIntState.frames[f])
+					{
+						s_levelIntState.frames[f] = TFE_Sprite_Jedi::getFrame("default.fme");
+					}
+				}
 			}
-			else if (sscanf(line, "SOUNDS %d", &s_levelIntState.soundCount) == 1)
+			else if (TFE_LineScanner::scan(line, "SOUNDS %d", &s_levelIntState.soundCount) == 1)
 			{
 				s_levelIntState.soundIds = (SoundSourceId*)level_alloc(sizeof(SoundSourceId)*s_levelIntState.soundCount);
 				for (s32 s = 0; s < s_levelIntState.soundCount; s++)
@@ -810,7 +1168,7 @@ namespace TFE_Jedi
 					if (line)
 					{
 						char name[32];
-						if (sscanf(line, " SOUND: %s ", name) == 1)
+						if (TFE_LineScanner::scan(line, " SOUND: %s ", name) == 1)
 						{
 							s_levelIntState.soundIds[s] = sound_load(name, SOUND_PRIORITY_LOW2);
 						}
@@ -821,7 +1179,7 @@ namespace TFE_Jedi
 					}
 				}
 			}
-			else if (sscanf(line, "OBJECTS %d", &s_levelIntState.objectCount) == 1)
+			else if (TFE_LineScanner::scan(line, "OBJECTS %d", &s_levelIntState.objectCount) == 1)
 			{
 				s32 count = s_levelIntState.objectCount;
 				JBool readNextLine = JTRUE;
@@ -841,7 +1199,7 @@ namespace TFE_Jedi
 					f32 x, y, z, pch, yaw, rol;
 					char objClass[32];
 
-					if (sscanf(line, " CLASS: %s DATA: %d X: %f Y: %f Z: %f PCH: %f YAW: %f ROL: %f DIFF: %d", objClass, &s_dataIndex, &x, &y, &z, &pch, &yaw, &rol, &objDiff) > 5)
+					if (TFE_LineScanner::scan(line, " CLASS: %s DATA: %d X: %f Y: %f Z: %f PCH: %f YAW: %f ROL: %f DIFF: %d", objClass, &s_dataIndex, &x, &y, &z, &pch, &yaw, &rol, &objDiff) > 5)
 					{
 						objIndex++;
 						// objDiff >= 0: This difficulty and all greater.
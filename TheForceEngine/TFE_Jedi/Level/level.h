@@ -41,7 +41,19 @@ namespace TFE_Jedi
 	void  level_clearData();
 	void  level_freeAllAssets();
 
+	// Start preparing the next level on worker jobs: the geometry is parsed and the sprites and frames are decoded.
+	// level_load() picks up the results if the level matches.
+	void  level_preload(const char* levelName);
+	// Call once per frame while the preload is running. The sprites and frames are decoded from the first call,
+	// so the previous level's assets must be freed by then, and the textures once the geometry is ready.
+	void  level_updatePreload();
+	// Wait for any preload in flight and discard the geometry and the prefetched textures.
+	// Sprites and frames are kept until the level is freed.
+	void  level_cancelPreload();
+
 	void level_serialize(Stream* stream);
+	// While enabled, writing the level state copies the serialized data of sectors that did not change since the last time it was enabled.
+	void level_setIncrementalCapture(bool enable);
 
 	void setObjPos_AddToSector(SecObject* obj, s32 x, s32 y, s32 z, RSector* sector);
 	void getSkyParallax(fixed16_16* parallax0, fixed16_16* parallax1);
@@ -55,5 +67,8 @@ namespace TFE_Jedi
 
 	void level_updateSecretPercent();
 
+	// Returns the average time in seconds to parse the level geometry text, or a negative value on failure.
+	f64 level_benchmarkGeometryParse(const char* levelName, s32 iterations);
+
 	void ambientSoundTaskFunc(MessageType msg);
 }
@@ -0,0 +1,241 @@
+#include <cstring>
+
+#include "levelCache.h"
+#include <TFE_System/system.h>
+#include <TFE_FileSystem/filestream.h>
+#include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/paths.h>
+
+namespace TFE_Jedi
+{
+	enum
+	{
+		LEVEL_CACHE_MAGIC = 0x4356454c,	// "LEVC"
+		LEVEL_CACHE_VERSION = 1,		// Bump whenever the cached structures change.
+	};
+
+	struct LevelCacheHeader
+	{
+		u32 magic;
+		u32 version;
+		u64 engineHash;
+		u64 sourceHash;
+		u32 sourceSize;
+
+		s32 paletteName;
+		f32 parallax0;
+		f32 parallax1;
+
+		u32 textureCount;
+		u32 sectorCount;
+		u32 vertexCount;
+		u32 wallCount;
+		u32 stringSize;
+	};
+
+	static u64 hashBytes(u64 hash, const u8* data, size_t size)
+	{
+		// 64-bit FNV-1a
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= data[i];
+			hash *= 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+	static u64 getEngineHash()
+	{
+		const char* version = TFE_System::getVersionString();
+		return hashBytes(0xcbf29ce484222325ull, (const u8*)version, strlen(version));
+	}
+
+	// The source hash is part of the name, so the same level from the base game and from mods get separate files.
+	static void getCachePath(const char* levelName, u64 sourceHash, char* cachePath)
+	{
+		char fileName[TFE_MAX_PATH];
+		snprintf(fileName, TFE_MAX_PATH, "Cache/%s_%08x%08x.lvc", levelName, u32(sourceHash >> 32ull), u32(sourceHash));
+		TFE_Paths::appendPath(PATH_PROGRAM_DATA, fileName, cachePath);
+	}
+
+	static size_t getDataSize(const LevelCacheHeader& header)
+	{
+		return sizeof(LevelCacheHeader) + size_t(header.textureCount) * sizeof(LevelCacheTexture) + size_t(header.sectorCount) * sizeof(LevelCacheSector)
+			+ size_t(header.vertexCount) * sizeof(f32) + size_t(header.wallCount) * sizeof(LevelCacheWall) + size_t(header.stringSize);
+	}
+
+	static bool isValidString(const LevelCacheGeometry* geo, s32 offset)
+	{
+		return offset >= 0 && size_t(offset) < geo->strings.size();
+	}
+
+	static bool isValidTexture(const LevelCacheGeometry* geo, s32 index)
+	{
+		return index == -1 || (index >= 0 && size_t(index) < geo->textures.size());
+	}
+
+	// Check every index and offset used when building the level, so a corrupted cache is rejected
+	// instead of reading out of bounds.
+	static bool validateGeometry(const LevelCacheGeometry* geo)
+	{
+		// The string table must be terminated, so a valid offset cannot run off the end.
+		if (geo->strings.empty() || geo->strings.back() != 0 || !isValidString(geo, geo->paletteName)) { return false; }
+
+		const size_t textureCount = geo->textures.size();
+		for (size_t i = 0; i < textureCount; i++)
+		{
+			const LevelCacheTexture& texture = geo->textures[i];
+			if (texture.type != LTEX_NONE && texture.type != LTEX_NAMED && texture.type != LTEX_DEFAULT) { return false; }
+			if (texture.type == LTEX_NAMED && !isValidString(geo, texture.name)) { return false; }
+		}
+
+		// Vertices and walls are stored sector by sector, so the counts have to add up to the totals.
+		const size_t sectorCount = geo->sectors.size();
+		size_t vertexTotal = 0, wallTotal = 0;
+		for (size_t i = 0; i < sectorCount; i++)
+		{
+			const LevelCacheSector& sector = geo->sectors[i];
+			if (sector.name != -1 && !isValidString(geo, sector.name)) { return false; }
+			if (!isValidTexture(geo, sector.floorTex) || !isValidTexture(geo, sector.ceilTex)) { return false; }
+			if (sector.vertexCount < 0 || sector.wallCount < 0) { return false; }
+			vertexTotal += size_t(sector.vertexCount);
+			wallTotal += size_t(sector.wallCount);
+		}
+		if (vertexTotal * 2 != geo->vertices.size() || wallTotal != geo->walls.size()) { return false; }
+
+		const LevelCacheWall* wall = geo->walls.data();
+		for (size_t i = 0; i < sectorCount; i++)
+		{
+			const LevelCacheSector& sector = geo->sectors[i];
+			for (s32 w = 0; w < sector.wallCount; w++, wall++)
+			{
+				if (wall->left < 0 || wall->left >= sector.vertexCount || wall->right < 0 || wall->right >= sector.vertexCount) { return false; }
+				if (!isValidTexture(geo, wall->midTex) || !isValidTexture(geo, wall->topTex) ||
+					!isValidTexture(geo, wall->botTex) || !isValidTexture(geo, wall->signTex)) { return false; }
+				if (wall->adjoin == -1) { continue; }
+
+				// Adjoined walls are linked to the mirror wall in the next sector.
+				if (wall->adjoin < 0 || size_t(wall->adjoin) >= sectorCount) { return false; }
+				if (wall->mirror < 0 || wall->mirror >= geo->sectors[wall->adjoin].wallCount) { return false; }
+			}
+		}
+		return true;
+	}
+
+	void levelCache_clear(LevelCacheGeometry* geo)
+	{
+		geo->paletteName = -1;
+		geo->parallax0 = 0.0f;
+		geo->parallax1 = 0.0f;
+		geo->textures.clear();
+		geo->sectors.clear();
+		geo->vertices.clear();
+		geo->walls.clear();
+		geo->strings.clear();
+	}
+
+	s32 levelCache_addString(LevelCacheGeometry* geo, const char* str)
+	{
+		const s32 offset = (s32)geo->strings.size();
+		geo->strings.insert(geo->strings.end(), str, str + strlen(str) + 1);
+		return offset;
+	}
+
+	u64 levelCache_hash(const u8* data, size_t size)
+	{
+		return hashBytes(0xcbf29ce484222325ull, data, size);
+	}
+
+	bool levelCache_read(const char* levelName, u64 sourceHash, u32 sourceSize, LevelCacheGeometry* geo)
+	{
+		char cachePath[TFE_MAX_PATH];
+		getCachePath(levelName, sourceHash, cachePath);
+
+		FileStream file;
+		if (!file.open(cachePath, Stream::MODE_READ))
+		{
+			return false;
+		}
+
+		LevelCacheHeader header;
+		if (file.getSize() < sizeof(LevelCacheHeader) || file.readBuffer(&header, sizeof(LevelCacheHeader)) != sizeof(LevelCacheHeader))
+		{
+			file.close();
+			return false;
+		}
+		// A stale or partially written cache is simply ignored and rebuilt from the source.
+		if (header.magic != LEVEL_CACHE_MAGIC || header.version != LEVEL_CACHE_VERSION || header.engineHash != getEngineHash() ||
+			header.sourceHash != sourceHash || header.sourceSize != sourceSize || file.getSize() != getDataSize(header))
+		{
+			file.close();
+			return false;
+		}
+
+		geo->paletteName = header.paletteName;
+		geo->parallax0 = header.parallax0;
+		geo->parallax1 = header.parallax1;
+		geo->textures.resize(header.textureCount);
+		geo->sectors.resize(header.sectorCount);
+		geo->vertices.resize(header.vertexCount);
+		geo->walls.resize(header.wallCount);
+		geo->strings.resize(header.stringSize);
+
+		if (header.textureCount) { file.readBuffer(geo->textures.data(), sizeof(LevelCacheTexture), header.textureCount); }
+		if (header.sectorCount)  { file.readBuffer(geo->sectors.data(),  sizeof(LevelCacheSector),  header.sectorCount); }
+		if (header.vertexCount)  { file.readBuffer(geo->vertices.data(), sizeof(f32), header.vertexCount); }
+		if (header.wallCount)    { file.readBuffer(geo->walls.data(),    sizeof(LevelCacheWall),    header.wallCount); }
+		if (header.stringSize)   { file.readBuffer(geo->strings.data(),  header.stringSize); }
+		file.close();
+
+		if (!validateGeometry(geo))
+		{
+			TFE_System::logWrite(LOG_WARNING, "Level Cache", "Level cache '%s' is corrupt, the level will be parsed again.", cachePath);
+			levelCache_clear(geo);
+			return false;
+		}
+		return true;
+	}
+
+	void levelCache_write(const char* levelName, u64 sourceHash, u32 sourceSize, const LevelCacheGeometry* geo)
+	{
+		char cacheDir[TFE_MAX_PATH];
+		TFE_Paths::appendPath(PATH_PROGRAM_DATA, "Cache/", cacheDir);
+		if (!FileUtil::directoryExits(cacheDir))
+		{
+			FileUtil::makeDirectory(cacheDir);
+		}
+
+		char cachePath[TFE_MAX_PATH];
+		getCachePath(levelName, sourceHash, cachePath);
+
+		FileStream file;
+		if (!file.open(cachePath, Stream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_WARNING, "Level Cache", "Cannot write level cache '%s'.", cachePath);
+			return;
+		}
+
+		LevelCacheHeader header = {};
+		header.magic = LEVEL_CACHE_MAGIC;
+		header.version = LEVEL_CACHE_VERSION;
+		header.engineHash = getEngineHash();
+		header.sourceHash = sourceHash;
+		header.sourceSize = sourceSize;
+		header.paletteName = geo->paletteName;
+		header.parallax0 = geo->parallax0;
+		header.parallax1 = geo->parallax1;
+		header.textureCount = (u32)geo->textures.size();
+		header.sectorCount = (u32)geo->sectors.size();
+		header.vertexCount = (u32)geo->vertices.size();
+		header.wallCount = (u32)geo->walls.size();
+		header.stringSize = (u32)geo->strings.size();
+
+		file.writeBuffer(&header, sizeof(LevelCacheHeader));
+		if (header.textureCount) { file.writeBuffer(geo->textures.data(), sizeof(LevelCacheTexture), header.textureCount); }
+		if (header.sectorCount)  { file.writeBuffer(geo->sectors.data(),  sizeof(LevelCacheSector),  header.sectorCount); }
+		if (header.vertexCount)  { file.writeBuffer(geo->vertices.data(), sizeof(f32), header.vertexCount); }
+		if (header.wallCount)    { file.writeBuffer(geo->walls.data(),    sizeof(LevelCacheWall),    header.wallCount); }
+		if (header.stringSize)   { file.writeBuffer(geo->strings.data(),  header.stringSize); }
+		file.close();
+	}
+}
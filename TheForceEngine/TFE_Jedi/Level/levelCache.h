@@ -0,0 +1,86 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Level Cache
+// The parsed contents of a .LEV file in a flat form that can be
+// written to and read back from disk as-is. The text is only parsed
+// when the source changes, later loads read the cooked geometry from
+// ProgramData/Cache/ and then build the runtime sectors and walls the
+// same way as if the text had just been parsed.
+//
+// Cache files are keyed by a hash of the source data and the engine
+// version, so edited levels and new builds never use stale data. The
+// source hash is also part of the file name, so levels with the same
+// name in the base game and in mods each keep their own cache file.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <vector>
+
+namespace TFE_Jedi
+{
+	enum LevelCacheTextureType : s32
+	{
+		LTEX_NONE = 0,		// <NoTexture>
+		LTEX_NAMED,			// A texture name, loaded from the string table.
+		LTEX_DEFAULT,		// The texture line could not be read, 'default.bm' is used.
+	};
+
+	struct LevelCacheTexture
+	{
+		s32 type;
+		s32 name;			// offset into the string table.
+	};
+
+	struct LevelCacheSector
+	{
+		s32 id;
+		s32 name;			// offset into the string table or -1 if the sector is unnamed.
+		s32 ambient;
+		s32 floorTex;
+		f32 floorOffset[2];
+		f32 floorAlt;
+		s32 ceilTex;
+		f32 ceilOffset[2];
+		f32 ceilAlt;
+		f32 secondAlt;
+		u32 flags[3];
+		s32 layer;
+		s32 vertexCount;
+		s32 wallCount;
+	};
+
+	struct LevelCacheWall
+	{
+		s32 left, right;
+		s32 midTex, topTex, botTex, signTex;
+		f32 midOffset[2];
+		f32 topOffset[2];
+		f32 botOffset[2];
+		f32 signOffset[2];
+		s32 adjoin;
+		s32 mirror;
+		u32 flags[3];
+		s32 light;
+	};
+
+	// Vertices and walls are stored sector by sector, in the order they appear in the file.
+	struct LevelCacheGeometry
+	{
+		s32 paletteName;		// offset into the string table.
+		f32 parallax0;
+		f32 parallax1;
+
+		std::vector<LevelCacheTexture> textures;
+		std::vector<LevelCacheSector> sectors;
+		std::vector<f32> vertices;		// x, z pairs.
+		std::vector<LevelCacheWall> walls;
+		std::vector<char> strings;		// null terminated names.
+	};
+
+	void levelCache_clear(LevelCacheGeometry* geo);
+	s32  levelCache_addString(LevelCacheGeometry* geo, const char* str);
+
+	// Hash of the source data, used as the cache key together with the engine version.
+	u64  levelCache_hash(const u8* data, size_t size);
+	bool levelCache_read(const char* levelName, u64 sourceHash, u32 sourceSize, LevelCacheGeometry* geo);
+	void levelCache_write(const char* levelName, u64 sourceHash, u32 sourceSize, const LevelCacheGeometry* geo);
+}
@@ -8,7 +8,9 @@
 #include <TFE_Game/igame.h>
 #include <TFE_System/system.h>
 #include <TFE_Asset/spriteAsset_Jedi.h>
+#include <TFE_FileSystem/memorystream.h>
 #include <TFE_Jedi/Serialization/serialization.h>
+#include <vector>
 
 // TODO: coupling between Dark Forces and Jedi.
 using namespace TFE_DarkForces;
@@ -35,20 +37,41 @@ namespace TFE_Jedi
 
 	LevelState s_levelState = {};
 	LevelInternalState s_levelIntState = {};
+
+	// Serialized data of a sector from the previous incremental capture.
+	// The sector is serialized again only if its memory (the sector, walls and world space vertices)
+	// or one of the level texture slots it references has changed, animated textures change the slots.
+	struct SectorCapture
+	{
+		std::vector<u8> memory;
+		std::vector<u8> data;
+		std::vector<s32> textureSlots;
+	};
+	static bool s_incrementalCapture = false;
+	static std::vector<SectorCapture> s_sectorCapture;
+	static RSector* s_captureSectors = nullptr;
+	static TextureData** s_captureTextureBase = nullptr;
+	static std::vector<TextureData*> s_captureTextures;
+	static std::vector<u8> s_textureSlotChanged;
+	static MemoryStream s_sectorStream;
 	
 	void level_serializeSector(Stream* stream, RSector* sector);
 	void level_serializeSafe(Stream* stream, Safe* safe);
 	void level_serializeAmbientSound(Stream* stream, AmbientSound* sound);
 	void level_serializeWall(Stream* stream, RWall* wall, RSector* sector);
 	void level_serializeTextureList(Stream* stream);
+	void level_captureSectors(Stream* stream);
+	void level_clearCapture();
 
 	/////////////////////////////////////////////
 	// Implementation
 	/////////////////////////////////////////////
 	void level_clearData()
 	{
+		level_clearCapture();
 		s_levelState = { 0 };
 		s_levelIntState = { 0 };
+		sector_clearSpatialIndex();
 
 		s_levelState.controlSector = (RSector*)level_alloc(sizeof(RSector));
 		sector_clear(s_levelState.controlSector);
@@ -145,10 +168,21 @@ namespace TFE_Jedi
 
 			level_updateSecretPercent();
 		}
-		RSector* sector = s_levelState.sectors;
-		for (u32 s = 0; s < s_levelState.sectorCount; s++, sector++)
+		if (s_incrementalCapture && serialization_getMode() == SMODE_WRITE)
+		{
+			level_captureSectors(stream);
+		}
+		else
 		{
-			level_serializeSector(stream, sector);
+			RSector* sector = s_levelState.sectors;
+			for (u32 s = 0; s < s_levelState.sectorCount; s++, sector++)
+			{
+				level_serializeSector(stream, sector);
+			}
+		}
+		if (serialization_getMode() == SMODE_READ)
+		{
+			sector_buildSpatialIndex();
 		}
 
 		serialization_serializeSectorPtr(stream, LevelState_InitVersion, s_levelState.bossSector);
@@ -221,9 +255,119 @@ namespace TFE_Jedi
 		objData_serialize(stream);
 	}
 		
+	void level_setIncrementalCapture(bool enable)
+	{
+		s_incrementalCapture = enable;
+	}
+		
 	/////////////////////////////////////////////
 	// Internal - Serialize
 	/////////////////////////////////////////////
+	void level_clearCapture()
+	{
+		s_sectorCapture.clear();
+		s_captureSectors = nullptr;
+		s_captureTextureBase = nullptr;
+		s_captureTextures.clear();
+		s_textureSlotChanged.clear();
+	}
+
+	void level_addTextureSlot(std::vector<s32>& slots, TextureData** texData)
+	{
+		const std::ptrdiff_t offset = texData - s_levelState.textures;
+		if (texData && offset >= 0 && offset < s_levelState.textureCount)
+		{
+			slots.push_back(s32(offset));
+		}
+	}
+
+	bool level_sectorChanged(const RSector* sector, const SectorCapture* capture)
+	{
+		const size_t wallSize = sector->wallCount * sizeof(RWall);
+		const size_t vtxSize = sector->vertexCount * sizeof(vec2_fixed);
+		if (capture->memory.size() != sizeof(RSector) + wallSize + vtxSize) { return true; }
+
+		const u8* memory = capture->memory.data();
+		if (memcmp(memory, sector, sizeof(RSector)) != 0) { return true; }
+		memory += sizeof(RSector);
+		if (wallSize && memcmp(memory, sector->walls, wallSize) != 0) { return true; }
+		memory += wallSize;
+		if (vtxSize && memcmp(memory, sector->verticesWS, vtxSize) != 0) { return true; }
+
+		const size_t slotCount = capture->textureSlots.size();
+		for (size_t i = 0; i < slotCount; i++)
+		{
+			if (s_textureSlotChanged[capture->textureSlots[i]]) { return true; }
+		}
+		return false;
+	}
+
+	void level_updateSectorCapture(RSector* sector, SectorCapture* capture)
+	{
+		s_sectorStream.clear();
+		s_sectorStream.open(Stream::MODE_WRITE);
+		level_serializeSector(&s_sectorStream, sector);
+		s_sectorStream.close();
+		const u8* data = (const u8*)s_sectorStream.data();
+		capture->data.assign(data, data + s_sectorStream.getSize());
+
+		const size_t wallSize = sector->wallCount * sizeof(RWall);
+		const size_t vtxSize = sector->vertexCount * sizeof(vec2_fixed);
+		capture->memory.resize(sizeof(RSector) + wallSize + vtxSize);
+		u8* memory = capture->memory.data();
+		memcpy(memory, sector, sizeof(RSector));
+		if (wallSize) { memcpy(memory + sizeof(RSector), sector->walls, wallSize); }
+		if (vtxSize)  { memcpy(memory + sizeof(RSector) + wallSize, sector->verticesWS, vtxSize); }
+
+		capture->textureSlots.clear();
+		level_addTextureSlot(capture->textureSlots, sector->floorTex);
+		level_addTextureSlot(capture->textureSlots, sector->ceilTex);
+		const RWall* wall = sector->walls;
+		for (s32 w = 0; w < sector->wallCount; w++, wall++)
+		{
+			level_addTextureSlot(capture->textureSlots, wall->topTex);
+			level_addTextureSlot(capture->textureSlots, wall->midTex);
+			level_addTextureSlot(capture->textureSlots, wall->botTex);
+			level_addTextureSlot(capture->textureSlots, wall->signTex);
+		}
+	}
+
+	// Write the sectors the same way as level_serializeSector(), copying the data from the previous capture for unchanged sectors.
+	void level_captureSectors(Stream* stream)
+	{
+		const u32 sectorCount = s_levelState.sectorCount;
+		const s32 textureCount = s_levelState.textureCount;
+		if (s_captureSectors != s_levelState.sectors || s_sectorCapture.size() != sectorCount ||
+			s_captureTextureBase != s_levelState.textures || s_captureTextures.size() != size_t(textureCount))
+		{
+			level_clearCapture();
+			s_sectorCapture.resize(sectorCount);
+			s_captureSectors = s_levelState.sectors;
+			s_captureTextureBase = s_levelState.textures;
+			s_captureTextures.assign(s_levelState.textures, s_levelState.textures + textureCount);
+			s_textureSlotChanged.assign(textureCount, 0);
+		}
+		else
+		{
+			for (s32 i = 0; i < textureCount; i++)
+			{
+				s_textureSlotChanged[i] = s_captureTextures[i] != s_levelState.textures[i] ? 1 : 0;
+				s_captureTextures[i] = s_levelState.textures[i];
+			}
+		}
+
+		RSector* sector = s_levelState.sectors;
+		for (u32 s = 0; s < sectorCount; s++, sector++)
+		{
+			SectorCapture* capture = &s_sectorCapture[s];
+			if (level_sectorChanged(sector, capture))
+			{
+				level_updateSectorCapture(sector, capture);
+			}
+			stream->writeBuffer(capture->data.data(), u32(capture->data.size()));
+		}
+	}
+
 	void level_serializeTextureList(Stream* stream)
 	{
 		const bool read = serialization_getMode() == SMODE_READ;
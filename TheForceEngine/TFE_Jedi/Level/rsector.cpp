@@ -1,5 +1,8 @@
 #include <climits>
 #include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <vector>
 
 #include "rsector.h"
 #include "rwall.h"
@@ -32,7 +35,39 @@ namespace TFE_Jedi
 	JBool sector_canWallMove(RWall* wall, fixed16_16 offsetX, fixed16_16 offsetZ);
 	void sector_moveObjects(RSector* sector, u32 flags, fixed16_16 offsetX, fixed16_16 offsetZ);
 
+	void sector_refitSpatialIndex(RSector* sector);
+	void sector_setOccupied(RSector* sector, JBool occupied);
+
 	f32 isLeft(Vec2f p0, Vec2f p1, Vec2f p2);
+
+	/////////////////////////////////////////////////
+	// Sector spatial index
+	// A uniform grid over the sector XZ bounds, each cell lists the sectors whose bounds overlap it.
+	/////////////////////////////////////////////////
+	enum
+	{
+		SECTOR_GRID_MAX_DIM = 256,
+		SECTOR_GRID_CELLS_PER_SECTOR = 2,
+	};
+
+	struct SectorGridRect
+	{
+		s32 x0, z0;
+		s32 x1, z1;
+	};
+
+	static RSector* s_gridSectors = nullptr;
+	static u32 s_gridSectorCount = 0;
+	static fixed16_16 s_gridMinX = 0;
+	static fixed16_16 s_gridMinZ = 0;
+	static s64 s_gridCellSize = 0;
+	static s32 s_gridWidth = 0;
+	static s32 s_gridHeight = 0;
+	static std::vector<std::vector<s32>> s_gridCells;
+	// The cells each sector has been added to, which only grows as INF moves walls.
+	static std::vector<SectorGridRect> s_gridSectorRect;
+	// One bit per sector, set when the sector contains objects.
+	static std::vector<u32> s_occupiedSectors;
 	
 	/////////////////////////////////////////////////
 	// API Implementation
@@ -205,6 +240,8 @@ namespace TFE_Jedi
 		sector->boundsMax.x = maxX;
 		sector->boundsMin.z = minZ;
 		sector->boundsMax.z = maxZ;
+
+		sector_refitSpatialIndex(sector);
 	}
 
 	fixed16_16 sector_getMaxObjectHeight(RSector* sector)
@@ -412,6 +449,7 @@ namespace TFE_Jedi
 				obj->index = i;
 				obj->sector = sector;
 				sector->objectCount++;
+				sector_setOccupied(sector, JTRUE);
 				break;
 			}
 		}
@@ -478,6 +516,10 @@ namespace TFE_Jedi
 		SecObject** objList = sector->objectList;
 		objList[obj->index] = nullptr;
 		sector->objectCount--;
+		if (!sector->objectCount)
+		{
+			sector_setOccupied(sector, JFALSE);
+		}
 
 		if (!((obj->entityFlags & ETFLAG_PLAYER) && s_playerDying))
 		{
@@ -500,43 +542,222 @@ namespace TFE_Jedi
 		}
 	}
 	
+	s32 sector_getGridCoord(fixed16_16 value, fixed16_16 minValue, s32 dim)
+	{
+		const s64 coord = (s64(value) - s64(minValue)) / s_gridCellSize;
+		if (coord < 0) { return 0; }
+		return coord >= dim ? dim - 1 : s32(coord);
+	}
+
+	SectorGridRect sector_getGridRect(RSector* sector)
+	{
+		SectorGridRect rect;
+		rect.x0 = sector_getGridCoord(sector->boundsMin.x, s_gridMinX, s_gridWidth);
+		rect.z0 = sector_getGridCoord(sector->boundsMin.z, s_gridMinZ, s_gridHeight);
+		rect.x1 = sector_getGridCoord(sector->boundsMax.x, s_gridMinX, s_gridWidth);
+		rect.z1 = sector_getGridCoord(sector->boundsMax.z, s_gridMinZ, s_gridHeight);
+		return rect;
+	}
+
+	void sector_addToGrid(s32 index, const SectorGridRect& rect, const SectorGridRect* prevRect)
+	{
+		for (s32 z = rect.z0; z <= rect.z1; z++)
+		{
+			for (s32 x = rect.x0; x <= rect.x1; x++)
+			{
+				// Skip the cells the sector is already in.
+				if (prevRect && x >= prevRect->x0 && x <= prevRect->x1 && z >= prevRect->z0 && z <= prevRect->z1)
+				{
+					continue;
+				}
+				s_gridCells[z * s_gridWidth + x].push_back(index);
+			}
+		}
+	}
+
+	void sector_clearSpatialIndex()
+	{
+		s_gridSectors = nullptr;
+		s_gridSectorCount = 0;
+		s_gridCells.clear();
+		s_gridSectorRect.clear();
+		s_occupiedSectors.clear();
+	}
+
+	void sector_buildSpatialIndex()
+	{
+		sector_clearSpatialIndex();
+		const u32 sectorCount = s_levelState.sectorCount;
+		if (!sectorCount || !s_levelState.sectors) { return; }
+
+		RSector* sector = s_levelState.sectors;
+		fixed16_16 minX = sector->boundsMin.x, maxX = sector->boundsMax.x;
+		fixed16_16 minZ = sector->boundsMin.z, maxZ = sector->boundsMax.z;
+		sector++;
+		for (u32 i = 1; i < sectorCount; i++, sector++)
+		{
+			minX = min(minX, sector->boundsMin.x);
+			minZ = min(minZ, sector->boundsMin.z);
+			maxX = max(maxX, sector->boundsMax.x);
+			maxZ = max(maxZ, sector->boundsMax.z);
+		}
+
+		// Pick a square cell size so there are a few cells per sector, limited to SECTOR_GRID_MAX_DIM cells on each axis.
+		const f64 extentX = f64(s64(maxX) - s64(minX)) + 1.0;
+		const f64 extentZ = f64(s64(maxZ) - s64(minZ)) + 1.0;
+		f64 cellSize = sqrt(extentX * extentZ / f64(sectorCount * SECTOR_GRID_CELLS_PER_SECTOR));
+		cellSize = std::max(cellSize, std::max(extentX, extentZ) / f64(SECTOR_GRID_MAX_DIM));
+		cellSize = std::max(cellSize, f64(ONE_16));
+
+		s_gridMinX = minX;
+		s_gridMinZ = minZ;
+		s_gridCellSize = s64(ceil(cellSize));
+		s_gridWidth  = min(s32(ceil(extentX / f64(s_gridCellSize))), (s32)SECTOR_GRID_MAX_DIM);
+		s_gridHeight = min(s32(ceil(extentZ / f64(s_gridCellSize))), (s32)SECTOR_GRID_MAX_DIM);
+		s_gridWidth  = max(s_gridWidth, 1);
+		s_gridHeight = max(s_gridHeight, 1);
+		s_gridCells.resize(s_gridWidth * s_gridHeight);
+		s_gridSectorRect.resize(sectorCount);
+		s_occupiedSectors.resize((sectorCount + 31) >> 5, 0);
+
+		// Sectors are added in order, so each cell starts out sorted by sector index.
+		sector = s_levelState.sectors;
+		for (u32 i = 0; i < sectorCount; i++, sector++)
+		{
+			s_gridSectorRect[i] = sector_getGridRect(sector);
+			sector_addToGrid(s32(i), s_gridSectorRect[i], nullptr);
+			if (sector->objectCount > 0)
+			{
+				s_occupiedSectors[i >> 5] |= (1u << (i & 31));
+			}
+		}
+		s_gridSectors = s_levelState.sectors;
+		s_gridSectorCount = sectorCount;
+	}
+
+	void sector_setOccupied(RSector* sector, JBool occupied)
+	{
+		if (!s_gridSectors || sector < s_gridSectors || sector >= s_gridSectors + s_gridSectorCount) { return; }
+
+		const u32 index = u32(sector - s_gridSectors);
+		if (occupied) { s_occupiedSectors[index >> 5] |=  (1u << (index & 31)); }
+		else          { s_occupiedSectors[index >> 5] &= ~(1u << (index & 31)); }
+	}
+
+	s32 sector_getNextOccupied(u32 index)
+	{
+		const u32 sectorCount = s_levelState.sectorCount;
+		if (index >= sectorCount) { return -1; }
+		// Without a valid index every sector is treated as occupied.
+		if (!s_gridSectors || s_gridSectors != s_levelState.sectors || s_gridSectorCount != sectorCount) { return s32(index); }
+
+		const u32 wordCount = u32(s_occupiedSectors.size());
+		u32 word = index >> 5;
+		u32 bits = s_occupiedSectors[word] & (0xffffffffu << (index & 31));
+		while (!bits)
+		{
+			word++;
+			if (word >= wordCount) { return -1; }
+			bits = s_occupiedSectors[word];
+		}
+
+		u32 bit = 0;
+		while (!(bits & (1u << bit))) { bit++; }
+		const u32 next = (word << 5) + bit;
+		return next < sectorCount ? s32(next) : -1;
+	}
+
+	// Called when the sector bounds change, the sector is added to any new cells its bounds overlap.
+	// Sectors are never removed from cells, the bounds test in the query handles that.
+	void sector_refitSpatialIndex(RSector* sector)
+	{
+		if (!s_gridSectors || sector < s_gridSectors || sector >= s_gridSectors + s_gridSectorCount) { return; }
+
+		const s32 index = s32(sector - s_gridSectors);
+		SectorGridRect& prevRect = s_gridSectorRect[index];
+		const SectorGridRect rect = sector_getGridRect(sector);
+		if (rect.x0 >= prevRect.x0 && rect.x1 <= prevRect.x1 && rect.z0 >= prevRect.z0 && rect.z1 <= prevRect.z1)
+		{
+			return;
+		}
+
+		SectorGridRect newRect;
+		newRect.x0 = min(rect.x0, prevRect.x0);
+		newRect.z0 = min(rect.z0, prevRect.z0);
+		newRect.x1 = max(rect.x1, prevRect.x1);
+		newRect.z1 = max(rect.z1, prevRect.z1);
+		sector_addToGrid(index, newRect, &prevRect);
+		prevRect = newRect;
+	}
+
+	// Returns the sectors indices that may contain the point or null if every sector needs to be checked.
+	const std::vector<s32>* sector_getGridCell(fixed16_16 x, fixed16_16 z)
+	{
+		if (!s_gridSectors || s_gridSectors != s_levelState.sectors || s_gridSectorCount != s_levelState.sectorCount) { return nullptr; }
+
+		const s64 cellX = (s64(x) - s64(s_gridMinX)) / s_gridCellSize;
+		const s64 cellZ = (s64(z) - s64(s_gridMinZ)) / s_gridCellSize;
+		// Sectors whose bounds have grown past the grid are clamped to the edge cells, so points outside of the grid check everything.
+		if (x < s_gridMinX || z < s_gridMinZ || cellX >= s_gridWidth || cellZ >= s_gridHeight) { return nullptr; }
+		return &s_gridCells[cellZ * s_gridWidth + cellX];
+	}
+
+	// Pick the containing sector with the smallest area, ties go to the lowest sector index which matches the original linear search.
+	void sector_checkCandidate(RSector* sector, fixed16_16 ix, fixed16_16 iz, s32* prevSectorUnitArea, RSector** foundSector)
+	{
+		const fixed16_16 sectorMaxX = sector->boundsMax.x;
+		const fixed16_16 sectorMinX = sector->boundsMin.x;
+		const fixed16_16 sectorMaxZ = sector->boundsMax.z;
+		const fixed16_16 sectorMinZ = sector->boundsMin.z;
+		if (ix < sectorMinX || ix > sectorMaxX || iz < sectorMinZ || iz > sectorMaxZ)
+		{
+			return;
+		}
+
+		const s32 dxInt = floor16(sectorMaxX - sectorMinX) + 1;
+		const s32 dzInt = floor16(sectorMaxZ - sectorMinZ) + 1;
+		const s32 sectorUnitArea = dzInt * dxInt;
+		const JBool isSmaller = sectorUnitArea < *prevSectorUnitArea || (sectorUnitArea == *prevSectorUnitArea && sector < *foundSector);
+		if (isSmaller && sector_pointInsideDF(sector, ix, iz))
+		{
+			*prevSectorUnitArea = sectorUnitArea;
+			*foundSector = sector;
+		}
+	}
+
 	RSector* sector_which3D(fixed16_16 dx, fixed16_16 dy, fixed16_16 dz)
 	{
 		fixed16_16 ix = dx;
 		fixed16_16 iz = dz;
 		fixed16_16 y = dy;
 		
-		RSector* sector = s_levelState.sectors;
 		RSector* foundSector = nullptr;
-		s32 sectorUnitArea = 0;
 		s32 prevSectorUnitArea = INT_MAX;
 
-		for (u32 i = 0; i < s_levelState.sectorCount; i++, sector++)
+		const std::vector<s32>* cell = sector_getGridCell(ix, iz);
+		if (cell)
 		{
-			if (y >= sector->ceilingHeight && y <= sector->floorHeight)
+			const size_t count = cell->size();
+			const s32* index = cell->data();
+			for (size_t i = 0; i < count; i++)
 			{
-				const fixed16_16 sectorMaxX = sector->boundsMax.x;
-				const fixed16_16 sectorMinX = sector->boundsMin.x;
-				const fixed16_16 sectorMaxZ = sector->boundsMax.z;
-				const fixed16_16 sectorMinZ = sector->boundsMin.z;
-
-				const s32 dxInt = floor16(sectorMaxX - sectorMinX) + 1;
-				const s32 dzInt = floor16(sectorMaxZ - sectorMinZ) + 1;
-				sectorUnitArea = dzInt * dxInt;
-				
-				s32 insideBounds = 0;
-				if (ix >= sectorMinX && ix <= sectorMaxX && iz >= sectorMinZ && iz <= sectorMaxZ)
+				RSector* sector = &s_levelState.sectors[index[i]];
+				if (y >= sector->ceilingHeight && y <= sector->floorHeight)
 				{
-					// pick the containing sector with the smallest area.
-					if (sectorUnitArea < prevSectorUnitArea && sector_pointInsideDF(sector, ix, iz))
-					{
-						prevSectorUnitArea = sectorUnitArea;
-						foundSector = sector;
-					}
+					sector_checkCandidate(sector, ix, iz, &prevSectorUnitArea, &foundSector);
 				}
 			}
+			return foundSector;
 		}
 
+		RSector* sector = s_levelState.sectors;
+		for (u32 i = 0; i < s_levelState.sectorCount; i++, sector++)
+		{
+			if (y >= sector->ceilingHeight && y <= sector->floorHeight)
+			{
+				sector_checkCandidate(sector, ix, iz, &prevSectorUnitArea, &foundSector);
+			}
+		}
 		return foundSector;
 	}
 
@@ -545,37 +766,33 @@ namespace TFE_Jedi
 		fixed16_16 ix = dx;
 		fixed16_16 iz = dz;
 
-		RSector* sector = s_levelState.sectors;
 		RSector* foundSector = nullptr;
-		s32 sectorUnitArea = 0;
 		s32 prevSectorUnitArea = INT_MAX;
 
-		for (u32 i = 0; i < s_levelState.sectorCount; i++, sector++)
+		const std::vector<s32>* cell = sector_getGridCell(ix, iz);
+		if (cell)
 		{
-			if (sector->layer == layer)
+			const size_t count = cell->size();
+			const s32* index = cell->data();
+			for (size_t i = 0; i < count; i++)
 			{
-				const fixed16_16 sectorMaxX = sector->boundsMax.x;
-				const fixed16_16 sectorMinX = sector->boundsMin.x;
-				const fixed16_16 sectorMaxZ = sector->boundsMax.z;
-				const fixed16_16 sectorMinZ = sector->boundsMin.z;
-
-				const s32 dxInt = floor16(sectorMaxX - sectorMinX) + 1;
-				const s32 dzInt = floor16(sectorMaxZ - sectorMinZ) + 1;
-				sectorUnitArea = dzInt * dxInt;
-
-				s32 insideBounds = 0;
-				if (ix >= sectorMinX && ix <= sectorMaxX && iz >= sectorMinZ && iz <= sectorMaxZ)
+				RSector* sector = &s_levelState.sectors[index[i]];
+				if (sector->layer == layer)
 				{
-					// pick the containing sector with the smallest area.
-					if (sectorUnitArea < prevSectorUnitArea && sector_pointInsideDF(sector, ix, iz))
-					{
-						prevSectorUnitArea = sectorUnitArea;
-						foundSector = sector;
-					}
+					sector_checkCandidate(sector, ix, iz, &prevSectorUnitArea, &foundSector);
 				}
 			}
+			return foundSector;
 		}
 
+		RSector* sector = s_levelState.sectors;
+		for (u32 i = 0; i < s_levelState.sectorCount; i++, sector++)
+		{
+			if (sector->layer == layer)
+			{
+				sector_checkCandidate(sector, ix, iz, &prevSectorUnitArea, &foundSector);
+			}
+		}
 		return foundSector;
 	}
 
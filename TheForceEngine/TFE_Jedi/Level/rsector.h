@@ -153,6 +153,13 @@ namespace TFE_Jedi
 	void sector_addObjectDirect(RSector* sector, SecObject* obj);
 	void sector_removeObject(SecObject* obj);
 	
+	// Spatial index used by sector_which3D() and sector_which3D_Map(), built once the level geometry is loaded.
+	void sector_buildSpatialIndex();
+	void sector_clearSpatialIndex();
+	// Returns the first sector index at or after 'index' that contains objects, or -1 if there are none.
+	// This reflects the current state, so it is safe to use while objects are added or removed.
+	s32  sector_getNextOccupied(u32 index);
+
 	RSector* sector_which3D(fixed16_16 dx, fixed16_16 dy, fixed16_16 dz);
 	RSector* sector_which3D_Map(fixed16_16 dx, fixed16_16 dz, s32 layer);
 	bool sector_pointInside(RSector* sector, fixed16_16 x, fixed16_16 z);
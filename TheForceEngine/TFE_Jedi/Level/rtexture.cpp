@@ -5,11 +5,13 @@
 #include <TFE_System/system.h>
 #include <TFE_Archive/archive.h>
 #include <TFE_Asset/assetSystem.h>
+#include <TFE_Asset/assetCache.h>
 #include <TFE_FileSystem/paths.h>
 #include <TFE_FileSystem/filestream.h>
 #include <TFE_Jedi/Task/task.h>
 #include <TFE_Jedi/Serialization/serialization.h>
 #include <TFE_System/math.h>
+#include <TFE_System/jobSystem.h>
 #include <unordered_map>
 
 using namespace TFE_DarkForces;
@@ -27,6 +29,7 @@ namespace TFE_Jedi
 	{
 		std::string name;
 		TextureData* texture;
+		std::string key;	// asset cache key, empty if the texture is not cached.
 	};
 	typedef std::vector<LevelTexture> TextureList;
 	typedef std::unordered_map<std::string, s32> TextureTable;
@@ -42,12 +45,28 @@ namespace TFE_Jedi
 	static std::vector<u8> s_buffer;
 	static std::vector<TextureData*> s_tempTextureList;
 
+	// A texture read and allocated by bitmap_prefetch() while its image is decoded by a job.
+	struct PendingTexture
+	{
+		TextureData* texture;
+		MemoryRegion* region;	// region the texture was allocated from.
+		const u8* data;
+		u32 decompress;
+		std::vector<u8> buffer;	// file contents, if the archive is not memory-mapped.
+		std::string key;
+	};
+	typedef std::unordered_map<std::string, PendingTexture*> PendingTextureMap;
+
 	static TextureList  s_textureList[POOL_COUNT];
 	static TextureTable s_textureTable[POOL_COUNT];
+	static PendingTextureMap s_pendingTextures[POOL_COUNT];
 
 	void decompressColumn_Type1(const u8* src, u8* dst, s32 pixelCount);
 	void decompressColumn_Type2(const u8* src, u8* dst, s32 pixelCount);
 	void textureAnimationTaskFunc(MessageType msg);
+	void bitmap_clearPending(AssetPool pool);
+	void bitmap_cacheLevelTextures();
+	TextureData* bitmap_loadTexture(const char* name, u32 decompress, AssetPool pool, std::string& key);
 
 	u8 readByte(const u8*& data)
 	{
@@ -102,8 +121,10 @@ namespace TFE_Jedi
 	// Added for TFE to clear out per-level texture data.
 	void bitmap_clearLevelData()
 	{
+		bitmap_cacheLevelTextures();
 		s_textureList[POOL_LEVEL].clear();
 		s_textureTable[POOL_LEVEL].clear();
+		bitmap_clearPending(POOL_LEVEL);
 	}
 
 	void bitmap_clearAll()
@@ -113,6 +134,7 @@ namespace TFE_Jedi
 		{
 			s_textureList[p].clear();
 			s_textureTable[p].clear();
+			bitmap_clearPending(AssetPool(p));
 		}
 	}
 
@@ -176,7 +198,7 @@ namespace TFE_Jedi
 			if (serialization_getMode() == SMODE_READ)
 			{
 				const char* name = list->name.c_str();
-				list->texture = bitmap_load(name, 1, POOL_LEVEL, false);
+				list->texture = bitmap_loadTexture(name, 1, POOL_LEVEL, list->key);
 				s_textureTable[POOL_LEVEL][name] = i;
 			}
 		}
@@ -197,51 +219,27 @@ namespace TFE_Jedi
 		return list;
 	}
 
-	TextureData* bitmap_load(const char* name, u32 decompress, AssetPool pool, bool addToCache)
+	// Read the BM header and allocate the texture and its image.
+	// On return 'data' points to the compressed size (or padding), which is where bitmap_decodeImage() starts reading.
+	TextureData* bitmap_allocFromHeader(const u8*& data, u32 decompress, const char* name)
 	{
-		// TFE: Keep track of per-level texture state for serialization.
-		// This is also useful for handling per-level GPU texture mirrors.
-		TextureTable::iterator iTex = s_textureTable[pool].find(name);
-		if (iTex != s_textureTable[pool].end())
-		{
-			return s_textureList[pool][iTex->second].texture;
-		}
-
-		FilePath filepath;
-		if (!TFE_Paths::getFilePath(name, &filepath))
-		{
-			return nullptr;
-		}
-
-		FileStream file;
-		if (!file.open(&filepath, Stream::MODE_READ))
-		{
-			return nullptr;
-		}
-
-		size_t size = file.getSize();
-		s_buffer.resize(size);
-		file.readBuffer(s_buffer.data(), (u32)size);
-		file.close();
-
-		TextureData* texture = (TextureData*)region_alloc(s_texState.memoryRegion, sizeof(TextureData));
-		const u8* data = s_buffer.data();
 		const u8* fheader = data;
 		data += 3;
 
 		if (strncmp((char*)fheader, "BM ", 3))
 		{
-			TFE_System::logWrite(LOG_ERROR, "bitmap_load", "File '%s' is not a valid BM file.", filepath);
+			TFE_System::logWrite(LOG_ERROR, "bitmap_load", "File '%s' is not a valid BM file.", name);
 			return nullptr;
 		}
 
 		u8 version = readByte(data);
 		if (version != DF_BM_VERSION)
 		{
-			TFE_System::logWrite(LOG_ERROR, "bitmap_load", "File '%s' has invalid BM version '%u'.", filepath, version);
+			TFE_System::logWrite(LOG_ERROR, "bitmap_load", "File '%s' has invalid BM version '%u'.", name, version);
 			return nullptr;
 		}
 
+		TextureData* texture = (TextureData*)region_alloc(s_texState.memoryRegion, sizeof(TextureData));
 		texture->width = readUShort(data);
 		texture->height = readUShort(data);
 		texture->uvWidth = readShort(data);
@@ -252,7 +250,30 @@ namespace TFE_Jedi
 		texture->animSetup = 0;
 		// value is ignored.
 		data++;
-		
+
+		texture->columns = nullptr;
+		if (texture->compressed && !(decompress & 1))
+		{
+			const u8* sizePtr = data;
+			texture->dataSize = readInt(sizePtr);
+			texture->columns = (u32*)region_alloc(s_texState.memoryRegion, texture->width * sizeof(u32));
+		}
+		else
+		{
+			texture->dataSize = texture->width * texture->height;
+		}
+		texture->image = (u8*)region_alloc(s_texState.memoryRegion, texture->dataSize);
+
+		texture->animIndex = -1;
+		texture->frameIdx = -1;
+		texture->animPtr = nullptr;
+		return texture;
+	}
+
+	// Fill in the image and columns allocated by bitmap_allocFromHeader().
+	// This only writes to memory owned by the texture, so it can run on a worker thread.
+	void bitmap_decodeImage(TextureData* texture, const u8* data, u32 decompress)
+	{
 		if (texture->compressed)
 		{
 			s32 inSize = readInt(data);
@@ -261,9 +282,6 @@ namespace TFE_Jedi
 
 			if (decompress & 1)
 			{
-				texture->dataSize = texture->width * texture->height;
-				texture->image = (u8*)region_alloc(s_texState.memoryRegion, texture->dataSize);
-
 				const u8* inBuffer = data;
 				data += inSize;
 
@@ -289,48 +307,226 @@ namespace TFE_Jedi
 					}
 				}
 				texture->compressed = 0;
-				texture->columns = nullptr;
 			}
 			else
 			{
-				texture->dataSize = inSize;
-				texture->image = (u8*)region_alloc(s_texState.memoryRegion, texture->dataSize);
 				memcpy(texture->image, data, texture->dataSize);
 				data += texture->dataSize;
 
-				texture->columns = (u32*)region_alloc(s_texState.memoryRegion, texture->width * sizeof(u32));
 				memcpy(texture->columns, data, texture->width * sizeof(u32));
 				data += texture->width * sizeof(u32);
 			}
 		}
 		else
 		{
-			texture->dataSize = texture->width * texture->height;
 			// Datasize, ignored.
 			data += 4;
-			texture->columns = nullptr;
-
 			// Padding, ignored.
 			data += 12;
 
-			// Allocate and read the BM image.
-			texture->image = (u8*)region_alloc(s_texState.memoryRegion, texture->dataSize);
+			// Read the BM image.
 			memcpy(texture->image, data, texture->dataSize);
 			data += texture->dataSize;
 		}
+	}
+
+	// Only decompressed level textures are kept in the asset cache, 'key' is left empty for the others.
+	void bitmap_getCacheKey(const FilePath* filePath, u32 decompress, AssetPool pool, std::string& key)
+	{
+		key.clear();
+		if (pool == POOL_LEVEL && (decompress & 1))
+		{
+			TFE_AssetCache::buildKey(TFE_AssetCache::ACACHE_TEXTURE, filePath, key);
+		}
+	}
+
+	void bitmap_freeCached(void* cached)
+	{
+		free(cached);
+	}
+
+	// Copy a cached texture into the current memory region and free the cached copy, returns null if it is not cached.
+	TextureData* bitmap_restoreCached(const std::string& key)
+	{
+		if (key.empty()) { return nullptr; }
+		size_t size;
+		u8* cached = (u8*)TFE_AssetCache::take(key, &size);
+		if (!cached) { return nullptr; }
+
+		TextureData* texture = (TextureData*)region_alloc(s_texState.memoryRegion, sizeof(TextureData));
+		memcpy(texture, cached, sizeof(TextureData));
+		texture->image = (u8*)region_alloc(s_texState.memoryRegion, texture->dataSize);
+		memcpy(texture->image, cached + sizeof(TextureData), texture->dataSize);
+		free(cached);
+		return texture;
+	}
+
+	void bitmap_addToCache(const std::string& key, const TextureData* texture)
+	{
+		// Animated textures are changed in place when they are setup and point into level memory, so they are always loaded again.
+		if (key.empty() || !texture || texture->animSetup || texture->compressed) { return; }
+
+		const size_t size = sizeof(TextureData) + texture->dataSize;
+		u8* cached = (u8*)malloc(size);
+		memcpy(cached, texture, sizeof(TextureData));
+		memcpy(cached + sizeof(TextureData), texture->image, texture->dataSize);
+		TFE_AssetCache::add(key, cached, size, bitmap_freeCached);
+	}
+
+	// Copy the level textures into the asset cache before the level memory is cleared.
+	void bitmap_cacheLevelTextures()
+	{
+		const size_t count = s_textureList[POOL_LEVEL].size();
+		const LevelTexture* list = s_textureList[POOL_LEVEL].data();
+		for (size_t i = 0; i < count; i++)
+		{
+			bitmap_addToCache(list[i].key, list[i].texture);
+		}
+	}
+
+	void bitmap_decodeJob(void* userData)
+	{
+		PendingTexture* pending = (PendingTexture*)userData;
+		bitmap_decodeImage(pending->texture, pending->data, pending->decompress);
+	}
+
+	void bitmap_prefetch(const char* name, u32 decompress, atomic_s32* counter, AssetPool pool)
+	{
+		if (s_textureTable[pool].find(name) != s_textureTable[pool].end() ||
+			s_pendingTextures[pool].find(name) != s_pendingTextures[pool].end())
+		{
+			return;
+		}
+
+		FilePath filepath;
+		if (!TFE_Paths::getFilePath(name, &filepath))
+		{
+			return;
+		}
+
+		// Textures kept from a previous level only need to be copied into the level memory.
+		PendingTexture* pending = new PendingTexture();
+		pending->region = s_texState.memoryRegion;
+		pending->decompress = decompress;
+		bitmap_getCacheKey(&filepath, decompress, pool, pending->key);
+		pending->texture = bitmap_restoreCached(pending->key);
+		if (pending->texture)
+		{
+			pending->data = nullptr;
+			s_pendingTextures[pool][name] = pending;
+			return;
+		}
+
+		// The file is read and the memory allocated here, only the decoding is done by the job.
+		size_t size;
+		const u8* data = FileStream::readContentsView(&filepath, pending->buffer, &size);
+		pending->texture = data ? bitmap_allocFromHeader(data, decompress, name) : nullptr;
+		if (!pending->texture)
+		{
+			delete pending;
+			return;
+		}
+		pending->data = data;
+
+		s_pendingTextures[pool][name] = pending;
+		TFE_Jobs::addJob(bitmap_decodeJob, pending, counter);
+	}
+
+	void bitmap_clearPending(AssetPool pool)
+	{
+		PendingTextureMap::iterator iPending = s_pendingTextures[pool].begin();
+		for (; iPending != s_pendingTextures[pool].end(); ++iPending)
+		{
+			delete iPending->second;
+		}
+		s_pendingTextures[pool].clear();
+	}
+
+	void bitmap_releasePending(AssetPool pool)
+	{
+		PendingTextureMap::iterator iPending = s_pendingTextures[pool].begin();
+		for (; iPending != s_pendingTextures[pool].end(); ++iPending)
+		{
+			PendingTexture* pending = iPending->second;
+			TextureData* texture = pending->texture;
+			bitmap_addToCache(pending->key, texture);
+
+			if (texture->columns) { region_free(pending->region, texture->columns); }
+			region_free(pending->region, texture->image);
+			region_free(pending->region, texture);
+			delete pending;
+		}
+		s_pendingTextures[pool].clear();
+	}
+
+	// Load a texture without adding it to the level texture list, 'key' is set to its asset cache key.
+	TextureData* bitmap_loadTexture(const char* name, u32 decompress, AssetPool pool, std::string& key)
+	{
+		key.clear();
+		// Textures decoded by bitmap_prefetch() are added to the cache when first requested, so the order matches loading them one at a time.
+		PendingTextureMap::iterator iPending = s_pendingTextures[pool].find(name);
+		if (iPending != s_pendingTextures[pool].end() && iPending->second->decompress == decompress)
+		{
+			TextureData* texture = iPending->second->texture;
+			key.swap(iPending->second->key);
+			delete iPending->second;
+			s_pendingTextures[pool].erase(iPending);
+			return texture;
+		}
+
+		FilePath filepath;
+		if (!TFE_Paths::getFilePath(name, &filepath))
+		{
+			return nullptr;
+		}
+		bitmap_getCacheKey(&filepath, decompress, pool, key);
+		TextureData* texture = bitmap_restoreCached(key);
+		if (texture)
+		{
+			return texture;
+		}
+
+		// Parse directly from the archive when it is memory-mapped.
+		size_t size;
+		const u8* data = FileStream::readContentsView(&filepath, s_buffer, &size);
+		if (!data)
+		{
+			return nullptr;
+		}
+
+		texture = bitmap_allocFromHeader(data, decompress, name);
+		if (!texture)
+		{
+			return nullptr;
+		}
+		bitmap_decodeImage(texture, data, decompress);
+		return texture;
+	}
+
+	TextureData* bitmap_load(const char* name, u32 decompress, AssetPool pool, bool addToCache)
+	{
+		// TFE: Keep track of per-level texture state for serialization.
+		// This is also useful for handling per-level GPU texture mirrors.
+		TextureTable::iterator iTex = s_textureTable[pool].find(name);
+		if (iTex != s_textureTable[pool].end())
+		{
+			return s_textureList[pool][iTex->second].texture;
+		}
+
+		std::string key;
+		TextureData* texture = bitmap_loadTexture(name, decompress, pool, key);
+		if (!texture)
+		{
+			return nullptr;
+		}
 
 		// Add the texture to the level texture cache if appropriate.
 		if (addToCache)
 		{
 			s32 index = (s32)s_textureList[pool].size();
-			s_textureList[pool].push_back({ name, texture });
+			s_textureList[pool].push_back({ name, texture, key });
 			s_textureTable[pool][name] = index;
 		}
-
-		texture->animIndex = -1;
-		texture->frameIdx = -1;
-		texture->animPtr = nullptr;
-
 		return texture;
 	}
 
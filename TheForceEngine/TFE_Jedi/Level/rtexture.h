@@ -93,6 +93,11 @@ namespace TFE_Jedi
 	// levelTexture bool was added for TFE to make serializing texture state easier.
 	// if levelTexture is false, then textures are not serialized and not cleared at level end.
 	TextureData* bitmap_load(const char* name, u32 decompress, AssetPool pool = POOL_LEVEL, bool addToCache = true);
+	// Read and allocate a texture now and decode it on a worker thread, the job is added to 'counter'.
+	// bitmap_load() picks up the texture, which must wait for the counter to reach zero first.
+	void bitmap_prefetch(const char* name, u32 decompress, atomic_s32* counter, AssetPool pool = POOL_LEVEL);
+	// Free prefetched textures that were not loaded, their jobs must be finished. Decoded images are kept in the asset cache.
+	void bitmap_releasePending(AssetPool pool = POOL_LEVEL);
 	bool bitmap_setupAnimatedTexture(TextureData** texture, s32 index);
 
 	Allocator* bitmap_getAnimatedTextures();
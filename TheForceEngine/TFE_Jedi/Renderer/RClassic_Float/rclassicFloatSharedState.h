@@ -10,6 +10,8 @@
 #include <TFE_Jedi/Renderer/rlimits.h>
 #include <TFE_Jedi/Renderer/rwallSegment.h>
 
+struct SecObject;
+
 namespace TFE_Jedi
 {
 	struct RClassicFloatState
@@ -54,13 +56,25 @@ namespace TFE_Jedi
 
 		// Flats
 		EdgePairFloat* flatEdge;
-		EdgePairFloat  flatEdgeList[MAX_SEG_EXT];
+		EdgePairFloat* flatEdgeList;
 		EdgePairFloat* adjoinEdge;
 		EdgePairFloat* adjoinEdgeList;
 
-		RWallSegmentFloat   wallSegListDst[MAX_SEG_EXT];
-		RWallSegmentFloat   wallSegListSrc[MAX_SEG_EXT];
+		RWallSegmentFloat*  wallSegListDst;
+		RWallSegmentFloat*  wallSegListSrc;	// shared by all threads.
 		RWallSegmentFloat** adjoinSegment;
+
+		// Screen strip drawn by the current thread.
+		s32 stripX0;
+		s32 stripX1;
+		// Frame markers, indexed by sector and cached wall index.
+		// These replace RSector::prevDrawFrame2 and RWall::drawFrame so that threads do not share them.
+		s32* sectorDrawFrame;
+		s32* wallDrawFrame;
+		// Objects drawn by the current thread (used for auto-aim).
+		SecObject** drawnObj;
+		s32* drawnObjCount;
 	};
-	extern RClassicFloatState s_rcfltState;
+	// Each thread drawing a screen strip has its own copy, the main thread copy holds the frame setup.
+	extern thread_local RClassicFloatState s_rcfltState;
 }  // TFE_Jedi
\ No newline at end of file
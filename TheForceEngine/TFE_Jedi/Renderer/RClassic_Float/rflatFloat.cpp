@@ -18,23 +18,23 @@ namespace TFE_Jedi
 
 namespace RClassic_Float
 {
-	static s32 s_scanlineX0;
-
-	static fixed44_20 s_scanlineU0;
-	static fixed44_20 s_scanlineV0;
-	static fixed44_20 s_scanline_dUdX;
-	static fixed44_20 s_scanline_dVdX;
-
-	static s32 s_scanlineWidth;
-	static const u8* s_scanlineLight;
-	static u8* s_scanlineOut;
-
-	static u8* s_ftexImage;
-	static s32 s_ftexDataEnd;
-	static s32 s_ftexHeight;
-	static s32 s_ftexWidthMask;
-	static s32 s_ftexHeightMask;
-	static s32 s_ftexHeightLog2;
+	static thread_local s32 s_scanlineX0;
+
+	static thread_local fixed44_20 s_scanlineU0;
+	static thread_local fixed44_20 s_scanlineV0;
+	static thread_local fixed44_20 s_scanline_dUdX;
+	static thread_local fixed44_20 s_scanline_dVdX;
+
+	static thread_local s32 s_scanlineWidth;
+	static thread_local const u8* s_scanlineLight;
+	static thread_local u8* s_scanlineOut;
+
+	static thread_local u8* s_ftexImage;
+	static thread_local s32 s_ftexDataEnd;
+	static thread_local s32 s_ftexHeight;
+	static thread_local s32 s_ftexWidthMask;
+	static thread_local s32 s_ftexHeightMask;
+	static thread_local s32 s_ftexHeightLog2;
 		
 	void flat_addEdges(s32 length, s32 x0, f32 dyFloor_dx, f32 yFloor, f32 dyCeil_dx, f32 yCeil)
 	{
@@ -304,15 +304,15 @@ namespace RClassic_Float
 		drawScanline_Fullbright_Trans
 	};
 
-	static f32 s_poly_offsetX;
-	static f32 s_poly_offsetZ;
+	static thread_local f32 s_poly_offsetX;
+	static thread_local f32 s_poly_offsetZ;
 
-	static f32 s_poly_scaledHOffset;
-	static f32 s_poly_sinYawHOffset;
-	static f32 s_poly_cosYawHOffset;
+	static thread_local f32 s_poly_scaledHOffset;
+	static thread_local f32 s_poly_sinYawHOffset;
+	static thread_local f32 s_poly_cosYawHOffset;
 
-	static f32 s_poly_cosYawScaledHOffset;
-	static f32 s_poly_sinYawScaledHOffset;
+	static thread_local f32 s_poly_cosYawScaledHOffset;
+	static thread_local f32 s_poly_sinYawScaledHOffset;
 		
 	void flat_preparePolygon(f32 heightOffset, f32 offsetX, f32 offsetZ, TextureData* texture)
 	{
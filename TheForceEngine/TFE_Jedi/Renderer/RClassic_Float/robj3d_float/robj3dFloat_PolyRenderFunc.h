@@ -347,7 +347,7 @@ void robj3d_drawFlatColorPolygon(vec3_float* projVertices, s32 vertexCount, u8 c
 
 	if (FIND_NEXT_EDGE(minXIndex, xMin) != 0 || FIND_PREV_EDGE(minXIndex) != 0) { return; }
 
-	for (s32 foundEdge = 0; !foundEdge && s_columnX >= s_minScreenX_Pixels && s_columnX <= s_maxScreenX_Pixels; s_columnX++)
+	for (s32 foundEdge = 0; !foundEdge && s_columnX >= s_rcfltState.stripX0 && s_columnX <= s_rcfltState.stripX1; s_columnX++)
 	{
 		const f32 edgeMinZ = min(s_edgeBot_Z0, s_edgeTop_Z0);
 		const f32 z = s_rcfltState.depth1d[s_columnX];
@@ -11,10 +11,10 @@ namespace TFE_Jedi
 
 namespace RClassic_Float
 {
-	vec3_float s_polygonVerticesVS[POLY_MAX_VTX_COUNT];
-	vec3_float s_polygonVerticesProj[POLY_MAX_VTX_COUNT];
-	vec2_float s_polygonUv[POLY_MAX_VTX_COUNT];
-	f32 s_polygonIntensity[POLY_MAX_VTX_COUNT];
+	thread_local vec3_float s_polygonVerticesVS[POLY_MAX_VTX_COUNT];
+	thread_local vec3_float s_polygonVerticesProj[POLY_MAX_VTX_COUNT];
+	thread_local vec2_float s_polygonUv[POLY_MAX_VTX_COUNT];
+	thread_local f32 s_polygonIntensity[POLY_MAX_VTX_COUNT];
 
 	void robj3d_setupPolygon(JmPolygon* polygon)
 	{
@@ -20,16 +20,16 @@ namespace RClassic_Float
 	// Vertex Processing
 	/////////////////////////////////////////////
 	// Vertex attributes transformed to viewspace.
-	std::vector<vec3_float> s_verticesVS;
-	std::vector<vec3_float> s_vertexNormalsVS;
+	thread_local std::vector<vec3_float> s_verticesVS;
+	thread_local std::vector<vec3_float> s_vertexNormalsVS;
 	// Vertex Lighting.
-	std::vector<f32> s_vertexIntensity;
+	thread_local std::vector<f32> s_vertexIntensity;
 
 	/////////////////////////////////////////////
 	// Polygon Processing
 	/////////////////////////////////////////////
 	// Polygon normals in viewspace (used for culling).
-	std::vector<vec3_float> s_polygonNormalsVS;
+	thread_local std::vector<vec3_float> s_polygonNormalsVS;
 			
 	void robj3d_transformVertices(s32 vertexCount, vec3_fixed* vtxIn, f32* xform, vec3_float* offset, vec3_float* vtxOut)
 	{
@@ -1,6 +1,8 @@
 #include <cstring>
+#include <mutex>
 
 #include <TFE_System/profiler.h>
+#include <TFE_System/jobSystem.h>
 #include <TFE_Asset/modelAsset_jedi.h>
 #include <TFE_Game/igame.h>
 #include <TFE_Jedi/Level/level.h>
@@ -19,15 +21,50 @@
 #include "rclassicFloatSharedState.h"
 #include "robj3d_float/robj3dFloat.h"
 #include "../rcommon.h"
+#include "../jediRenderer.h"
 
 using namespace TFE_Jedi::RClassic_Float;
 #define PTR_OFFSET(ptr, base) size_t((u8*)ptr - (u8*)base)
+#define MAX_RENDER_STRIPS 16
+#define MIN_STRIP_WIDTH 32
 
 namespace TFE_Jedi
 {
+	// A vertical strip of the screen drawn on a job thread.
+	// Each strip traverses the sectors on its own, using the sector cache owned by the main renderer.
+	struct RenderStrip
+	{
+		TFE_Sectors_Float sectors;
+		RSector* rootSector;
+		s32 x0;
+		s32 x1;
+
+		// Per-thread buffers, allocated for the full screen width so they can be indexed by screen column.
+		s32 width;
+		s32* columnTop;
+		s32* columnBot;
+		s32* windowTop_all;
+		s32* windowBot_all;
+		f32* depth1d_all;
+		EdgePairFloat* flatEdgeList;
+		EdgePairFloat* adjoinEdgeList;
+		RWallSegmentFloat* wallSegListDst;
+
+		SecObject* drawnObj[MAX_DRAWN_OBJ_STORE];
+		s32 drawnObjCount;
+	};
+
 	namespace
 	{
-		static TFE_Sectors_Float* s_ctx = nullptr;
+		static thread_local TFE_Sectors_Float* s_ctx = nullptr;
+
+		// Strip 0 is always drawn by the main thread.
+		static RenderStrip* s_strips[MAX_RENDER_STRIPS] = { 0 };
+		// Frame state copied by each strip thread.
+		static RClassicFloatState s_frameState;
+		// Sectors are processed once per frame by whichever strip reaches them first.
+		static std::mutex s_sectorLock;
+		static bool s_sharedSectors = false;
 
 		s32 wallSortX(const void* r0, const void* r1)
 		{
@@ -167,14 +204,40 @@ namespace TFE_Jedi
 		}
 	}
 
+	void freeStrip(RenderStrip* strip)
+	{
+		free(strip->columnTop);
+		free(strip->columnBot);
+		free(strip->windowTop_all);
+		free(strip->windowBot_all);
+		free(strip->depth1d_all);
+		free(strip->flatEdgeList);
+		free(strip->adjoinEdgeList);
+		free(strip->wallSegListDst);
+		free(strip->sectors.m_sectorDrawFrame);
+		free(strip->sectors.m_wallDrawFrame);
+		delete strip;
+	}
+
 	void TFE_Sectors_Float::destroy()
 	{
+		for (s32 i = 0; i < MAX_RENDER_STRIPS; i++)
+		{
+			if (s_strips[i])
+			{
+				freeStrip(s_strips[i]);
+				s_strips[i] = nullptr;
+			}
+		}
 	}
 
 	void TFE_Sectors_Float::reset()
 	{
 		m_cachedSectors = nullptr;
 		m_cachedSectorCount = 0;
+		m_cachedWallCount = 0;
+		m_sectorDrawFrame = nullptr;
+		m_wallDrawFrame = nullptr;
 	}
 
 	void TFE_Sectors_Float::prepare()
@@ -185,6 +248,11 @@ namespace TFE_Jedi
 		s_rcfltState.flatEdge = flatEdge;
 		flat_addEdges(s_screenWidth, s_minScreenX_Pixels, 0, s_rcfltState.windowMaxY, 0, s_rcfltState.windowMinY);
 
+		s_rcfltState.sectorDrawFrame = m_sectorDrawFrame;
+		s_rcfltState.wallDrawFrame = m_wallDrawFrame;
+		s_rcfltState.drawnObj = s_drawnObj;
+		s_rcfltState.drawnObjCount = &s_drawnObjCount;
+
 		light_transformDirLights();
 	}
 
@@ -217,9 +285,6 @@ namespace TFE_Jedi
 
 		s_rcfltState.depth1d = &s_rcfltState.depth1d_all[(s_adjoinDepth - 1) * s_width];
 
-		s32 startWall = s_curSector->startWall;
-		s32 drawWallCount = s_curSector->drawWallCnt;
-
 		if (s_flatLighting)
 		{
 			s_sectorAmbient = s_flatAmbient;
@@ -237,13 +302,17 @@ namespace TFE_Jedi
 		if (s_adjoinDepth > 1)
 		{
 			depthPrev = &s_rcfltState.depth1d_all[(s_adjoinDepth - 2) * s_width];
-			memcpy(&s_rcfltState.depth1d[s_minScreenX_Pixels], &depthPrev[s_minScreenX_Pixels], s_width * 4);
+			memcpy(&s_rcfltState.depth1d[s_rcfltState.stripX0], &depthPrev[s_rcfltState.stripX0], (s_rcfltState.stripX1 - s_rcfltState.stripX0 + 1) * sizeof(f32));
 		}
 
 		s_wallMaxCeilY  = s_windowMinY_Pixels;
 		s_wallMinFloorY = s_windowMaxY_Pixels;
 		SectorCached* cachedSector = &m_cachedSectors[s_curSector->index];
 
+		// When drawing strips, the first thread to reach the sector updates the shared data.
+		std::unique_lock<std::mutex> sectorLock(s_sectorLock, std::defer_lock);
+		if (s_sharedSectors) { sectorLock.lock(); }
+
 		if (s_drawFrame != s_curSector->prevDrawFrame)
 		{
 			TFE_ZONE_BEGIN(secUpdateCache, "Update Sector Cache");
@@ -285,19 +354,22 @@ namespace TFE_Jedi
 			TFE_ZONE_END(objXform);
 
 			TFE_ZONE_BEGIN(wallProcess, "Sector Wall Process");
-				startWall = s_nextWall;
+				const s32 firstWall = s_nextWall;
 				WallCached* wall = cachedSector->cachedWalls;
 				for (s32 i = 0; i < s_curSector->wallCount; i++, wall++)
 				{
 					wall_process(wall);
 				}
-				drawWallCount = s_nextWall - startWall;
 
-				s_curSector->startWall = startWall;
-				s_curSector->drawWallCnt = drawWallCount;
+				s_curSector->startWall = firstWall;
+				s_curSector->drawWallCnt = s_nextWall - firstWall;
 				s_curSector->prevDrawFrame = s_drawFrame;
 			TFE_ZONE_END(wallProcess);
 		}
+		const s32 startWall = s_curSector->startWall;
+		const s32 drawWallCount = s_curSector->drawWallCnt;
+		s_curSector->flags1 |= SEC_FLAGS1_RENDERED;
+		if (sectorLock.owns_lock()) { sectorLock.unlock(); }
 
 		RWallSegmentFloat* wallSegment = &s_rcfltState.wallSegListDst[s_curWallSeg];
 		s32 drawSegCnt = wall_mergeSort(wallSegment, s_maxSegCount - s_curWallSeg, startWall, drawWallCount);
@@ -457,7 +529,7 @@ namespace TFE_Jedi
 						s_maxAdjoinDepth = s_adjoinDepth;
 					}
 
-					srcWall->drawFrame = s_drawFrame;
+					s_rcfltState.wallDrawFrame[curAdjoinSeg->srcWall->index] = s_drawFrame;
 					s_windowTop = winTopNext;
 					s_windowBot = winBotNext;
 					if (prevAdjoinSeg != 0)
@@ -484,7 +556,7 @@ namespace TFE_Jedi
 						s_adjoinDepth--;
 						restoreValues(index);
 					}
-					srcWall->drawFrame = 0;
+					s_rcfltState.wallDrawFrame[curAdjoinSeg->srcWall->index] = 0;
 					if (srcWall->flags1 & WF1_ADJ_MID_TEX)
 					{
 						TFE_ZONE("Draw Transparent Walls");
@@ -494,7 +566,7 @@ namespace TFE_Jedi
 			}
 		}
 
-		if (!(s_curSector->flags1 & SEC_FLAGS1_SUBSECTOR) && depthPrev && s_drawFrame != s_prevSector->prevDrawFrame2)
+		if (!(s_curSector->flags1 & SEC_FLAGS1_SUBSECTOR) && depthPrev && s_drawFrame != s_rcfltState.sectorDrawFrame[s_prevSector->index])
 		{
 			memcpy(&depthPrev[s_windowMinX_Pixels], &s_rcfltState.depth1d[s_windowMinX_Pixels], (s_windowMaxX_Pixels - s_windowMinX_Pixels + 1) * sizeof(f32));
 		}
@@ -557,18 +629,174 @@ namespace TFE_Jedi
 		}
 		TFE_ZONE_END(secDrawObjects);
 
-		s_curSector->flags1 |= SEC_FLAGS1_RENDERED;
-		s_curSector->prevDrawFrame2 = s_drawFrame;
+		s_rcfltState.sectorDrawFrame[s_curSector->index] = s_drawFrame;
 	}
 		
+	void allocateStrip(RenderStrip* strip, const TFE_Sectors_Float* owner)
+	{
+		if (strip->width != s_width)
+		{
+			const size_t rowCount = MAX_ADJOIN_DEPTH_EXT + 1;
+			strip->width = s_width;
+			strip->columnTop = (s32*)realloc(strip->columnTop, s_width * sizeof(s32));
+			strip->columnBot = (s32*)realloc(strip->columnBot, s_width * sizeof(s32));
+			strip->windowTop_all = (s32*)realloc(strip->windowTop_all, s_width * sizeof(s32) * rowCount);
+			strip->windowBot_all = (s32*)realloc(strip->windowBot_all, s_width * sizeof(s32) * rowCount);
+			strip->depth1d_all = (f32*)realloc(strip->depth1d_all, s_width * sizeof(f32) * rowCount);
+		}
+		if (!strip->flatEdgeList)
+		{
+			strip->flatEdgeList = (EdgePairFloat*)malloc(sizeof(EdgePairFloat) * MAX_SEG_EXT);
+			strip->adjoinEdgeList = (EdgePairFloat*)malloc(sizeof(EdgePairFloat) * MAX_ADJOIN_SEG_EXT);
+			strip->wallSegListDst = (RWallSegmentFloat*)malloc(sizeof(RWallSegmentFloat) * MAX_SEG_EXT);
+		}
+
+		// Share the sector cache, but keep separate frame markers.
+		TFE_Sectors_Float* sectors = &strip->sectors;
+		if (sectors->m_cachedSectorCount != owner->m_cachedSectorCount || sectors->m_cachedWallCount != owner->m_cachedWallCount)
+		{
+			sectors->m_sectorDrawFrame = (s32*)realloc(sectors->m_sectorDrawFrame, sizeof(s32) * owner->m_cachedSectorCount);
+			sectors->m_wallDrawFrame = (s32*)realloc(sectors->m_wallDrawFrame, sizeof(s32) * owner->m_cachedWallCount);
+			memset(sectors->m_sectorDrawFrame, 0, sizeof(s32) * owner->m_cachedSectorCount);
+			memset(sectors->m_wallDrawFrame, 0, sizeof(s32) * owner->m_cachedWallCount);
+		}
+		sectors->m_cachedSectors = owner->m_cachedSectors;
+		sectors->m_cachedSectorCount = owner->m_cachedSectorCount;
+		sectors->m_cachedWallCount = owner->m_cachedWallCount;
+	}
+
+	// Setup the root window for a strip, this mirrors the per-frame setup in drawWorld().
+	void beginStrip(s32 x0, s32 x1)
+	{
+		s_windowMinX_Pixels = x0;
+		s_windowMaxX_Pixels = x1;
+		s_windowX0 = x0;
+		s_windowX1 = x1;
+		s_rcfltState.stripX0 = x0;
+		s_rcfltState.stripX1 = x1;
+	}
+
+	void drawStripJob(void* userData)
+	{
+		TFE_ZONE("Draw Strip");
+		RenderStrip* strip = (RenderStrip*)userData;
+		const s32 x0 = strip->x0;
+		const s32 x1 = strip->x1;
+
+		s_rcfltState = s_frameState;
+		s_rcfltState.depth1d_all = strip->depth1d_all;
+		s_rcfltState.depth1d = strip->depth1d_all;
+		s_rcfltState.flatEdgeList = strip->flatEdgeList;
+		s_rcfltState.adjoinEdgeList = strip->adjoinEdgeList;
+		s_rcfltState.wallSegListDst = strip->wallSegListDst;
+		s_rcfltState.windowMinZ = 0.0f;
+		s_rcfltState.sectorDrawFrame = strip->sectors.m_sectorDrawFrame;
+		s_rcfltState.wallDrawFrame = strip->sectors.m_wallDrawFrame;
+		s_rcfltState.drawnObj = strip->drawnObj;
+		s_rcfltState.drawnObjCount = &strip->drawnObjCount;
+		strip->drawnObjCount = 0;
+
+		s_columnTop = strip->columnTop;
+		s_columnBot = strip->columnBot;
+		s_windowTop_all = strip->windowTop_all;
+		s_windowBot_all = strip->windowBot_all;
+		for (s32 x = x0; x <= x1; x++)
+		{
+			s_columnTop[x] = s_minScreenY;
+			s_columnBot[x] = s_maxScreenY;
+			s_windowTop_all[x] = s_minScreenY;
+			s_windowBot_all[x] = s_maxScreenY;
+			s_rcfltState.depth1d_all[x] = 0.0f;
+		}
+
+		beginStrip(x0, x1);
+		s_windowMinY_Pixels = 1;
+		s_windowMaxY_Pixels = s_height - 1;
+		s_windowMaxCeil  = s_minScreenY;
+		s_windowMinFloor = s_maxScreenY;
+		s_curWallSeg = 0;
+		s_prevSector = nullptr;
+		s_sectorIndex = 0;
+		s_maxAdjoinIndex = 0;
+		s_adjoinSegCount = 1;
+		s_adjoinIndex = 0;
+		s_adjoinDepth = 1;
+		s_maxAdjoinDepth = 1;
+
+		s_flatCount = 0;
+		s_rcfltState.flatEdge = s_rcfltState.flatEdgeList;
+		flat_addEdges(x1 - x0 + 1, x0, 0, s_rcfltState.windowMaxY, 0, s_rcfltState.windowMinY);
+
+		strip->sectors.draw(strip->rootSector);
+	}
+
+	void TFE_Sectors_Float::drawStrips(RSector* sector, s32 stripCount)
+	{
+		stripCount = min(stripCount, TFE_Jobs::getWorkerCount() + 1);
+		stripCount = min(stripCount, min(MAX_RENDER_STRIPS, s_screenWidth / MIN_STRIP_WIDTH));
+		if (stripCount <= 1)
+		{
+			draw(sector);
+			return;
+		}
+
+		// Copy the frame state before the main thread starts modifying it.
+		s_frameState = s_rcfltState;
+		s_sharedSectors = true;
+
+		atomic_s32 stripsInFlight(0);
+		const s32 x0 = s_minScreenX_Pixels;
+		for (s32 i = 1; i < stripCount; i++)
+		{
+			if (!s_strips[i])
+			{
+				s_strips[i] = new RenderStrip();
+			}
+			RenderStrip* strip = s_strips[i];
+			allocateStrip(strip, this);
+			strip->rootSector = sector;
+			strip->x0 = x0 + s_screenWidth * i / stripCount;
+			strip->x1 = x0 + s_screenWidth * (i + 1) / stripCount - 1;
+			TFE_Jobs::addJob(drawStripJob, strip, &stripsInFlight);
+		}
+
+		// The main thread draws the first strip.
+		beginStrip(x0, x0 + s_screenWidth / stripCount - 1);
+		draw(sector);
+
+		TFE_ZONE_BEGIN(stripWait, "Wait for Strips");
+			TFE_Jobs::waitForCounter(&stripsInFlight);
+		TFE_ZONE_END(stripWait);
+		s_sharedSectors = false;
+		beginStrip(s_minScreenX_Pixels, s_maxScreenX_Pixels);
+
+		// Gather the objects drawn in the other strips, objects that cross strips are only added once.
+		for (s32 i = 1; i < stripCount; i++)
+		{
+			const RenderStrip* strip = s_strips[i];
+			for (s32 o = 0; o < strip->drawnObjCount && s_drawnObjCount < MAX_DRAWN_OBJ_STORE; o++)
+			{
+				SecObject* obj = strip->drawnObj[o];
+				s32 d = 0;
+				for (; d < s_drawnObjCount && s_drawnObj[d] != obj; d++);
+				if (d == s_drawnObjCount)
+				{
+					s_drawnObj[s_drawnObjCount++] = obj;
+				}
+			}
+		}
+	}
+
 	void TFE_Sectors_Float::adjoin_setupAdjoinWindow(s32* winBot, s32* winBotNext, s32* winTop, s32* winTopNext, EdgePairFloat* adjoinEdges, s32 adjoinCount)
 	{
 		TFE_ZONE("Setup Adjoin Window");
 
 		// Note: This is pretty inefficient, especially at higher resolutions.
 		// The column loops below can be adjusted to do the copy only in the required ranges.
-		memcpy(&winTopNext[s_minScreenX_Pixels], &winTop[s_minScreenX_Pixels], s_width * 4);
-		memcpy(&winBotNext[s_minScreenX_Pixels], &winBot[s_minScreenX_Pixels], s_width * 4);
+		const s32 x0 = s_rcfltState.stripX0;
+		const s32 stripWidth = s_rcfltState.stripX1 - x0 + 1;
+		memcpy(&winTopNext[x0], &winTop[x0], stripWidth * sizeof(s32));
+		memcpy(&winBotNext[x0], &winBot[x0], stripWidth * sizeof(s32));
 
 		// Loop through each adjoin and setup the column range based on the edge pair and the parent
 		// column range.
@@ -688,8 +916,13 @@ namespace TFE_Jedi
 	void TFE_Sectors_Float::freeCachedData()
 	{
 		level_free(m_cachedSectors);
+		level_free(m_sectorDrawFrame);
+		level_free(m_wallDrawFrame);
 		m_cachedSectors = nullptr;
 		m_cachedSectorCount = 0;
+		m_cachedWallCount = 0;
+		m_sectorDrawFrame = nullptr;
+		m_wallDrawFrame = nullptr;
 	}
 		
 	void TFE_Sectors_Float::updateCachedWalls(SectorCached* cached, u32 flags)
@@ -712,6 +945,7 @@ namespace TFE_Jedi
 			{
 				wcached->wall = srcWall;
 				wcached->sector = cached;
+				wcached->index = cached->wallOffset + w;
 				wcached->v0 = &cached->verticesVS[PTR_OFFSET(srcWall->v0, srcSector->verticesVS) / sizeof(vec2_fixed)];
 				wcached->v1 = &cached->verticesVS[PTR_OFFSET(srcWall->v1, srcSector->verticesVS) / sizeof(vec2_fixed)];
 			}
@@ -792,11 +1026,19 @@ namespace TFE_Jedi
 			m_cachedSectors = (SectorCached*)level_alloc(sizeof(SectorCached) * m_cachedSectorCount);
 			memset(m_cachedSectors, 0, sizeof(SectorCached) * m_cachedSectorCount);
 
+			m_cachedWallCount = 0;
 			for (u32 i = 0; i < m_cachedSectorCount; i++)
 			{
 				m_cachedSectors[i].sector = &s_levelState.sectors[i];
+				m_cachedSectors[i].wallOffset = m_cachedWallCount;
+				m_cachedWallCount += s_levelState.sectors[i].wallCount;
 				updateCachedSector(&m_cachedSectors[i], SDF_ALL);
 			}
+
+			m_sectorDrawFrame = (s32*)level_alloc(sizeof(s32) * m_cachedSectorCount);
+			m_wallDrawFrame = (s32*)level_alloc(sizeof(s32) * m_cachedWallCount);
+			memset(m_sectorDrawFrame, 0, sizeof(s32) * m_cachedSectorCount);
+			memset(m_wallDrawFrame, 0, sizeof(s32) * m_cachedWallCount);
 		}
 	}
 
@@ -19,6 +19,7 @@ namespace TFE_Jedi
 	{
 		RSector* sector;		// base sector.
 		WallCached* cachedWalls;
+		s32 wallOffset;			// index of the first wall across all cached walls.
 		s32 objectCapacity;
 		// Floating point version of view space vertices.
 		vec2_float* verticesVS;
@@ -44,6 +45,10 @@ namespace TFE_Jedi
 		void draw(RSector* sector) override;
 		void subrendererChanged() override;
 
+		// Draw the view split into vertical strips, the first strip is drawn on the calling thread
+		// and the rest on job threads. Falls back to draw() if only one strip can be used.
+		void drawStrips(RSector* sector, s32 stripCount);
+
 	private:
 		void saveValues(s32 index);
 		void restoreValues(s32 index);
@@ -58,5 +63,9 @@ namespace TFE_Jedi
 	public:
 		SectorCached* m_cachedSectors = nullptr;
 		u32 m_cachedSectorCount = 0;
+		u32 m_cachedWallCount = 0;
+		// Frame markers for the thread drawing with this instance, see RClassicFloatState.
+		s32* m_sectorDrawFrame = nullptr;
+		s32* m_wallDrawFrame = nullptr;
 	};
 }  // TFE_Jedi
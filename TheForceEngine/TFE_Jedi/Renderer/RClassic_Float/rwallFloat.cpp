@@ -28,15 +28,15 @@ namespace RClassic_Float
 		BACK = 0,
 	};
 
-	static f32 s_segmentCross;
-	static s32 s_texHeightMask;
-	static s32 s_yPixelCount;
-	static fixed44_20 s_vCoordStep;
-	static fixed44_20 s_vCoordFixed;
-	static const u8* s_columnLight;
-	static u8* s_texImage;
-	static u8* s_columnOut;
-	static u8  s_workBuffer[WAX_DECOMPRESS_SIZE];
+	static thread_local f32 s_segmentCross;
+	static thread_local s32 s_texHeightMask;
+	static thread_local s32 s_yPixelCount;
+	static thread_local fixed44_20 s_vCoordStep;
+	static thread_local fixed44_20 s_vCoordFixed;
+	static thread_local const u8* s_columnLight;
+	static thread_local u8* s_texImage;
+	static thread_local u8* s_columnOut;
+	static thread_local u8  s_workBuffer[WAX_DECOMPRESS_SIZE];
 
 	s32 segmentCrossesLine(f32 ax0, f32 ay0, f32 ax1, f32 ay1, f32 bx0, f32 by0, f32 bx1, f32 by1);
 	f32 solveForZ_Numerator(RWallSegmentFloat* wallSegment);
@@ -444,7 +444,7 @@ namespace RClassic_Float
 		while (1)
 		{
 			WallCached* srcWall = srcSeg->srcWall;
-			JBool processed = (s_drawFrame == srcWall->wall->drawFrame) ? JTRUE : JFALSE;
+			JBool processed = (s_drawFrame == s_rcfltState.wallDrawFrame[srcWall->index]) ? JTRUE : JFALSE;
 			JBool insideWindow = ((srcSeg->z0 >= s_rcfltState.windowMinZ || srcSeg->z1 >= s_rcfltState.windowMinZ) && srcSeg->wallX0 <= s_windowMaxX_Pixels && srcSeg->wallX1 >= s_windowMinX_Pixels) ? JTRUE : JFALSE;
 			if (!processed && insideWindow)
 			{
@@ -2382,9 +2382,9 @@ namespace RClassic_Float
 			}
 		}
 
-		if (drawn && s_drawnObjCount < MAX_DRAWN_OBJ_STORE)
+		if (drawn && *s_rcfltState.drawnObjCount < MAX_DRAWN_OBJ_STORE)
 		{
-			s_drawnObj[s_drawnObjCount++] = obj;
+			s_rcfltState.drawnObj[(*s_rcfltState.drawnObjCount)++] = obj;
 		}
 	}
 }  // RClassic_Float
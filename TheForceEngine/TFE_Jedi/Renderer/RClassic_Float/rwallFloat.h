@@ -23,6 +23,7 @@ namespace TFE_Jedi
 	{
 		RWall* wall;	// base wall.
 		SectorCached* sector;
+		s32 index;		// index across all cached walls.
 		// Vertices (viewspace) - points to cached vertices.
 		vec2_float* v0;
 		vec2_float* v1;
@@ -489,7 +489,16 @@ namespace TFE_Jedi
 		{
 			TFE_ZONE("Sector Draw");
 			s_sectorRenderer->prepare();
-			s_sectorRenderer->draw(sector);
+
+			const s32 renderThreadCount = TFE_Settings::getGraphicsSettings()->renderThreadCount;
+			if (s_subRenderer == TSR_CLASSIC_FLOAT && renderThreadCount > 1)
+			{
+				((TFE_Sectors_Float*)s_sectorRenderer)->drawStrips(sector, renderThreadCount);
+			}
+			else
+			{
+				s_sectorRenderer->draw(sector);
+			}
 		}
 	}
 
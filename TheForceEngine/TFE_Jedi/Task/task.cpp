@@ -10,11 +10,14 @@
 #include <stdarg.h>
 #include <tuple>
 #include <vector>
+#include <set>
 
 using namespace TFE_DarkForces;
 using namespace TFE_Memory;
 
 // #define TASK_DEBUG 1
+// Verify that the scheduler selects the same task as walking the task tree.
+// #define TASK_SCHEDULE_VALIDATE 1
 
 enum TaskConstants
 {
@@ -22,6 +25,13 @@ enum TaskConstants
 	TASK_INIT_LEVEL = -1,
 };
 
+enum TaskScheduleState : u8
+{
+	TASK_SCHED_NONE = 0,	// Sleeping until woken up with task_makeActive() or task_setNextTick().
+	TASK_SCHED_READY,		// Can run on the current tick (or is a framebreak task).
+	TASK_SCHED_WAITING,		// Waiting for nextTick, stored in the wait heap.
+};
+
 struct TaskContext
 {
 	s32 ip[TASK_MAX_LEVELS];				// Current instruction pointer (IP) for each level of recursion.
@@ -62,6 +72,14 @@ struct Task
 
 	// Timing.
 	Tick nextTick;
+
+	// Scheduling, the position of the task in the order that the task tree is walked.
+	Task* orderPrev;
+	Task* orderNext;
+	u64 orderLabel;
+	s32 heapIndex;
+	u32 schedGeneration;
+	TaskScheduleState schedState;
 };
 
 namespace TFE_Jedi
@@ -94,6 +112,223 @@ namespace TFE_Jedi
 
 	void selectNextTask();
 
+	/////////////////////////////////////////////////
+	// Scheduling
+	// Tasks run in the order that the task tree is walked (see task_findNextWalk()), which is mirrored
+	// by the 'order' list with increasing labels starting at the root task.
+	// Tasks that can run are kept in a set sorted by that order and tasks waiting on a future tick are
+	// kept in a min-heap keyed on nextTick, so selecting the next task does not have to visit sleeping tasks.
+	/////////////////////////////////////////////////
+	struct TaskOrder
+	{
+		bool operator()(const Task* a, const Task* b) const { return a->orderLabel < b->orderLabel; }
+	};
+	typedef std::set<Task*, TaskOrder> TaskSet;
+
+	static const u64 c_orderLabelSpacing = 1ull << 40;
+	static TaskSet s_readyTasks;
+	static std::vector<Task*> s_waitHeap;
+	static Tick s_scheduleTick = 0;
+	// Tasks may still be freed after all tasks are reset (see task_freeAll()), those are ignored by the scheduler.
+	static u32 s_scheduleGeneration = 0;
+
+	void schedule_reset()
+	{
+		s_readyTasks.clear();
+		s_waitHeap.clear();
+		s_scheduleTick = 0;
+		s_scheduleGeneration++;
+
+		s_rootTask.orderPrev = &s_rootTask;
+		s_rootTask.orderNext = &s_rootTask;
+		s_rootTask.orderLabel = 0;
+		s_rootTask.heapIndex = -1;
+		s_rootTask.schedState = TASK_SCHED_NONE;
+	}
+
+	void schedule_heapSwap(s32 a, s32 b)
+	{
+		std::swap(s_waitHeap[a], s_waitHeap[b]);
+		s_waitHeap[a]->heapIndex = a;
+		s_waitHeap[b]->heapIndex = b;
+	}
+
+	void schedule_heapSiftUp(s32 index)
+	{
+		while (index > 0)
+		{
+			const s32 parent = (index - 1) >> 1;
+			if (s_waitHeap[parent]->nextTick <= s_waitHeap[index]->nextTick) { break; }
+			schedule_heapSwap(parent, index);
+			index = parent;
+		}
+	}
+
+	void schedule_heapSiftDown(s32 index)
+	{
+		const s32 count = (s32)s_waitHeap.size();
+		while (1)
+		{
+			const s32 left = index * 2 + 1;
+			const s32 right = left + 1;
+			s32 smallest = index;
+			if (left < count && s_waitHeap[left]->nextTick < s_waitHeap[smallest]->nextTick) { smallest = left; }
+			if (right < count && s_waitHeap[right]->nextTick < s_waitHeap[smallest]->nextTick) { smallest = right; }
+			if (smallest == index) { break; }
+			schedule_heapSwap(index, smallest);
+			index = smallest;
+		}
+	}
+
+	void schedule_heapPush(Task* task)
+	{
+		task->heapIndex = (s32)s_waitHeap.size();
+		s_waitHeap.push_back(task);
+		schedule_heapSiftUp(task->heapIndex);
+	}
+
+	void schedule_heapRemove(Task* task)
+	{
+		const s32 index = task->heapIndex;
+		const s32 last = (s32)s_waitHeap.size() - 1;
+		if (index != last)
+		{
+			schedule_heapSwap(index, last);
+		}
+		s_waitHeap.pop_back();
+		task->heapIndex = -1;
+
+		if (index < last)
+		{
+			schedule_heapSiftUp(index);
+			schedule_heapSiftDown(index);
+		}
+	}
+
+	void schedule_remove(Task* task)
+	{
+		if (task->schedState == TASK_SCHED_READY)
+		{
+			s_readyTasks.erase(task);
+		}
+		else if (task->schedState == TASK_SCHED_WAITING)
+		{
+			schedule_heapRemove(task);
+		}
+		task->schedState = TASK_SCHED_NONE;
+	}
+
+	// Called whenever the task nextTick changes.
+	void schedule_update(Task* task)
+	{
+		if (task == &s_rootTask || task->schedGeneration != s_scheduleGeneration) { return; }
+
+		if (task->framebreak || task->nextTick <= s_curTick)
+		{
+			if (task->schedState == TASK_SCHED_READY) { return; }
+			schedule_remove(task);
+			s_readyTasks.insert(task);
+			task->schedState = TASK_SCHED_READY;
+		}
+		else if (task->nextTick == TASK_SLEEP)
+		{
+			schedule_remove(task);
+		}
+		else if (task->schedState == TASK_SCHED_WAITING)
+		{
+			schedule_heapSiftUp(task->heapIndex);
+			schedule_heapSiftDown(task->heapIndex);
+		}
+		else
+		{
+			schedule_remove(task);
+			schedule_heapPush(task);
+			task->schedState = TASK_SCHED_WAITING;
+		}
+	}
+
+	// Move the tasks whose nextTick has been reached into the ready set.
+	void schedule_wake()
+	{
+		// Time can go backwards when loading a save, so put tasks that are no longer ready back to wait.
+		if (s_curTick < s_scheduleTick)
+		{
+			std::vector<Task*> waiting;
+			for (TaskSet::iterator iTask = s_readyTasks.begin(); iTask != s_readyTasks.end(); ++iTask)
+			{
+				if (!(*iTask)->framebreak && (*iTask)->nextTick > s_curTick)
+				{
+					waiting.push_back(*iTask);
+				}
+			}
+			const size_t count = waiting.size();
+			for (size_t i = 0; i < count; i++)
+			{
+				schedule_update(waiting[i]);
+			}
+		}
+		s_scheduleTick = s_curTick;
+
+		while (!s_waitHeap.empty() && s_waitHeap[0]->nextTick <= s_curTick)
+		{
+			Task* task = s_waitHeap[0];
+			schedule_heapRemove(task);
+			s_readyTasks.insert(task);
+			task->schedState = TASK_SCHED_READY;
+		}
+	}
+
+	// Spread the order labels out evenly, this is only required when there is no room left between two labels.
+	void schedule_relabel()
+	{
+		// The ready set is sorted by label, so it has to be rebuilt.
+		std::vector<Task*> ready(s_readyTasks.begin(), s_readyTasks.end());
+		s_readyTasks.clear();
+
+		u64 label = 0;
+		Task* task = &s_rootTask;
+		do
+		{
+			task->orderLabel = label;
+			label += c_orderLabelSpacing;
+			task = task->orderNext;
+		} while (task != &s_rootTask);
+
+		s_readyTasks.insert(ready.begin(), ready.end());
+	}
+
+	// Insert 'task' into the walk order directly after 'prev'.
+	void schedule_insertAfter(Task* prev, Task* task)
+	{
+		u64 upper = (prev->orderNext == &s_rootTask) ? ~0ull : prev->orderNext->orderLabel;
+		if (upper - prev->orderLabel < 2)
+		{
+			schedule_relabel();
+			upper = (prev->orderNext == &s_rootTask) ? ~0ull : prev->orderNext->orderLabel;
+		}
+		task->orderLabel = prev->orderLabel + (upper - prev->orderLabel) / 2;
+
+		task->orderPrev = prev;
+		task->orderNext = prev->orderNext;
+		prev->orderNext->orderPrev = task;
+		prev->orderNext = task;
+
+		task->heapIndex = -1;
+		task->schedGeneration = s_scheduleGeneration;
+		task->schedState = TASK_SCHED_NONE;
+		schedule_update(task);
+	}
+
+	void schedule_unlink(Task* task)
+	{
+		if (task->schedGeneration != s_scheduleGeneration) { return; }
+		schedule_remove(task);
+		task->orderPrev->orderNext = task->orderNext;
+		task->orderNext->orderPrev = task->orderPrev;
+		task->orderPrev = nullptr;
+		task->orderNext = nullptr;
+	}
+
 	void createRootTask()
 	{
 		s_tasks = createChunkedArray(sizeof(Task), TASK_CHUNK_SIZE, TASK_PREALLOCATED_CHUNKS, s_gameRegion);
@@ -108,6 +343,7 @@ namespace TFE_Jedi
 		s_curTask = &s_rootTask;
 		s_taskCount = 0;
 		s_frameActiveTaskCount = 0;
+		schedule_reset();
 	}
 
 	Task* createSubTask(const char* name, TaskFunc func, TaskFunc localRunFunc)
@@ -123,6 +359,13 @@ namespace TFE_Jedi
 		s_taskCount++;
 		strcpy(newTask->name, name);
 
+		// The new subtask is walked directly before the first task in the current task's subtree.
+		Task* firstInTree = s_curTask;
+		while (firstInTree->subtaskNext)
+		{
+			firstInTree = firstInTree->subtaskNext;
+		}
+
 		// Insert newTask at the head of the subtask list in the current "mainline" task.
 		newTask->next = s_curTask->subtaskNext;
 		newTask->prev = nullptr;
@@ -146,6 +389,8 @@ namespace TFE_Jedi
 		newTask->context.callstack[0] = func;
 		newTask->localRunFunc = localRunFunc;
 		newTask->context.level = TASK_INIT_LEVEL;
+
+		schedule_insertAfter(firstInTree->orderPrev, newTask);
 		return newTask;
 	}
 
@@ -183,6 +428,8 @@ namespace TFE_Jedi
 		newTask->context.level = TASK_INIT_LEVEL;
 		newTask->nextTick = s_curTick;
 
+		// Main tasks are walked after all of their subtasks, so 's_taskIter' is the last task of its subtree.
+		schedule_insertAfter(s_taskIter, newTask);
 		return newTask;
 	}
 	
@@ -191,6 +438,10 @@ namespace TFE_Jedi
 		SERIALIZE(SaveVersionInit, task->context.ip[0], 0);
 		SERIALIZE(SaveVersionInit, task->context.stackSize[0], 0);
 		SERIALIZE(SaveVersionInit, task->nextTick, 0);
+		if (serialization_getMode() == SMODE_READ)
+		{
+			schedule_update(task);
+		}
 		if (serialization_getMode() == SMODE_READ && !task->context.stackMem)
 		{
 			task->context.stackMem = (u8*)allocFromChunkedArray(s_stackBlocks);
@@ -249,6 +500,7 @@ namespace TFE_Jedi
 		{
 			parent->subtaskNext = task->next;
 		}
+		schedule_unlink(task);
 		
 		// Free any memory allocated for the local context.
 		freeToChunkedArray(s_stackBlocks, task->context.stackMem);
@@ -271,12 +523,14 @@ namespace TFE_Jedi
 
 		s_taskSystemPaused = JFALSE;
 		s_taskPauseTask = nullptr;
+		schedule_reset();
 	}
 
 	void task_freeAll()
 	{
 		chunkedArrayClear(s_tasks);
 		chunkedArrayClear(s_stackBlocks);
+		schedule_reset();
 
 		s_curTask    = nullptr;
 		s_curContext = nullptr;
@@ -300,16 +554,19 @@ namespace TFE_Jedi
 		s_frameActiveTaskCount = 0;
 		s_taskSystemPaused = JFALSE;
 		s_taskPauseTask = nullptr;
+		schedule_reset();
 	}
 
 	void task_makeActive(Task* task)
 	{
 		task->nextTick = 0;
+		schedule_update(task);
 	}
 
 	void task_setNextTick(Task* task, Tick tick)
 	{
 		task->nextTick = tick;
+		schedule_update(task);
 	}
 
 	void task_setUserData(Task* task, void* data)
@@ -388,10 +645,10 @@ namespace TFE_Jedi
 		}
 	}
 
-	void selectNextTask()
+	// Walk the task tree from 'task' to find the next task that can run, this defines the task order.
+	// Returns null if the end of the tree is reached.
+	Task* task_findNextWalk(Task* task)
 	{
-		// Find the next task to run.
-		Task* task = s_curTask;
 		while (1)
 		{
 			//////////////////////////////////////////////////////////////////////////////////////////
@@ -415,9 +672,7 @@ namespace TFE_Jedi
 				// Then execute the task.
 				if (task->nextTick <= s_curTick || task->framebreak)
 				{
-					s_currentMsg = MSG_RUN_TASK;
-					s_curTask = task;
-					return;
+					return task;
 				}
 			}
 			else if (task->subtaskParent)
@@ -426,9 +681,7 @@ namespace TFE_Jedi
 				task = task->subtaskParent;
 				if (task->nextTick <= s_curTick || task->framebreak)
 				{
-					s_currentMsg = MSG_RUN_TASK;
-					s_curTask = task;
-					return;
+					return task;
 				}
 			}
 			else
@@ -436,6 +689,34 @@ namespace TFE_Jedi
 				break;
 			}
 		}
+		return nullptr;
+	}
+
+	void selectNextTask()
+	{
+		// The next task is the first ready task after the current task in the walk order, wrapping around to the start.
+		Task* task = nullptr;
+		schedule_wake();
+		if (!s_readyTasks.empty())
+		{
+			TaskSet::iterator iTask = s_readyTasks.upper_bound(s_curTask);
+			task = (iTask != s_readyTasks.end()) ? *iTask : *s_readyTasks.begin();
+		#ifdef TASK_SCHEDULE_VALIDATE
+			assert(task == task_findNextWalk(s_curTask));
+		#endif
+		}
+		else
+		{
+			// Without a framebreak task there may not be anything to run, so fall back to the walk.
+			task = task_findNextWalk(s_curTask);
+		}
+
+		if (task)
+		{
+			s_currentMsg = MSG_RUN_TASK;
+			s_curTask = task;
+			return;
+		}
 
 		// If no selection is possible, assign the first task.
 		if (!s_curTask && s_taskCount)
@@ -504,6 +785,7 @@ namespace TFE_Jedi
 
 		// Update the current tick based on the delay.
 		s_curTask->nextTick = (delay < TASK_SLEEP) ? s_curTick + delay : delay;
+		schedule_update(s_curTask);
 		
 		// Find the next task to run.
 		selectNextTask();
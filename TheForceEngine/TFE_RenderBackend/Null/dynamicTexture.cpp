@@ -0,0 +1,69 @@
+#include <TFE_RenderBackend/dynamicTexture.h>
+
+std::vector<u8> DynamicTexture::s_tempBuffer;
+u32 DynamicTexture::s_alignment = 4;
+
+// The null backend does not upload anything, the render backend keeps its own CPU copy
+// of the virtual display instead.
+DynamicTexture::~DynamicTexture()
+{
+	freeBuffers();
+}
+
+bool DynamicTexture::create(u32 width, u32 height, u32 bufferCount, DynamicTexFormat format/* = DTEX_RGBA8*/)
+{
+	m_width  = width;
+	m_height = height;
+	m_format = format;
+
+	return changeBufferCount(bufferCount);
+}
+
+void DynamicTexture::resize(u32 newWidth, u32 newHeight)
+{
+	if (newWidth == m_width && newHeight == m_height) { return; }
+
+	m_width = newWidth;
+	m_height = newHeight;
+	changeBufferCount(m_bufferCount, true);
+}
+
+bool DynamicTexture::changeBufferCount(u32 newBufferCount, bool forceRealloc/* = false*/)
+{
+	if (newBufferCount == m_bufferCount && !forceRealloc) { return false; }
+	freeBuffers();
+
+	m_bufferCount = newBufferCount;
+	m_readBuffer  = 0;
+	m_writeBuffer = m_bufferCount - 1;
+
+	m_textures = new TextureGpu*[m_bufferCount];
+	for (u32 i = 0; i < m_bufferCount; i++)
+	{
+		m_textures[i] = new TextureGpu();
+		m_textures[i]->create(m_width, m_height, m_format == DTEX_R8 ? 1 : 4);
+	}
+	return true;
+}
+
+void DynamicTexture::update(const void* imageData, size_t size)
+{
+	m_readBuffer  = (m_readBuffer + 1) % m_bufferCount;
+	m_writeBuffer = (m_writeBuffer + 1) % m_bufferCount;
+}
+
+void DynamicTexture::bind(u32 slot) const
+{
+}
+
+void DynamicTexture::freeBuffers()
+{
+	for (u32 i = 0; i < m_bufferCount; i++)
+	{
+		delete m_textures[i];
+	}
+	delete[] m_textures;
+
+	m_textures = nullptr;
+	m_bufferCount = 0;
+}
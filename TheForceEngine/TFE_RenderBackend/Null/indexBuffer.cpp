@@ -0,0 +1,36 @@
+#include <TFE_RenderBackend/indexBuffer.h>
+
+// The null backend has no GPU, so buffers only track their attributes.
+IndexBuffer::~IndexBuffer()
+{
+	destroy();
+}
+
+bool IndexBuffer::create(u32 count, u32 stride, bool dynamic, void* initData)
+{
+	if (!count || !stride) { return false; }
+
+	m_size = count * stride;
+	m_count = count;
+	m_stride = stride;
+	m_dynamic = dynamic;
+	return true;
+}
+
+void IndexBuffer::destroy()
+{
+	m_gpuHandle = 0;
+}
+
+void IndexBuffer::update(const void* buffer, size_t size)
+{
+}
+
+u32 IndexBuffer::bind()
+{
+	return 0;
+}
+
+void IndexBuffer::unbind()
+{
+}
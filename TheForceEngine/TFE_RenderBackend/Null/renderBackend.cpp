@@ -0,0 +1,470 @@
+#include <TFE_RenderBackend/renderBackend.h>
+#include <TFE_RenderBackend/dynamicTexture.h>
+#include <TFE_RenderBackend/textureGpu.h>
+#include <TFE_Settings/settings.h>
+#include <TFE_Ui/ui.h>
+#include <TFE_Asset/imageAsset.h>
+#include <TFE_System/profiler.h>
+#include <TFE_PostProcess/postprocess.h>
+#include <SDL.h>
+#include <stdio.h>
+#include <assert.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////
+// Null render backend.
+// No GPU or OpenGL context is created, the virtual display is kept in
+// a plain CPU buffer so the software renderers can run headless.
+// Screenshots are converted from that buffer and written as images.
+//////////////////////////////////////////////////////////////////////
+namespace TFE_RenderBackend
+{
+	static char s_screenshotPath[TFE_MAX_PATH];
+	static bool s_screenshotQueued = false;
+
+	static WindowState m_windowState;
+	static void* m_window;
+
+	static u32 s_virtualWidth, s_virtualHeight;
+	static u32 s_virtualWidthUi;
+	static u32 s_virtualWidth3d;
+
+	static bool s_widescreen = false;
+	static bool s_asyncFrameBuffer = false;
+	static bool s_gpuColorConvert = false;
+	static bool s_useRenderTarget = false;
+	static DisplayMode s_displayMode;
+
+	// CPU copy of the virtual display, either 8-bit palette indices or 32-bit color.
+	static std::vector<u8> s_displayBuffer;
+	static std::vector<u32> s_captureBuffer;
+	static u32 s_palette[256];
+	static TextureGpu* s_paletteTexture = nullptr;
+
+	static std::vector<SDL_Rect> s_displayBounds;
+
+	void convertVirtualDisplay(u32* output, u32 width, u32 height);
+
+	SDL_Window* createWindow(const WindowState& state)
+	{
+		// The window is never shown, it is only required for SDL events and the UI.
+		SDL_Window* window = SDL_CreateWindow(state.name, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, state.width, state.height, SDL_WINDOW_HIDDEN);
+		if (!window)
+		{
+			TFE_System::logWrite(LOG_ERROR, "RenderBackend", "Cannot create the window: %s", SDL_GetError());
+			return nullptr;
+		}
+		TFE_System::logWrite(LOG_MSG, "RenderBackend", "Using the null render backend.");
+
+		TFE_Ui::init(window, nullptr, 100);
+		return window;
+	}
+
+	bool init(const WindowState& state)
+	{
+		m_window = createWindow(state);
+		m_windowState = state;
+		m_windowState.flags &= ~WINFLAG_VSYNC;
+		if (!m_window)
+		{
+			return false;
+		}
+
+		// The post process system only holds overlay state here, it is never executed.
+		if (!TFE_PostProcess::init())
+		{
+			return false;
+		}
+
+		s_paletteTexture = new TextureGpu();
+		s_paletteTexture->create(256, 1);
+		memset(s_palette, 0, sizeof(s_palette));
+		return true;
+	}
+
+	void destroy()
+	{
+		TFE_PostProcess::destroy();
+		TFE_Ui::shutdown();
+
+		delete s_paletteTexture;
+		SDL_DestroyWindow((SDL_Window*)m_window);
+
+		s_paletteTexture = nullptr;
+		s_displayBuffer.clear();
+		s_captureBuffer.clear();
+		m_window = nullptr;
+	}
+
+	bool getVsyncEnabled()
+	{
+		return false;
+	}
+
+	void enableVsync(bool enable)
+	{
+	}
+
+	void setClearColor(const f32* color)
+	{
+	}
+
+	void swap(bool blitVirtualDisplay)
+	{
+		TFE_ZONE_BEGIN(systemUi, "System UI");
+		TFE_Ui::render();
+		TFE_ZONE_END(systemUi);
+
+		if (s_screenshotQueued)
+		{
+			s_screenshotQueued = false;
+			if (s_virtualWidth && s_virtualHeight && !s_displayBuffer.empty())
+			{
+				s_captureBuffer.resize(s_virtualWidth * s_virtualHeight);
+				convertVirtualDisplay(s_captureBuffer.data(), s_virtualWidth, s_virtualHeight);
+				TFE_Image::writeImage(s_screenshotPath, s_virtualWidth, s_virtualHeight, s_captureBuffer.data());
+			}
+		}
+	}
+
+	// Scale the virtual display to the window size, there is no other front buffer.
+	void captureScreenToMemory(u32* mem)
+	{
+		if (s_displayBuffer.empty())
+		{
+			memset(mem, 0, m_windowState.width * m_windowState.height * sizeof(u32));
+			return;
+		}
+		convertVirtualDisplay(mem, m_windowState.width, m_windowState.height);
+	}
+
+	void queueScreenshot(const char* screenshotPath)
+	{
+		strcpy(s_screenshotPath, screenshotPath);
+		s_screenshotQueued = true;
+	}
+
+	void startGifRecording(const char* path)
+	{
+		TFE_System::logWrite(LOG_WARNING, "RenderBackend", "GIF recording is not supported by the null render backend.");
+	}
+
+	void stopGifRecording()
+	{
+	}
+
+	void updateSettings()
+	{
+	}
+
+	void resize(s32 width, s32 height)
+	{
+		m_windowState.width = width;
+		m_windowState.height = height;
+	}
+
+	void enumerateDisplays()
+	{
+		s32 displayCount = SDL_GetNumVideoDisplays();
+		s_displayBounds.resize(std::max(displayCount, 0));
+		for (s32 i = 0; i < displayCount; i++)
+		{
+			SDL_GetDisplayBounds(i, &s_displayBounds[i]);
+		}
+	}
+
+	s32 getDisplayCount()
+	{
+		enumerateDisplays();
+		return (s32)s_displayBounds.size();
+	}
+
+	s32 getDisplayIndex(s32 x, s32 y)
+	{
+		enumerateDisplays();
+
+		s32 displayIndex = -1;
+		for (size_t i = 0; i < s_displayBounds.size(); i++)
+		{
+			if (x >= s_displayBounds[i].x && x < s_displayBounds[i].x + s_displayBounds[i].w &&
+				y >= s_displayBounds[i].y && y < s_displayBounds[i].y + s_displayBounds[i].h)
+			{
+				displayIndex = s32(i);
+				break;
+			}
+		}
+		return displayIndex;
+	}
+
+	bool getDisplayMonitorInfo(s32 displayIndex, MonitorInfo* monitorInfo)
+	{
+		enumerateDisplays();
+		if (displayIndex < 0 || displayIndex >= (s32)s_displayBounds.size())
+		{
+			// Without a display, pretend there is a single 1080p monitor.
+			monitorInfo->x = 0;
+			monitorInfo->y = 0;
+			monitorInfo->w = 1920;
+			monitorInfo->h = 1080;
+			return displayIndex == 0;
+		}
+
+		monitorInfo->x = s_displayBounds[displayIndex].x;
+		monitorInfo->y = s_displayBounds[displayIndex].y;
+		monitorInfo->w = s_displayBounds[displayIndex].w;
+		monitorInfo->h = s_displayBounds[displayIndex].h;
+		return true;
+	}
+
+	f32 getDisplayRefreshRate()
+	{
+		return 0.0f;
+	}
+
+	void getCurrentMonitorInfo(MonitorInfo* monitorInfo)
+	{
+		getDisplayMonitorInfo(0, monitorInfo);
+	}
+
+	void enableFullscreen(bool enable)
+	{
+		TFE_Settings::getWindowSettings()->fullscreen = enable;
+	}
+
+	void clearWindow()
+	{
+	}
+
+	void getDisplayInfo(DisplayInfo* displayInfo)
+	{
+		assert(displayInfo);
+
+		displayInfo->width = m_windowState.width;
+		displayInfo->height = m_windowState.height;
+		displayInfo->refreshRate = 0.0f;
+	}
+
+	bool createVirtualDisplay(const VirtualDisplayInfo& vdispInfo)
+	{
+		s_virtualWidth = vdispInfo.width;
+		s_virtualHeight = vdispInfo.height;
+		s_virtualWidthUi = vdispInfo.widthUi;
+		s_virtualWidth3d = vdispInfo.width3d;
+		s_displayMode = vdispInfo.mode;
+		s_widescreen = (vdispInfo.flags & VDISP_WIDESCREEN) != 0;
+		s_asyncFrameBuffer = (vdispInfo.flags & VDISP_ASYNC_FRAMEBUFFER) != 0;
+		s_gpuColorConvert = (vdispInfo.flags & VDISP_GPU_COLOR_CONVERT) != 0;
+		s_useRenderTarget = (vdispInfo.flags & VDISP_RENDER_TARGET) != 0;
+
+		s_displayBuffer.clear();
+		if (s_useRenderTarget)
+		{
+			TFE_System::logWrite(LOG_ERROR, "RenderBackend", "The null render backend does not support GPU rendering.");
+			return false;
+		}
+		return true;
+	}
+
+	u32 getVirtualDisplayWidth2D()
+	{
+		return s_virtualWidthUi;
+	}
+
+	u32 getVirtualDisplayWidth3D()
+	{
+		return s_virtualWidth3d;
+	}
+
+	u32 getVirtualDisplayHeight()
+	{
+		return s_virtualHeight;
+	}
+
+	u32 getVirtualDisplayOffset2D()
+	{
+		if (s_virtualWidth <= s_virtualWidthUi) { return 0; }
+		return (s_virtualWidth - s_virtualWidthUi) >> 1;
+	}
+
+	u32 getVirtualDisplayOffset3D()
+	{
+		if (s_virtualWidth <= s_virtualWidth3d) { return 0; }
+		return (s_virtualWidth - s_virtualWidth3d) >> 1;
+	}
+
+	void* getVirtualDisplayGpuPtr()
+	{
+		return nullptr;
+	}
+
+	bool getWidescreen()
+	{
+		return s_widescreen;
+	}
+
+	bool getFrameBufferAsync()
+	{
+		return s_asyncFrameBuffer;
+	}
+
+	bool getGPUColorConvert()
+	{
+		return s_gpuColorConvert;
+	}
+
+	void updateVirtualDisplay(const void* buffer, size_t size)
+	{
+		TFE_ZONE("Update Virtual Display");
+		if (s_displayBuffer.size() != size)
+		{
+			s_displayBuffer.resize(size);
+		}
+		memcpy(s_displayBuffer.data(), buffer, size);
+	}
+
+	void bindVirtualDisplay()
+	{
+	}
+
+	void clearVirtualDisplay(f32* color, bool clearColor)
+	{
+	}
+
+	void copyToVirtualDisplay(RenderTargetHandle src)
+	{
+	}
+
+	void copyBackbufferToRenderTarget(RenderTargetHandle dst)
+	{
+	}
+
+	void setPalette(const u32* palette)
+	{
+		if (palette)
+		{
+			memcpy(s_palette, palette, 256 * sizeof(u32));
+		}
+	}
+
+	const TextureGpu* getPaletteTexture()
+	{
+		return s_paletteTexture;
+	}
+
+	void setColorCorrection(bool enabled, const ColorCorrection* color/* = nullptr*/)
+	{
+	}
+
+	// Render targets are just textures that are never written to.
+	RenderTargetHandle createRenderTarget(u32 width, u32 height, bool hasDepthBuffer)
+	{
+		TextureGpu* texture = new TextureGpu();
+		texture->create(width, height);
+		return RenderTargetHandle(texture);
+	}
+
+	void freeRenderTarget(RenderTargetHandle handle)
+	{
+		delete (TextureGpu*)handle;
+	}
+
+	void bindRenderTarget(RenderTargetHandle handle)
+	{
+	}
+
+	void clearRenderTarget(RenderTargetHandle handle, const f32* clearColor, f32 clearDepth)
+	{
+	}
+
+	void clearRenderTargetDepth(RenderTargetHandle handle, f32 clearDepth)
+	{
+	}
+
+	void copyRenderTarget(RenderTargetHandle dst, RenderTargetHandle src)
+	{
+	}
+
+	void unbindRenderTarget()
+	{
+	}
+
+	const TextureGpu* getRenderTargetTexture(RenderTargetHandle rtHandle)
+	{
+		return (const TextureGpu*)rtHandle;
+	}
+
+	void getRenderTargetDim(RenderTargetHandle rtHandle, u32* width, u32* height)
+	{
+		const TextureGpu* texture = (const TextureGpu*)rtHandle;
+		*width = texture->getWidth();
+		*height = texture->getHeight();
+	}
+
+	TextureGpu* createTexture(u32 width, u32 height, u32 channels)
+	{
+		TextureGpu* texture = new TextureGpu();
+		texture->create(width, height, channels);
+		return texture;
+	}
+
+	TextureGpu* createTextureArray(u32 width, u32 height, u32 layers, u32 channels)
+	{
+		TextureGpu* texture = new TextureGpu();
+		texture->createArray(width, height, layers, channels);
+		return texture;
+	}
+
+	TextureGpu* createTexture(u32 width, u32 height, const u32* data, MagFilter magFilter)
+	{
+		TextureGpu* texture = new TextureGpu();
+		texture->createWithData(width, height, data, magFilter);
+		return texture;
+	}
+
+	void freeTexture(TextureGpu* texture)
+	{
+		delete texture;
+	}
+
+	void getTextureDim(TextureGpu* texture, u32* width, u32* height)
+	{
+		*width = texture->getWidth();
+		*height = texture->getHeight();
+	}
+
+	void* getGpuPtr(const TextureGpu* texture)
+	{
+		return nullptr;
+	}
+
+	void drawIndexedTriangles(u32 triCount, u32 indexStride, u32 indexStart)
+	{
+	}
+
+	void drawLines(u32 lineCount)
+	{
+	}
+
+	// Convert the virtual display to 32-bit color, scaling it to width x height.
+	void convertVirtualDisplay(u32* output, u32 width, u32 height)
+	{
+		const u32 srcStride = s_virtualWidth;
+		const size_t pixelSize = s_gpuColorConvert ? 1 : 4;
+		if (s_displayBuffer.size() < size_t(s_virtualWidth) * s_virtualHeight * pixelSize) { return; }
+
+		const u8*  src8  = s_displayBuffer.data();
+		const u32* src32 = (const u32*)s_displayBuffer.data();
+		for (u32 y = 0; y < height; y++)
+		{
+			const u32 srcY = y * s_virtualHeight / height;
+			u32* outRow = &output[y * width];
+			for (u32 x = 0; x < width; x++)
+			{
+				const u32 srcOffset = srcY * srcStride + x * s_virtualWidth / width;
+				outRow[x] = s_gpuColorConvert ? s_palette[src8[srcOffset]] : src32[srcOffset];
+			}
+		}
+	}
+}  // namespace
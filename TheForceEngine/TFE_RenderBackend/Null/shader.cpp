@@ -0,0 +1,59 @@
+#include <TFE_RenderBackend/shader.h>
+
+// Shaders are never compiled by the null backend, creation always succeeds
+// and variables are never found.
+bool Shader::create(const char* vertexShaderGLSL, const char* fragmentShaderGLSL, const char* defineString/* = nullptr*/, ShaderVersion version/* = SHADER_VER_COMPTABILE*/)
+{
+	m_shaderVersion = version;
+	return true;
+}
+
+bool Shader::load(const char* vertexShaderFile, const char* fragmentShaderFile, u32 defineCount/* = 0*/, ShaderDefine* defines/* = nullptr*/, ShaderVersion version/* = SHADER_VER_COMPTABILE*/)
+{
+	m_shaderVersion = version;
+	return true;
+}
+
+void Shader::enableClipPlanes(s32 count)
+{
+	m_clipPlaneCount = count;
+}
+
+void Shader::destroy()
+{
+	m_gpuHandle = 0;
+}
+
+void Shader::bind()
+{
+}
+
+void Shader::unbind()
+{
+}
+
+s32 Shader::getVariableId(const char* name)
+{
+	return -1;
+}
+
+s32 Shader::getVariables()
+{
+	return 0;
+}
+
+void Shader::bindTextureNameToSlot(const char* texName, s32 slot)
+{
+}
+
+void Shader::setVariable(s32 id, ShaderVariableType type, const f32* data)
+{
+}
+
+void Shader::setVariable(s32 id, ShaderVariableType type, const s32* data)
+{
+}
+
+void Shader::setVariable(s32 id, ShaderVariableType type, const u32* data)
+{
+}
@@ -0,0 +1,46 @@
+#include <TFE_RenderBackend/textureGpu.h>
+
+// The null backend keeps the texture dimensions but never stores texel data.
+TextureGpu::~TextureGpu()
+{
+}
+
+bool TextureGpu::create(u32 width, u32 height, u32 channels)
+{
+	m_width = width;
+	m_height = height;
+	m_channels = channels;
+	m_layers = 1;
+	return true;
+}
+
+bool TextureGpu::createArray(u32 width, u32 height, u32 layers, u32 channels)
+{
+	m_width = width;
+	m_height = height;
+	m_channels = channels;
+	m_layers = layers;
+	return true;
+}
+
+bool TextureGpu::createWithData(u32 width, u32 height, const void* buffer, MagFilter magFilter)
+{
+	return create(width, height, 4);
+}
+
+bool TextureGpu::update(const void* buffer, size_t size, s32 layer)
+{
+	return true;
+}
+
+void TextureGpu::bind(u32 slot/* = 0*/) const
+{
+}
+
+void TextureGpu::clear(u32 slot/* = 0*/)
+{
+}
+
+void TextureGpu::clearSlots(u32 count, u32 start/* = 0*/)
+{
+}
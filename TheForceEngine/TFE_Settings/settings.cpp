@@ -358,6 +358,7 @@ namespace TFE_Settings
 		writeKeyValue_Bool(settings, "colorCorrection", s_graphicsSettings.colorCorrection);
 		writeKeyValue_Bool(settings, "perspectiveCorrect3DO", s_graphicsSettings.perspectiveCorrectTexturing);
 		writeKeyValue_Bool(settings, "extendAjoinLimits", s_graphicsSettings.extendAjoinLimits);
+		writeKeyValue_Int(settings, "renderThreadCount", s_graphicsSettings.renderThreadCount);
 		writeKeyValue_Bool(settings, "vsync", s_graphicsSettings.vsync);
 		writeKeyValue_Bool(settings, "show_fps", s_graphicsSettings.showFps);
 		writeKeyValue_Bool(settings, "3doNormalFix", s_graphicsSettings.fix3doNormalOverflow);
@@ -436,6 +437,8 @@ namespace TFE_Settings
 				writeKeyValue_Bool(settings, "showSecretFoundMsg", s_gameSettings.df_showSecretFoundMsg);
 				writeKeyValue_Bool(settings, "autorun", s_gameSettings.df_autorun);
 				writeKeyValue_Bool(settings, "ignoreInfLimit", s_gameSettings.df_ignoreInfLimit);
+				writeKeyValue_Bool(settings, "levelCache", s_gameSettings.df_levelCache);
+				writeKeyValue_Int(settings, "assetCacheSize", s_gameSettings.df_assetCacheSize);
 				writeKeyValue_Int(settings, "pitchLimit", s_gameSettings.df_pitchLimit);
 			}
 		}
@@ -641,6 +644,10 @@ namespace TFE_Settings
 		{
 			s_graphicsSettings.extendAjoinLimits = parseBool(value);
 		}
+		else if (strcasecmp("renderThreadCount", key) == 0)
+		{
+			s_graphicsSettings.renderThreadCount = parseInt(value);
+		}
 		else if (strcasecmp("vsync", key) == 0)
 		{
 			s_graphicsSettings.vsync = parseBool(value);
@@ -881,6 +888,14 @@ namespace TFE_Settings
 		{
 			s_gameSettings.df_ignoreInfLimit = parseBool(value);
 		}
+		else if (strcasecmp("levelCache", key) == 0)
+		{
+			s_gameSettings.df_levelCache = parseBool(value);
+		}
+		else if (strcasecmp("assetCacheSize", key) == 0)
+		{
+			s_gameSettings.df_assetCacheSize = std::min(std::max(parseInt(value), 0), 1024);
+		}
 		else if (strcasecmp("pitchLimit", key) == 0)
 		{
 			s_gameSettings.df_pitchLimit = PitchLimit(parseInt(value));
@@ -46,6 +46,7 @@ struct TFE_Settings_Graphics
 	bool  colorCorrection = false;
 	bool  perspectiveCorrectTexturing = false;
 	bool  extendAjoinLimits = true;
+	s32   renderThreadCount = 1;	// Number of threads used by the software renderer.
 	bool  vsync = true;
 	bool  showFps = false;
 	bool  fix3doNormalOverflow = true;
@@ -163,6 +164,8 @@ struct TFE_Settings_Game
 	bool df_showSecretFoundMsg = true;  // Show a message when the player finds a secret.
 	bool df_autorun = false;			// Run by default instead of walk.
 	bool df_ignoreInfLimit = true;		// Ignore the vanilla INF limit.
+	bool df_levelCache = true;			// Cache parsed level geometry in ProgramData/Cache/.
+	s32  df_assetCacheSize = 64;		// Memory budget in MB for decoded level assets kept between levels, 0 = disabled.
 	PitchLimit df_pitchLimit  = PITCH_VANILLA_PLUS;
 };
 
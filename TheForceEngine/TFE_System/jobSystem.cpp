@@ -0,0 +1,117 @@
+#include <TFE_System/jobSystem.h>
+#include <TFE_System/system.h>
+#include <TFE_System/profiler.h>
+#include <algorithm>
+#include <cstdio>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace TFE_Jobs
+{
+	#define MAX_WORKER_COUNT 16
+
+	struct Job
+	{
+		JobFunc func;
+		void* userData;
+		atomic_s32* counter;
+	};
+
+	static std::vector<std::thread> s_workers;
+	static std::deque<Job> s_queue;
+	static std::mutex s_queueLock;
+	static std::condition_variable s_jobReady;
+	static std::condition_variable s_jobDone;
+	static bool s_exit = false;
+
+	void workerLoop(s32 index)
+	{
+		char threadName[32];
+		sprintf(threadName, "Job Worker %d", index);
+		TFE_Profiler::setThreadName(threadName);
+
+		std::unique_lock<std::mutex> lock(s_queueLock);
+		while (1)
+		{
+			s_jobReady.wait(lock, [] { return s_exit || !s_queue.empty(); });
+			// Finish the remaining jobs before exiting.
+			if (s_queue.empty()) { break; }
+
+			Job job = s_queue.front();
+			s_queue.pop_front();
+
+			lock.unlock();
+			job.func(job.userData);
+			lock.lock();
+
+			if (job.counter)
+			{
+				(*job.counter)--;
+				s_jobDone.notify_all();
+			}
+		}
+	}
+
+	void init(s32 workerCount)
+	{
+		if (!s_workers.empty()) { return; }
+
+		if (workerCount <= 0)
+		{
+			workerCount = std::max(s32(std::thread::hardware_concurrency()) - 1, 0);
+		}
+		workerCount = std::min(workerCount, MAX_WORKER_COUNT);
+
+		s_exit = false;
+		for (s32 i = 0; i < workerCount; i++)
+		{
+			s_workers.push_back(std::thread(workerLoop, i));
+		}
+		TFE_System::logWrite(LOG_MSG, "Jobs", "Started %d worker threads.", workerCount);
+	}
+
+	void shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lock(s_queueLock);
+			s_exit = true;
+		}
+		s_jobReady.notify_all();
+
+		for (size_t i = 0; i < s_workers.size(); i++)
+		{
+			s_workers[i].join();
+		}
+		s_workers.clear();
+	}
+
+	s32 getWorkerCount()
+	{
+		return s32(s_workers.size());
+	}
+
+	void addJob(JobFunc func, void* userData, atomic_s32* counter)
+	{
+		if (s_workers.empty())
+		{
+			func(userData);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_queueLock);
+			if (counter) { (*counter)++; }
+			s_queue.push_back({ func, userData, counter });
+		}
+		s_jobReady.notify_one();
+	}
+
+	void waitForCounter(atomic_s32* counter)
+	{
+		std::unique_lock<std::mutex> lock(s_queueLock);
+		s_jobDone.wait(lock, [counter] { return *counter <= 0; });
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// The Force Engine Job System
+// A small pool of worker threads that run queued jobs.
+// Jobs are grouped using counters, the caller can then wait for
+// a counter to reach zero.
+//////////////////////////////////////////////////////////////////////
+
+#include "types.h"
+
+typedef void(*JobFunc)(void* userData);
+
+namespace TFE_Jobs
+{
+	// Start the worker threads.
+	// A worker count of 0 uses one worker per hardware thread, minus one for the main thread.
+	void init(s32 workerCount = 0);
+	void shutdown();
+
+	// Number of worker threads, not including the main thread.
+	s32  getWorkerCount();
+
+	// Queue a job. If 'counter' is not null, it is incremented when the job is added
+	// and decremented once the job has finished.
+	// If there are no worker threads, the job is run immediately.
+	void addJob(JobFunc func, void* userData, atomic_s32* counter = nullptr);
+	// Block until 'counter' reaches zero.
+	// Jobs are never run on the waiting thread, so its thread_local state is left untouched.
+	void waitForCounter(atomic_s32* counter);
+}
@@ -9,6 +9,8 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <mutex>
+#include <thread>
 
 #ifdef _WIN32
 	#include <Windows.h>
@@ -20,6 +22,10 @@ namespace TFE_System
 	static FileStream s_logFile;
 	static char s_workStr[32768];
 	static char s_msgStr[32768];
+	// Jobs running on worker threads may log too, so writes are serialized.
+	// Only messages from the thread that opened the log are forwarded to the console.
+	static std::mutex s_logLock;
+	static std::thread::id s_mainThread;
 	static const char* c_typeNames[]=
 	{
 		"",			//LOG_MSG = 0,
@@ -32,6 +38,7 @@ namespace TFE_System
 	{
 		char logPath[TFE_MAX_PATH];
 		TFE_Paths::appendPath(PATH_USER_DOCUMENTS, filename, logPath);
+		s_mainThread = std::this_thread::get_id();
 
 		return s_logFile.open(logPath, Stream::MODE_WRITE);
 	}
@@ -44,6 +51,7 @@ namespace TFE_System
 	void debugWrite(const char* tag, const char* str, ...)
 	{
 		if (!tag || !str) { return; }
+		std::lock_guard<std::mutex> lock(s_logLock);
 
 		//Handle the variable input, "printf" style messages
 		va_list arg;
@@ -64,6 +72,7 @@ namespace TFE_System
 	void logWrite(LogWriteType type, const char* tag, const char* str, ...)
 	{
 		if (type >= LOG_COUNT || !s_logFile.isOpen() || !tag || !str) { return; }
+		std::lock_guard<std::mutex> lock(s_logLock);
 
 		//Handle the variable input, "printf" style messages
 		va_list arg;
@@ -97,6 +106,10 @@ namespace TFE_System
 		{
 			assert(0);
 		}
+		if (std::this_thread::get_id() != s_mainThread)
+		{
+			return;
+		}
 
 		sprintf(s_workStr, "[%s] %s", tag, s_msgStr);
 		size_t len = strlen(s_msgStr);
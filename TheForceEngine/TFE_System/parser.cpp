@@ -1,11 +1,15 @@
 #include <cstring>
+#include <cstdlib>
+#include <cstdarg>
+#include <cassert>
 
 #include "parser.h"
 #include <algorithm>
 
 namespace
 {
-	static char s_line[4096];
+	// Per thread so levels can be parsed on worker jobs while the main thread parses other files.
+	static thread_local char s_line[4096];
 	bool isWhitespace(const char c)
 	{
 		if (c > 32 && c < 127)
@@ -15,6 +19,15 @@ namespace
 		return true;
 	}
 
+	// Matches isspace() in the "C" locale, which is what sscanf() uses.
+	bool isScanWhitespace(const char c)
+	{
+		return c == ' ' || (c >= '\t' && c <= '\r');
+	}
+
+	// Powers of ten that are exactly representable as floats.
+	static const f32 c_exactPow10[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
 	bool isSeparator(const char c)
 	{
 		if (c == '=' || c == ',')
@@ -232,3 +245,179 @@ void TFE_Parser::tokenizeLine(const char* line, TokenList& tokens)
 		tokens.push_back(curToken);
 	}
 }
+
+///////////////////////////////////////////
+// TFE_LineScanner
+///////////////////////////////////////////
+TFE_LineScanner::TFE_LineScanner(const char* line) : m_pos(line ? line : ""), m_count(0), m_failed(false) {}
+
+s32 TFE_LineScanner::scan(const char* line, const char* format, ...)
+{
+	TFE_LineScanner scanner(line);
+
+	va_list args;
+	va_start(args, format);
+	char literalBuffer[256];
+	while (*format && !scanner.failed())
+	{
+		if (format[0] != '%' || format[1] == '%')
+		{
+			// Match the literal run up to the next directive.
+			size_t len = 0;
+			for (; *format && (format[0] != '%' || format[1] == '%') && len + 1 < sizeof(literalBuffer); format++)
+			{
+				if (format[0] == '%') { format++; }
+				literalBuffer[len++] = *format;
+			}
+			literalBuffer[len] = 0;
+			scanner.match(literalBuffer);
+			continue;
+		}
+
+		format++;
+		switch (*format)
+		{
+			case 'd':
+			{
+				scanner.readInt(va_arg(args, s32*));
+			} break;
+			case 'f':
+			{
+				scanner.readFloat(va_arg(args, f32*));
+			} break;
+			case 's':
+			{
+				// Like sscanf(), the destination is assumed to be large enough.
+				scanner.readString(va_arg(args, char*), SIZE_MAX);
+			} break;
+			default:
+			{
+				assert(0);
+				scanner.fail();
+			}
+		}
+		if (*format) { format++; }
+	}
+	va_end(args);
+
+	return scanner.getCount();
+}
+
+void TFE_LineScanner::skipWhitespace()
+{
+	while (isScanWhitespace(*m_pos)) { m_pos++; }
+}
+
+bool TFE_LineScanner::fail()
+{
+	m_failed = true;
+	return false;
+}
+
+bool TFE_LineScanner::match(const char* literal)
+{
+	if (m_failed) { return false; }
+	for (; *literal; literal++)
+	{
+		if (isScanWhitespace(*literal))
+		{
+			skipWhitespace();
+		}
+		else if (*m_pos == *literal)
+		{
+			m_pos++;
+		}
+		else
+		{
+			return fail();
+		}
+	}
+	return true;
+}
+
+bool TFE_LineScanner::readInt(s32* value)
+{
+	if (m_failed) { return false; }
+	skipWhitespace();
+
+	const char* pos = m_pos;
+	const bool negative = *pos == '-';
+	if (*pos == '-' || *pos == '+') { pos++; }
+	if (*pos < '0' || *pos > '9') { return fail(); }
+
+	u64 result = 0;
+	for (; *pos >= '0' && *pos <= '9'; pos++)
+	{
+		result = result * 10 + u64(*pos - '0');
+	}
+	*value = s32(negative ? (~result + 1) : result);
+
+	m_pos = pos;
+	m_count++;
+	return true;
+}
+
+bool TFE_LineScanner::readFloat(f32* value)
+{
+	if (m_failed) { return false; }
+	skipWhitespace();
+
+	// Fast path for plain decimals: when both the digits and the power of ten are exact in single precision,
+	// a single float division is correctly rounded and gives the same result as strtof().
+	const char* pos = m_pos;
+	const bool negative = *pos == '-';
+	if (*pos == '-' || *pos == '+') { pos++; }
+
+	u64 mantissa = 0;
+	s32 digitCount = 0;
+	s32 fractionCount = 0;
+	for (; *pos >= '0' && *pos <= '9'; pos++, digitCount++)
+	{
+		mantissa = mantissa * 10 + u64(*pos - '0');
+	}
+	if (*pos == '.')
+	{
+		pos++;
+		for (; *pos >= '0' && *pos <= '9'; pos++, digitCount++, fractionCount++)
+		{
+			mantissa = mantissa * 10 + u64(*pos - '0');
+		}
+	}
+
+	const char next = *pos;
+	const bool exponentOrHex = next == 'e' || next == 'E' || next == 'x' || next == 'X';
+	if (digitCount > 0 && digitCount <= 18 && !exponentOrHex && mantissa <= (1ull << 24) && fractionCount < (s32)TFE_ARRAYSIZE(c_exactPow10))
+	{
+		const f32 result = f32(mantissa) / c_exactPow10[fractionCount];
+		*value = negative ? -result : result;
+		m_pos = pos;
+		m_count++;
+		return true;
+	}
+
+	// Everything else (exponents, long mantissas, inf/nan) goes through the C library.
+	char* end = nullptr;
+	const f32 result = strtof(m_pos, &end);
+	if (end == m_pos) { return fail(); }
+
+	*value = result;
+	m_pos = end;
+	m_count++;
+	return true;
+}
+
+bool TFE_LineScanner::readString(char* value, size_t size)
+{
+	if (m_failed) { return false; }
+	skipWhitespace();
+	if (!*m_pos) { return fail(); }
+
+	size_t len = 0;
+	for (; *m_pos && !isScanWhitespace(*m_pos); m_pos++)
+	{
+		if (len + 1 < size) { value[len++] = *m_pos; }
+	}
+	value[len] = 0;
+	m_count++;
+	return true;
+}
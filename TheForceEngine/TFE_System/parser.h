@@ -48,3 +48,41 @@ private:
 private:
 	bool isComment(const char* buffer);
 };
+
+// Zero allocation replacement for sscanf() on the lines returned by TFE_Parser::readLine().
+// Each function consumes the input the same way as the matching scanf() directive and the scan
+// stops at the first directive that fails, so getCount() matches the value sscanf() would return
+// (except that no input is reported as 0 rather than EOF).
+//   sscanf(line, " SECTOR %d", &id) == 1
+//   TFE_LineScanner scan(line); scan.match(" SECTOR") && scan.readInt(&id)
+//   TFE_LineScanner::scan(line, " SECTOR %d", &id) == 1
+class TFE_LineScanner
+{
+public:
+	TFE_LineScanner(const char* line);
+
+	// Drop-in for sscanf(), only whitespace, literal text, %d, %f and %s are supported.
+	static s32 scan(const char* line, const char* format, ...);
+
+	// Literal text, whitespace in 'literal' matches any amount of whitespace (including none).
+	bool match(const char* literal);
+	// %d
+	bool readInt(s32* value);
+	// %f
+	bool readFloat(f32* value);
+	// %s - the string is truncated to fit in 'size' bytes, but the whole token is still consumed.
+	bool readString(char* value, size_t size);
+
+	// The number of values successfully read so far.
+	s32 getCount() const { return m_count; }
+	bool failed() const { return m_failed; }
+
+private:
+	const char* m_pos;
+	s32  m_count;
+	bool m_failed;
+
+private:
+	void skipWhitespace();
+	bool fail();
+};
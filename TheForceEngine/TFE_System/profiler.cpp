@@ -1,36 +1,64 @@
 #include <cstring>
 
 #include "profiler.h"
+#include <TFE_FileSystem/filestream.h>
 #include <assert.h>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <map>
 
-// TODO: Support call "paths" - with seperate time per path.
-
 namespace TFE_Profiler
 {
 	#define ZONE_BUFFER_COUNT 2
 	#define MAX_ZONE_STACK 256
-	
+	#define MAX_ZONES 2048
+	#define MAX_NODES 8192
+	#define MAX_PROFILE_THREADS 64
+	// Number of events each thread can record between frames, must be a power of 2.
+	#define THREAD_EVENT_COUNT (1 << 14)
+	#define THREAD_EVENT_MASK (THREAD_EVENT_COUNT - 1)
+
+	enum ThreadSlotState
+	{
+		SLOT_ACTIVE = 0,	// Owned by a running thread.
+		SLOT_RELEASED,		// The thread exited, the main thread still has to read its remaining events.
+		SLOT_FREE,			// Drained and ready to be reused by a new thread.
+	};
+
+	enum ZoneEventType
+	{
+		ZEVENT_BEGIN = 0,
+		ZEVENT_END,
+	};
+
 	struct Zone
 	{
 		u32  id;
-		u32  level = 0;
-		u32  parent = NULL_ZONE;
-		u64  path;
-		u64  frame;
 		char name[64];
 		char func[64];
 		u32  lineNumber;
+	};
 
-		f64  timeInZone[ZONE_BUFFER_COUNT];
-		f64  timeInZoneAve;
+	// A unique call path, identified by its parent node and zone.
+	struct Node
+	{
+		u32  zoneId;
+		u32  threadIndex;
+		u32  depth;
+		u32  parent;
+		u32  child;
+		u32  sibling;
+
+		u32  callCount[ZONE_BUFFER_COUNT];
+		f64  timeTotal[ZONE_BUFFER_COUNT];
+		f64  timeSelf[ZONE_BUFFER_COUNT];
+		f64  timeChildren;
+		f64  timeTotalAve;
+		f64  timeSelfAve;
 		f64  fractOfParentAve;
-
-		u32  child = NULL_ZONE;
-		u32  sibling = NULL_ZONE;
 	};
 
 	struct Counter
@@ -42,15 +70,63 @@ namespace TFE_Profiler
 		char name[64];
 	};
 
+	struct ZoneEvent
+	{
+		u64 time;
+		u32 zoneId;
+		u32 type;
+	};
+
+	// Single producer (the owning thread), single consumer (the main thread at the end of the frame).
+	struct ThreadEvents
+	{
+		ZoneEvent events[THREAD_EVENT_COUNT];
+		std::atomic<u32> writeIndex;
+		std::atomic<u32> readIndex;
+		std::atomic<u32> droppedCount;
+		std::atomic<u32> state;
+		char name[64];
+
+		// Consumer state, zones may begin and end in different frames.
+		u32 stack[MAX_ZONE_STACK];
+		u32 stackNode[MAX_ZONE_STACK];
+		u64 stackTime[MAX_ZONE_STACK];
+		u32 level;
+		u32 rootNode;
+	};
+
+	struct CaptureEvent
+	{
+		u64 time;
+		u32 zoneId;
+		u16 threadIndex;
+		u16 type;
+	};
+
 	typedef std::map<std::string, u32> ZoneMap;
-	typedef std::vector<Zone> ZoneList;
-	typedef std::vector<u32> SortedZoneList;
+	typedef std::vector<Node> NodeList;
 	typedef std::vector<Counter> CounterList;
 
-	static ZoneMap  s_zoneMap;
-	static ZoneList s_zoneList;
-	static SortedZoneList s_sortedZoneList;
-	static SortedZoneList s_roots;
+	// Zones are stored in a fixed array so they can be registered from any thread while the list is read.
+	static Zone s_zoneList[MAX_ZONES];
+	static std::atomic<u32> s_zoneCount(0);
+	static std::mutex s_registerLock;
+	// Call tree nodes are only touched by the main thread.
+	static NodeList s_nodes;
+
+	static ThreadEvents* s_threads[MAX_PROFILE_THREADS];
+	static std::atomic<u32> s_threadCount(0);
+
+	// Releases the thread's slot when the thread exits, so short-lived threads do not use up the slots.
+	struct ThreadSlot
+	{
+		ThreadEvents* events = nullptr;
+		~ThreadSlot()
+		{
+			if (events) { events->state.store(SLOT_RELEASED, std::memory_order_release); }
+		}
+	};
+	static thread_local ThreadSlot s_threadSlot;
 
 	static ZoneMap  s_counterMap;
 	static CounterList s_counterList;
@@ -59,101 +135,141 @@ namespace TFE_Profiler
 	static f64 s_frameTime;
 	static u32 s_readBuffer = 0;
 	static u32 s_writeBuffer = 1;
-	static u32 s_level;
-	static u32 s_maxLevel;
-	static u32 s_zoneStack[MAX_ZONE_STACK];
-	static u64 s_currentFrame = 1;
-	static u64 s_currentPath;
 
-	void addZoneChild(u32 parentId, u32 zoneId)
+	static std::vector<CaptureEvent> s_captureEvents;
+	static u32 s_captureFramesLeft = 0;
+	static char s_capturePath[TFE_MAX_PATH];
+
+	void writeCapture();
+
+	ThreadEvents* getThreadEvents()
 	{
-		Zone& parent = s_zoneList[parentId];
-		Zone& zone = s_zoneList[zoneId];
-		// This has already been added.
-		if (zone.sibling != NULL_ZONE)
-		{
-			return;
-		}
+		if (s_threadSlot.events) { return s_threadSlot.events; }
 
-		if (parent.child == zoneId)
-		{
-			return;
-		}
-		else if (parent.child == NULL_ZONE)
+		std::lock_guard<std::mutex> lock(s_registerLock);
+		// Reuse the slot of a thread that has exited, the new thread continues its call tree.
+		const u32 threadCount = s_threadCount.load();
+		for (u32 t = 0; t < threadCount; t++)
 		{
-			parent.child = zoneId;
-		}
-		else
-		{
-			Zone* child = &s_zoneList[parent.child];
-			while (1)
+			ThreadEvents* threadEvents = s_threads[t];
+			if (threadEvents->state.load(std::memory_order_acquire) == SLOT_FREE)
 			{
-				if (child->sibling == zoneId)
-				{
-					return;
-				}
-				else if (child->sibling == NULL_ZONE)
-				{
-					child->sibling = zoneId;
-					break;
-				}
-				child = &s_zoneList[child->sibling];
-			};
+				threadEvents->droppedCount = 0;
+				threadEvents->name[0] = 0;
+				threadEvents->state.store(SLOT_ACTIVE, std::memory_order_release);
+				s_threadSlot.events = threadEvents;
+				return threadEvents;
+			}
 		}
+		if (threadCount >= MAX_PROFILE_THREADS) { return nullptr; }
+
+		ThreadEvents* threadEvents = new ThreadEvents();
+		threadEvents->writeIndex = 0;
+		threadEvents->readIndex = 0;
+		threadEvents->droppedCount = 0;
+		threadEvents->state = SLOT_ACTIVE;
+		threadEvents->name[0] = 0;
+		threadEvents->level = 0;
+		threadEvents->rootNode = NULL_NODE;
+
+		s_threads[threadCount] = threadEvents;
+		s_threadCount.store(threadCount + 1);
+		s_threadSlot.events = threadEvents;
+		return threadEvents;
 	}
 
-	u32 beginZone(const char* name, const char* func, u32 lineNumber)
+	u32 addNode(u32 parent, u32 zoneId, u32 threadIndex)
 	{
-		ZoneMap::iterator iZone = s_zoneMap.find(name);
-		u32 id = 0;
+		if (s_nodes.size() >= MAX_NODES) { return NULL_NODE; }
+
+		Node node = {};
+		node.zoneId = zoneId;
+		node.threadIndex = threadIndex;
+		node.depth = parent != NULL_NODE ? s_nodes[parent].depth + 1 : 0;
+		node.parent = parent;
+		node.child = NULL_NODE;
+		node.sibling = NULL_NODE;
+
+		const u32 index = (u32)s_nodes.size();
+		s_nodes.push_back(node);
+		return index;
+	}
 
-		if (iZone == s_zoneMap.end())
-		{
-			id = (u32)s_zoneList.size();
-
-			Zone zone;
-			zone.id = id;
-			zone.path = s_currentPath;
-			zone.timeInZone[s_readBuffer]  = 0;
-			zone.timeInZone[s_writeBuffer] = 0;
-			zone.timeInZoneAve = 0.0;
-			zone.fractOfParentAve = 0.0;
-			zone.frame = 0;
-			
-			s_zoneList.push_back(zone);
-			s_zoneMap[name] = id;
-		}
-		else
+	// Find the node for 'zoneId' called from 'parent', adding it the first time the path is seen.
+	// Children are always added after their parent, so a node index is larger than its parent index.
+	u32 getChildNode(u32 parent, u32 zoneId, u32 threadIndex)
+	{
+		u32 prev = NULL_NODE;
+		for (u32 child = s_nodes[parent].child; child != NULL_NODE; child = s_nodes[child].sibling)
 		{
-			id = iZone->second;
+			if (s_nodes[child].zoneId == zoneId) { return child; }
+			prev = child;
 		}
 
+		const u32 index = addNode(parent, zoneId, threadIndex);
+		if (index == NULL_NODE) { return NULL_NODE; }
+
+		if (prev == NULL_NODE) { s_nodes[parent].child = index; }
+		else { s_nodes[prev].sibling = index; }
+		return index;
+	}
+
+	u32 registerZone(const char* name, const char* func, u32 lineNumber)
+	{
+		std::lock_guard<std::mutex> lock(s_registerLock);
+		const u32 id = s_zoneCount.load();
+		if (id >= MAX_ZONES) { return NULL_ZONE; }
+
 		Zone& zone = s_zoneList[id];
-		strcpy(zone.name, name);
-		strcpy(zone.func, func);
+		zone.id = id;
+		strncpy(zone.name, name, 63);
+		strncpy(zone.func, func, 63);
+		zone.name[63] = 0;
+		zone.func[63] = 0;
 		zone.lineNumber = lineNumber;
-		zone.level = s_level;
 
-		zone.parent = s_level > 0 ? s_zoneStack[s_level - 1] : NULL_ZONE;
-		if (zone.parent == NULL_ZONE)
-		{
-			s_roots.push_back(id);
-		}
-		else
+		s_zoneCount.store(id + 1);
+		return id;
+	}
+
+	void pushEvent(u32 id, ZoneEventType type)
+	{
+		if (id == NULL_ZONE) { return; }
+		ThreadEvents* threadEvents = getThreadEvents();
+		if (!threadEvents) { return; }
+
+		const u32 writeIndex = threadEvents->writeIndex.load(std::memory_order_relaxed);
+		const u32 readIndex = threadEvents->readIndex.load(std::memory_order_acquire);
+		if (writeIndex - readIndex >= THREAD_EVENT_COUNT)
 		{
-			addZoneChild(zone.parent, zone.id);
+			threadEvents->droppedCount.fetch_add(1, std::memory_order_relaxed);
+			return;
 		}
 
-		s_zoneStack[s_level] = id;
-		s_level++;
+		ZoneEvent& zoneEvent = threadEvents->events[writeIndex & THREAD_EVENT_MASK];
+		zoneEvent.time = TFE_System::getCurrentTimeInTicks();
+		zoneEvent.zoneId = id;
+		zoneEvent.type = type;
+		threadEvents->writeIndex.store(writeIndex + 1, std::memory_order_release);
+	}
 
-		return id;
+	void beginZone(u32 id)
+	{
+		pushEvent(id, ZEVENT_BEGIN);
+	}
+
+	void endZone(u32 id)
+	{
+		pushEvent(id, ZEVENT_END);
 	}
 
-	void endZone(u32 id, u64 dt)
+	void setThreadName(const char* name)
 	{
-		s_zoneList[id].timeInZone[s_writeBuffer] += TFE_System::convertFromTicksToSeconds(dt);
-		s_level--;
+		ThreadEvents* threadEvents = getThreadEvents();
+		if (!threadEvents || threadEvents->name[0]) { return; }
+
+		strncpy(threadEvents->name, name, 63);
+		threadEvents->name[63] = 0;
 	}
 
 	void addCounter(const char* name, s32* counter)
@@ -176,16 +292,16 @@ namespace TFE_Profiler
 
 	void frameBegin()
 	{
+		setThreadName("Main");
 		std::swap(s_readBuffer, s_writeBuffer);
-		s_level = 0;
-		s_maxLevel = 0;
-		s_roots.clear();
 
 		// Swap buffers, s_readBuffer is safe to read in the middle of the next frame.
-		const size_t zoneCount = s_zoneList.size();
-		for (size_t i = 0; i < zoneCount; i++)
+		const size_t nodeCount = s_nodes.size();
+		for (size_t i = 0; i < nodeCount; i++)
 		{
-			s_zoneList[i].timeInZone[s_writeBuffer] = 0;
+			s_nodes[i].callCount[s_writeBuffer] = 0;
+			s_nodes[i].timeTotal[s_writeBuffer] = 0.0;
+			s_nodes[i].timeSelf[s_writeBuffer] = 0.0;
 		}
 
 		// Copy counter values from the frame, so that the results can be used
@@ -199,88 +315,266 @@ namespace TFE_Profiler
 		s_frameBegin = TFE_System::getCurrentTimeInTicks();
 	}
 
-	void traverseZoneTree(u32 id)
+	// Read the events recorded by a thread since the last frame and accumulate the time for each call path.
+	void processThreadEvents(u32 threadIndex)
 	{
-		if (id == NULL_ZONE) { return; }
-		Zone* zone = &s_zoneList[id];
-		// Make sure zones are only inserted once for now.
-		if (zone->frame != s_currentFrame)
+		ThreadEvents* threadEvents = s_threads[threadIndex];
+		// Read the state before the events, so every event written before the thread exited is processed below.
+		const u32 state = threadEvents->state.load(std::memory_order_acquire);
+		if (state == SLOT_FREE) { return; }
+		if (threadEvents->rootNode == NULL_NODE)
 		{
-			s_sortedZoneList.push_back(id);
+			threadEvents->rootNode = addNode(NULL_NODE, NULL_ZONE, threadIndex);
 		}
-		zone->frame = s_currentFrame;
-		
-		while (zone->child != NULL_ZONE)
+		const u32 readIndex = threadEvents->readIndex.load(std::memory_order_relaxed);
+		const u32 writeIndex = threadEvents->writeIndex.load(std::memory_order_acquire);
+
+		for (u32 i = readIndex; i != writeIndex; i++)
 		{
-			traverseZoneTree(zone->child);
-			zone = &s_zoneList[zone->child];
+			const ZoneEvent& zoneEvent = threadEvents->events[i & THREAD_EVENT_MASK];
+			if (s_captureFramesLeft)
+			{
+				s_captureEvents.push_back({ zoneEvent.time, zoneEvent.zoneId, u16(threadIndex), u16(zoneEvent.type) });
+			}
+
+			if (zoneEvent.type == ZEVENT_BEGIN)
+			{
+				if (threadEvents->level >= MAX_ZONE_STACK) { continue; }
+
+				// Once the node limit is reached new paths are still tracked on the stack but not timed.
+				const u32 parent = threadEvents->level > 0 ? threadEvents->stackNode[threadEvents->level - 1] : threadEvents->rootNode;
+				const u32 node = parent != NULL_NODE ? getChildNode(parent, zoneEvent.zoneId, threadIndex) : NULL_NODE;
+
+				threadEvents->stack[threadEvents->level] = zoneEvent.zoneId;
+				threadEvents->stackNode[threadEvents->level] = node;
+				threadEvents->stackTime[threadEvents->level] = zoneEvent.time;
+				threadEvents->level++;
+			}
+			// Ignore unmatched end events, which can happen if events were dropped.
+			else if (threadEvents->level > 0 && threadEvents->stack[threadEvents->level - 1] == zoneEvent.zoneId)
+			{
+				threadEvents->level--;
+				const u32 node = threadEvents->stackNode[threadEvents->level];
+				if (node != NULL_NODE)
+				{
+					const u64 dt = zoneEvent.time - threadEvents->stackTime[threadEvents->level];
+					s_nodes[node].timeTotal[s_writeBuffer] += TFE_System::convertFromTicksToSeconds(dt);
+					s_nodes[node].callCount[s_writeBuffer]++;
+				}
+			}
 		}
+		threadEvents->readIndex.store(writeIndex, std::memory_order_release);
 
-		zone = &s_zoneList[id];
-		while (zone->sibling != NULL_ZONE)
+		if (state == SLOT_RELEASED)
 		{
-			traverseZoneTree(zone->sibling);
-			zone = &s_zoneList[zone->sibling];
+			// Zones still open when the thread exited are never closed.
+			threadEvents->level = 0;
+			threadEvents->state.store(SLOT_FREE, std::memory_order_release);
 		}
 	}
 
 	void frameEnd()
 	{
 		s_frameTime = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - s_frameBegin);
-		const size_t zoneCount = s_zoneList.size();
 		const f64 expBlend = 0.99;
 
-		// Sort Zones
-		s_sortedZoneList.clear();
-		const size_t rootCount = s_roots.size();
-		for (size_t r = 0; r < rootCount; r++)
+		// Gather the events from every thread.
+		const u32 threadCount = s_threadCount.load();
+		for (u32 t = 0; t < threadCount; t++)
 		{
-			traverseZoneTree(s_roots[r]);
+			processThreadEvents(t);
 		}
+		const s32 nodeCount = (s32)s_nodes.size();
 
-		// First compute delta times for each zone.
-		for (size_t i = 0; i < zoneCount; i++)
+		// Compute self time bottom up, children are always stored after their parents.
+		for (s32 i = 0; i < nodeCount; i++)
 		{
-			s_zoneList[i].timeInZoneAve = expBlend * s_zoneList[i].timeInZoneAve + (1.0 - expBlend)*s_zoneList[i].timeInZone[s_writeBuffer];
+			s_nodes[i].timeChildren = 0.0;
+		}
+		for (s32 i = nodeCount - 1; i >= 0; i--)
+		{
+			Node& node = s_nodes[i];
+			// Thread roots have no zone, so their time is the sum of the top level zones.
+			if (node.zoneId == NULL_ZONE)
+			{
+				node.timeTotal[s_writeBuffer] = node.timeChildren;
+			}
+			node.timeSelf[s_writeBuffer] = std::max(0.0, node.timeTotal[s_writeBuffer] - node.timeChildren);
+			if (node.parent != NULL_NODE)
+			{
+				s_nodes[node.parent].timeChildren += node.timeTotal[s_writeBuffer];
+			}
 		}
 
-		// Then handle percentage of parent and clear
-		for (size_t i = 0; i < zoneCount; i++)
+		// Then handle the averages and percentage of parent, the top level zones are relative to the frame.
+		for (s32 i = 0; i < nodeCount; i++)
 		{
-			f64 parentTime = (s_zoneList[i].parent != NULL_ZONE) ? s_zoneList[s_zoneList[i].parent].timeInZone[s_writeBuffer] : s_frameTime;
-			s_zoneList[i].fractOfParentAve = expBlend * s_zoneList[i].fractOfParentAve + (1.0 - expBlend)*s_zoneList[i].timeInZone[s_writeBuffer] / parentTime;
-			// Handle the rare case the parentTime = 0 causing s_zoneList[i].fractOfParentAve to become NAN. Once that happens it will never fix itself
+			Node& node = s_nodes[i];
+			node.timeTotalAve = expBlend * node.timeTotalAve + (1.0 - expBlend)*node.timeTotal[s_writeBuffer];
+			node.timeSelfAve  = expBlend * node.timeSelfAve  + (1.0 - expBlend)*node.timeSelf[s_writeBuffer];
+
+			const f64 parentTime = node.depth > 1 ? s_nodes[node.parent].timeTotal[s_writeBuffer] : s_frameTime;
+			node.fractOfParentAve = expBlend * node.fractOfParentAve + (1.0 - expBlend)*node.timeTotal[s_writeBuffer] / parentTime;
+			// Handle the rare case the parentTime = 0 causing fractOfParentAve to become NAN. Once that happens it will never fix itself
 			// because we are doing an average. So fix it manually.
-			if (isnan(s_zoneList[i].fractOfParentAve))
+			if (isnan(node.fractOfParentAve))
 			{
-				s_zoneList[i].fractOfParentAve = 0.0;
+				node.fractOfParentAve = 0.0;
 			}
+		}
 
-			s_zoneList[i].child = NULL_ZONE;
-			s_zoneList[i].sibling = NULL_ZONE;
+		if (s_captureFramesLeft)
+		{
+			s_captureFramesLeft--;
+			if (!s_captureFramesLeft)
+			{
+				writeCapture();
+			}
 		}
+	}
 
-		s_currentFrame++;
+	bool beginCapture(u32 frameCount, const char* path)
+	{
+		if (s_captureFramesLeft || !frameCount) { return false; }
+
+		strncpy(s_capturePath, path, TFE_MAX_PATH - 1);
+		s_capturePath[TFE_MAX_PATH - 1] = 0;
+		s_captureEvents.clear();
+		s_captureFramesLeft = frameCount;
+		return true;
+	}
+
+	bool isCapturing()
+	{
+		return s_captureFramesLeft > 0;
 	}
 
-	u32 getZoneCount()
+	void writeJsonString(FileStream& file, const char* str)
 	{
-		return (u32)s_sortedZoneList.size();
+		char escaped[256];
+		u32 len = 0;
+		for (; *str && len < 250; str++)
+		{
+			if (*str == '"' || *str == '\\') { escaped[len++] = '\\'; }
+			escaped[len++] = *str;
+		}
+		escaped[len] = 0;
+		file.writeString("\"%s\"", escaped);
 	}
 
-	void getZoneInfo(u32 index, TFE_ZoneInfo* info)
+	// Write the capture using the Chrome "Trace Event Format" with begin/end duration events.
+	void writeCapture()
 	{
-		if (index >= (u32)s_sortedZoneList.size()) { return; }
-
-		Zone& zone = s_zoneList[s_sortedZoneList[index]];
-		info->name = zone.name;
-		info->func = zone.func;
-		info->level = zone.level;
-		info->lineNumber = zone.lineNumber;
-		info->timeInZone = zone.timeInZone[s_readBuffer];
-		info->timeInZoneAve = zone.timeInZoneAve;
-		info->fractOfParentAve = zone.fractOfParentAve;
-		info->parentId = zone.parent;
+		FileStream file;
+		if (!file.open(s_capturePath, Stream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_ERROR, "Profiler", "Cannot write the profile capture to '%s'.", s_capturePath);
+			s_captureEvents.clear();
+			return;
+		}
+
+		const u32 threadCount = s_threadCount.load();
+		const u64 startTime = s_captureEvents.empty() ? 0 : s_captureEvents[0].time;
+		std::vector<u32> depth(threadCount, 0);
+		std::vector<u64> lastTime(threadCount, startTime);
+
+		file.writeString("{\"traceEvents\":[\n");
+		for (u32 t = 0; t < threadCount; t++)
+		{
+			char name[64];
+			if (s_threads[t]->name[0]) { strcpy(name, s_threads[t]->name); }
+			else { sprintf(name, "Thread %u", t); }
+
+			file.writeString("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":", t);
+			writeJsonString(file, name);
+			file.writeString("}},\n");
+		}
+
+		const size_t eventCount = s_captureEvents.size();
+		for (size_t i = 0; i < eventCount; i++)
+		{
+			const CaptureEvent& captureEvent = s_captureEvents[i];
+			const u32 t = captureEvent.threadIndex;
+			// Skip end events for zones that began before the capture.
+			if (captureEvent.type == ZEVENT_END)
+			{
+				if (!depth[t]) { continue; }
+				depth[t]--;
+			}
+			else
+			{
+				depth[t]++;
+			}
+			lastTime[t] = std::max(lastTime[t], captureEvent.time);
+
+			const f64 timeInUs = TFE_System::convertFromTicksToSeconds(captureEvent.time - std::min(captureEvent.time, startTime)) * 1000000.0;
+			file.writeString("{\"name\":");
+			writeJsonString(file, s_zoneList[captureEvent.zoneId].name);
+			file.writeString(",\"cat\":");
+			writeJsonString(file, s_zoneList[captureEvent.zoneId].func);
+			file.writeString(",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":0,\"tid\":%u},\n", captureEvent.type == ZEVENT_BEGIN ? "B" : "E", timeInUs, t);
+		}
+
+		// Close zones that were still open when the capture ended.
+		for (u32 t = 0; t < threadCount; t++)
+		{
+			const f64 timeInUs = TFE_System::convertFromTicksToSeconds(lastTime[t] - startTime) * 1000000.0;
+			for (; depth[t] > 0; depth[t]--)
+			{
+				file.writeString("{\"ph\":\"E\",\"ts\":%.3f,\"pid\":0,\"tid\":%u},\n", timeInUs, t);
+			}
+		}
+		// Metadata last, so every event line above can end with a comma.
+		file.writeString("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"The Force Engine\"}}\n");
+		file.writeString("]}\n");
+		file.close();
+
+		TFE_System::logWrite(LOG_MSG, "Profiler", "Wrote %u profile events to '%s'.", u32(eventCount), s_capturePath);
+		s_captureEvents.clear();
+	}
+
+	u32 getThreadCount()
+	{
+		return s_threadCount.load();
+	}
+
+	u32 getThreadRootNode(u32 threadIndex)
+	{
+		if (threadIndex >= s_threadCount.load()) { return NULL_NODE; }
+		return s_threads[threadIndex]->rootNode;
+	}
+
+	bool getNodeInfo(u32 index, TFE_NodeInfo* info)
+	{
+		if (index >= (u32)s_nodes.size()) { return false; }
+
+		const Node& node = s_nodes[index];
+		if (node.zoneId != NULL_ZONE)
+		{
+			const Zone& zone = s_zoneList[node.zoneId];
+			info->name = zone.name;
+			info->func = zone.func;
+			info->lineNumber = zone.lineNumber;
+		}
+		else
+		{
+			const ThreadEvents* threadEvents = s_threads[node.threadIndex];
+			info->name = threadEvents->name[0] ? threadEvents->name : "Unnamed Thread";
+			info->func = "";
+			info->lineNumber = 0;
+		}
+		info->zoneId = node.zoneId;
+		info->depth = node.depth;
+		info->parent = node.parent;
+		info->child = node.child;
+		info->sibling = node.sibling;
+		info->callCount = node.callCount[s_readBuffer];
+		info->timeTotal = node.timeTotal[s_readBuffer];
+		info->timeSelf = node.timeSelf[s_readBuffer];
+		info->timeTotalAve = node.timeTotalAve;
+		info->timeSelfAve = node.timeSelfAve;
+		info->fractOfParentAve = node.fractOfParentAve;
+		return true;
 	}
 
 	f64 getTimeInFrame()
@@ -3,7 +3,17 @@
 // The Force Engine Profiler
 // Simple "zone" based profiler.
 // Add TFE_PROFILE_ENABLED to preprocessor defines in the build to enable.
-// Currently does not respect the call path, that is TODO.
+//
+// Zones are registered once per call site and record begin/end events
+// into a lock-free ring buffer owned by the calling thread, so zones can
+// be used from any thread. The events are gathered at the end of each
+// frame on the main thread, and can be captured over several frames
+// and exported as a Chrome/Perfetto trace. The buffer of a thread is
+// reused by the next thread that starts after it exits.
+//
+// Timing is aggregated per call path: the same zone reached from
+// different parents gets a separate node in the call tree, each thread
+// has its own root node.
 //////////////////////////////////////////////////////////////////////
 
 #include "types.h"
@@ -14,8 +24,10 @@
 #define TOKENPASTE(x, y) x ## y
 #define TOKENPASTE2(x, y) TOKENPASTE(x, y)
 #ifdef  TFE_PROFILE_ENABLED
-#define TFE_ZONE(name)  TFE_Profiler_Zone TOKENPASTE2(__localZone, __LINE__)(name, __FUNCTION__, __LINE__)
-#define TFE_ZONE_BEGIN(varName, name)  TFE_Profiler_ZoneManual varName(name, __FUNCTION__, __LINE__)
+#define TFE_ZONE(name)  static const u32 TOKENPASTE2(__zoneId, __LINE__) = TFE_Profiler::registerZone(name, __FUNCTION__, __LINE__); \
+	TFE_Profiler_Zone TOKENPASTE2(__localZone, __LINE__)(TOKENPASTE2(__zoneId, __LINE__))
+#define TFE_ZONE_BEGIN(varName, name)  static const u32 TOKENPASTE2(__zoneId_, varName) = TFE_Profiler::registerZone(name, __FUNCTION__, __LINE__); \
+	TFE_Profiler_ZoneManual varName(TOKENPASTE2(__zoneId_, varName))
 #define TFE_ZONE_END(varName)  varName.end()
 #define TFE_FRAME_BEGIN() TFE_Profiler::frameBegin()
 #define TFE_FRAME_END() TFE_Profiler::frameEnd()
@@ -30,17 +42,25 @@
 #endif
 
 #define NULL_ZONE 0xffffffff
+#define NULL_NODE 0xffffffff
 
 #ifdef TFE_PROFILE_ENABLED
-struct TFE_ZoneInfo
+// A node in the call tree, the root node of each thread has no zone.
+struct TFE_NodeInfo
 {
-	char* name;
-	char* func;
+	const char* name;
+	const char* func;
 	u32  lineNumber;
-	u32  level;
-	u32  parentId;
-	f64  timeInZone;
-	f64  timeInZoneAve;
+	u32  zoneId;
+	u32  depth;
+	u32  parent;
+	u32  child;
+	u32  sibling;
+	u32  callCount;		// calls in the last frame.
+	f64  timeTotal;		// time in the last frame, including children.
+	f64  timeSelf;		// time in the last frame, excluding children.
+	f64  timeTotalAve;
+	f64  timeSelfAve;
 	f64  fractOfParentAve;
 };
 
@@ -53,20 +73,31 @@ struct TFE_CounterInfo
 namespace TFE_Profiler
 {
 	// The main profiling API is used through Macros which can be disabled based on build flags.
-	u32  beginZone(const char* name, const char* func, u32 lineNumber);
-	void endZone(u32 id, u64 dt);
-		
+	// Register a zone call site, this is done once per call site and returns the zone id.
+	u32  registerZone(const char* name, const char* func, u32 lineNumber);
+	void beginZone(u32 id);
+	void endZone(u32 id);
+
 	void frameBegin();
 	void frameEnd();
 
 	void addCounter(const char* name, s32* counter);
+	// Name the calling thread in captures, threads without a name are listed by index.
+	void setThreadName(const char* name);
+
+	// Capture all zone events, from every thread, for the next 'frameCount' frames
+	// and then write them to 'path' as Chrome trace JSON (chrome://tracing or ui.perfetto.dev).
+	bool beginCapture(u32 frameCount, const char* path);
+	bool isCapturing();
 
 	// Profile data API, this is used directly.
 	f64  getTimeInFrame();
 
-	u32  getZoneCount();
-	void getZoneInfo(u32 index, TFE_ZoneInfo* info);
-	
+	// Call tree, children are reached through 'child' and then 'sibling' until NULL_NODE.
+	u32  getThreadCount();
+	u32  getThreadRootNode(u32 threadIndex);
+	bool getNodeInfo(u32 node, TFE_NodeInfo* info);
+
 	u32  getCounterCount();
 	void getCounterInfo(u32 index, TFE_CounterInfo* info);
 }
@@ -74,38 +105,32 @@ namespace TFE_Profiler
 class TFE_Profiler_Zone
 {
 public:
-	TFE_Profiler_Zone(const char* name, const char* func, u32 lineNumber)
+	TFE_Profiler_Zone(u32 id) : m_id(id)
 	{
-		m_time = TFE_System::getCurrentTimeInTicks();
-		m_id = TFE_Profiler::beginZone(name, func, lineNumber);
+		TFE_Profiler::beginZone(m_id);
 	}
 
 	~TFE_Profiler_Zone()
 	{
-		const u64 deltaTime = TFE_System::getCurrentTimeInTicks() - m_time;
-		TFE_Profiler::endZone(m_id, deltaTime);
+		TFE_Profiler::endZone(m_id);
 	}
 private:
-	u64 m_time;
-	s32 m_id;
+	u32 m_id;
 };
 
 class TFE_Profiler_ZoneManual
 {
 public:
-	TFE_Profiler_ZoneManual(const char* name, const char* func, u32 lineNumber)
+	TFE_Profiler_ZoneManual(u32 id) : m_id(id)
 	{
-		m_time = TFE_System::getCurrentTimeInTicks();
-		m_id = TFE_Profiler::beginZone(name, func, lineNumber);
+		TFE_Profiler::beginZone(m_id);
 	}
 
 	void end()
 	{
-		const u64 deltaTime = TFE_System::getCurrentTimeInTicks() - m_time;
-		TFE_Profiler::endZone(m_id, deltaTime);
+		TFE_Profiler::endZone(m_id);
 	}
 private:
-	u64 m_time;
-	s32 m_id;
+	u32 m_id;
 };
 #endif
@@ -39,6 +39,8 @@ namespace TFE_System
 
 	static bool s_synced = false;
 	static bool s_resetStartTime = false;
+	static bool s_timeOverride = false;
+	static f64  s_timeOverrideValue = 0.0;
 	static bool s_quitMessagePosted = false;
 	static bool s_systemUiRequestPosted = false;
 
@@ -102,8 +104,28 @@ namespace TFE_System
 		return dt;
 	}
 
+	void setTimeOverride(bool enable)
+	{
+		s_timeOverride = enable;
+		s_timeOverrideValue = 0.0;
+	}
+
+	void setFrameTime(f64 dt, f64 dtRaw, f64 time)
+	{
+		s_dt = dt;
+		s_dtRaw = dtRaw;
+		s_timeOverrideValue = time;
+	}
+
 	void update()
 	{
+		// When the time is overridden (such as during demo playback), the frame time was already set using setFrameTime().
+		if (s_timeOverride)
+		{
+			s_time = SDL_GetPerformanceCounter();
+			return;
+		}
+
 		// This assumes that SDL_GetPerformanceCounter() is monotonic.
 		// However if errors do occur, the dt clamp later should limit the side effects.
 		const u64 curTime = SDL_GetPerformanceCounter();
@@ -170,6 +192,7 @@ namespace TFE_System
 	// Get time since "start time"
 	f64 getTime()
 	{
+		if (s_timeOverride) { return s_timeOverrideValue; }
 		const u64 uDt = s_time - s_startTime;
 		return f64(uDt) * s_freq;
 	}
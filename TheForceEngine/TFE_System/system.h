@@ -40,6 +40,11 @@ namespace TFE_System
 	// Get the absolute time since the last start time.
 	f64 getTime();
 
+	// Override the frame timing, such as when playing back a recorded demo.
+	// While enabled, update() leaves the delta time and current time at the values given to setFrameTime().
+	void setTimeOverride(bool enable);
+	void setFrameTime(f64 dt, f64 dtRaw, f64 time);
+
 	u64 getCurrentTimeInTicks();
 	f64 convertFromTicksToSeconds(u64 ticks);
 	f64 microsecondsToSeconds(f64 mu);
@@ -4,11 +4,13 @@
 
 #include "imGUI/imgui.h"
 #include "imGUI/imgui_impl_sdl.h"
-#include "imGUI/imgui_impl_opengl3.h"
 #include "portable-file-dialogs.h"
 #include "markdown.h"
 #include <SDL.h>
+#ifndef TFE_NULL_RENDER_BACKEND
+#include "imGUI/imgui_impl_opengl3.h"
 #include <GL/glew.h>
+#endif
 
 namespace TFE_Ui
 {
@@ -33,7 +35,9 @@ bool init(void* window, void* context, s32 uiScale)
 	// Setup Platform/Renderer bindings
 	s_window = (SDL_Window*)window;
 	ImGui_ImplSDL2_InitForOpenGL(s_window, context);
+#ifndef TFE_NULL_RENDER_BACKEND
 	ImGui_ImplOpenGL3_Init(glsl_version);
+#endif
 
 	// Set the default font (13 px)
 	// TODO: Allow scaled UI, so loading a different font for larger scales.
@@ -50,6 +54,10 @@ bool init(void* window, void* context, s32 uiScale)
 	}
 	
 	TFE_Markdown::init(f32(16 * s_uiScale / 100));
+#ifdef TFE_NULL_RENDER_BACKEND
+	// Normally the renderer builds the font atlas when creating the font texture.
+	io.Fonts->Build();
+#endif
 
 	// Initialize file dialogs.
 	if (!pfd::settings::available())
@@ -65,7 +73,9 @@ void shutdown()
 {
 	TFE_Markdown::shutdown();
 
+#ifndef TFE_NULL_RENDER_BACKEND
 	ImGui_ImplOpenGL3_Shutdown();
+#endif
 	ImGui_ImplSDL2_Shutdown();
 	ImGui::DestroyContext();
 }
@@ -88,7 +98,9 @@ void setUiInput(const void* inputEvent)
 
 void begin()
 {
+#ifndef TFE_NULL_RENDER_BACKEND
 	ImGui_ImplOpenGL3_NewFrame();
+#endif
 	ImGui_ImplSDL2_NewFrame(s_window);
 	ImGui::NewFrame();
 }
@@ -96,7 +108,9 @@ void begin()
 void render()
 {
 	ImGui::Render();
+#ifndef TFE_NULL_RENDER_BACKEND
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+#endif
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -6,11 +6,13 @@
 #include <TFE_Memory/memoryRegion.h>
 #include <TFE_Archive/gobArchive.h>
 #include <TFE_Game/igame.h>
+#include <TFE_Game/demo.h>
 #include <TFE_Game/saveSystem.h>
 #include <TFE_Game/reticle.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
 //#include <TFE_Editor/editor.h>
 #include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/filewriterAsync.h>
 #include <TFE_Audio/audioSystem.h>
 #include <TFE_FileSystem/paths.h>
 #include <TFE_Polygon/polygon.h>
@@ -20,11 +22,14 @@
 #include <TFE_System/system.h>
 #include <TFE_System/CrashHandler/crashHandler.h>
 #include <TFE_System/frameLimiter.h>
+#include <TFE_System/jobSystem.h>
 #include <TFE_System/tfeMessage.h>
 #include <TFE_Jedi/Task/task.h>
+#include <TFE_Jedi/Renderer/jediRenderer.h>
 #include <TFE_RenderShared/texturePacker.h>
 #include <TFE_Asset/paletteAsset.h>
 #include <TFE_Asset/imageAsset.h>
+#include <TFE_Asset/assetCache.h>
 #include <TFE_Ui/ui.h>
 #include <TFE_FrontEndUI/frontEndUi.h>
 #include <TFE_ForceScript/vm.h>
@@ -72,6 +77,10 @@ static char s_screenshotTime[TFE_MAX_PATH];
 static s32  s_startupGame = -1;
 static IGame* s_curGame = nullptr;
 static const char* s_loadRequestFilename = nullptr;
+static const char* s_recordDemo = nullptr;
+static const char* s_timeDemo = nullptr;
+static const char* s_timeDemoReport = nullptr;
+static s32 s_frameDumpInterval = 0;
 
 void parseOption(const char* name, const std::vector<const char*>& values, bool longName);
 bool validatePath();
@@ -239,6 +248,10 @@ void handleEvent(SDL_Event& Event)
 
 bool sdlInit()
 {
+#ifdef TFE_NULL_RENDER_BACKEND
+	// There may not be a display at all, so default to the SDL dummy video driver.
+	SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+#endif
 	// Audio is handled outside of SDL2.
 	// Using the Force Engine Audio system for sound mixing, FluidSynth for Midi handling and rtAudio for audio I/O.
 	const int code = SDL_Init(SDL_INIT_TIMER | SDL_INIT_VIDEO | SDL_INIT_EVENTS | SDL_INIT_GAMECONTROLLER);
@@ -550,6 +563,11 @@ int main(int argc, char* argv[])
 
 	// Override settings with command line options.
 	parseCommandLine(argc, argv);
+	TFE_AssetCache::setBudget(size_t(TFE_Settings::getGameSettings()->df_assetCacheSize) * 1024 * 1024);
+#ifdef TFE_NULL_RENDER_BACKEND
+	// Only the software renderer can be used without a GPU.
+	TFE_Settings::getGraphicsSettings()->rendererIndex = RENDERER_SOFTWARE;
+#endif
 
 	// Setup game paths.
 	// Get the current game.
@@ -592,12 +610,29 @@ int main(int argc, char* argv[])
 	}
 	TFE_Settings_Window* windowSettings = TFE_Settings::getWindowSettings();
 	TFE_Settings_Graphics* graphics = TFE_Settings::getGraphicsSettings();
-	TFE_System::init(s_refreshRate, graphics->vsync, c_gitVersion);
+	// Timedemos run as fast as possible, so vsync and the frame limiter are disabled.
+	const bool vsync = graphics->vsync && !s_timeDemo;
+	TFE_System::init(s_refreshRate, vsync, c_gitVersion);
+	TFE_Jobs::init();
+
+	// Demo recording and playback.
+	if (s_timeDemo)
+	{
+		if (!TFE_Demo::beginPlayback(s_timeDemo, s_timeDemoReport, &s_startupGame))
+		{
+			TFE_System::logClose();
+			return PROGRAM_ERROR;
+		}
+	}
+	else if (s_recordDemo)
+	{
+		TFE_Demo::beginRecording(s_recordDemo, s_startupGame);
+	}
 	
 	// Setup the GPU Device and Window.
 	u32 windowFlags = 0;
 	if (windowSettings->fullscreen) { TFE_System::logWrite(LOG_MSG, "Display", "Fullscreen enabled."); windowFlags |= WINFLAG_FULLSCREEN; }
-	if (graphics->vsync) { TFE_System::logWrite(LOG_MSG, "Display", "Vertical Sync enabled."); windowFlags |= WINFLAG_VSYNC; }
+	if (vsync) { TFE_System::logWrite(LOG_MSG, "Display", "Vertical Sync enabled."); windowFlags |= WINFLAG_VSYNC; }
 	
 	WindowState windowState =
 	{
@@ -659,7 +694,7 @@ int main(int argc, char* argv[])
 	TFE_SaveSystem::setCurrentGame(gameInfo->id);
 
 	// Setup the framelimiter.
-	TFE_System::frameLimiter_set(graphics->frameRateLimit);
+	TFE_System::frameLimiter_set(s_timeDemo ? 0.0 : graphics->frameRateLimit);
 
 	// Game loop
 	u32 frame = 0u;
@@ -689,6 +724,11 @@ int main(int argc, char* argv[])
 		SDL_GetMouseState(&mouseAbsX, &mouseAbsY);
 		TFE_Input::setRelativeMousePos(mouseX, mouseY);
 		TFE_Input::setMousePos(mouseAbsX, mouseAbsY);
+		// Record the input or replace it with the recorded input.
+		if (!TFE_Demo::beginFrame())
+		{
+			break;
+		}
 		inputMapping_updateInput();
 
 		// Can we save?
@@ -738,6 +778,7 @@ int main(int argc, char* argv[])
 
 		TFE_Ui::begin();
 		TFE_System::update();
+		TFE_Demo::recordFrameTime();
 
 		// Update
 		if (TFE_FrontEndUI::uiControlsEnabled() && task_canRun())
@@ -828,6 +869,7 @@ int main(int argc, char* argv[])
 			else
 			{
 				TFE_SaveSystem::update();
+				TFE_Demo::beginSimulation();
 				s_curGame->loopGame();
 				endInputFrame = TFE_Jedi::task_run() != 0;
 			}
@@ -836,6 +878,7 @@ int main(int argc, char* argv[])
 		{
 			TFE_RenderBackend::clearWindow();
 		}
+		TFE_Demo::endFrame();
 
 		bool drawFps = s_curGame && graphics->showFps;
 		if (s_curGame) { drawFps = drawFps && (!s_curGame->isPaused()); }
@@ -850,6 +893,17 @@ int main(int argc, char* argv[])
 			//swap = TFE_Editor::render();
 		}
 
+		// Periodically save the frame, useful to check the output when running headless.
+		if (s_frameDumpInterval > 0 && s_curState == APP_STATE_GAME && (frame % u32(s_frameDumpInterval)) == 0)
+		{
+			char screenshotDir[TFE_MAX_PATH];
+			TFE_Paths::appendPath(TFE_PathType::PATH_USER_DOCUMENTS, "Screenshots/", screenshotDir);
+
+			char screenshotPath[TFE_MAX_PATH];
+			sprintf(screenshotPath, "%stfe_frame_%s_%06u.png", screenshotDir, s_screenshotTime, frame);
+			TFE_RenderBackend::queueScreenshot(screenshotPath);
+		}
+
 		// Blit the frame to the window and draw UI.
 		TFE_RenderBackend::swap(swap);
 
@@ -876,11 +930,14 @@ int main(int argc, char* argv[])
 		s_curGame = nullptr;
 	}
 	s_soundPaused = false;
+	TFE_Demo::end();
 	game_destroy();
 	reticle_destroy();
 	inputMapping_shutdown();
 
 	// Cleanup
+	TFE_Jobs::shutdown();
+	FileWriterAsync::shutdown();
 	TFE_FrontEndUI::shutdown();
 	TFE_Audio::shutdown();
 	TFE_MidiPlayer::destroy();
@@ -919,6 +976,23 @@ void parseOption(const char* name, const std::vector<const char*>& values, bool
 			// -noaudio
 			s_nullAudioDevice = true;
 		}
+		else if (strcasecmp(name, "record") == 0 && values.size() >= 1)
+		{
+			// -record demo.tfd
+			s_recordDemo = values[0];
+		}
+		else if (strcasecmp(name, "timedemo") == 0 && values.size() >= 1)
+		{
+			// -timedemo demo.tfd [report.json]
+			s_timeDemo = values[0];
+			s_timeDemoReport = values.size() >= 2 ? values[1] : nullptr;
+			s_nullAudioDevice = true;
+		}
+		else if (strcasecmp(name, "dumpframes") == 0 && values.size() >= 1)
+		{
+			// -dumpframes 60
+			s_frameDumpInterval = atoi(values[0]);
+		}
 	}
 	else  // long names use the more traditional style of arguments which allow for multiple values.
 	{
@@ -937,5 +1011,22 @@ void parseOption(const char* name, const std::vector<const char*>& values, bool
 			// --noaudio
 			s_nullAudioDevice = true;
 		}
+		else if (strcasecmp(name, "record") == 0 && values.size() >= 1)
+		{
+			// --record demo.tfd
+			s_recordDemo = values[0];
+		}
+		else if (strcasecmp(name, "timedemo") == 0 && values.size() >= 1)
+		{
+			// --timedemo demo.tfd [report.json]
+			s_timeDemo = values[0];
+			s_timeDemoReport = values.size() >= 2 ? values[1] : nullptr;
+			s_nullAudioDevice = true;
+		}
+		else if (strcasecmp(name, "dumpframes") == 0 && values.size() >= 1)
+		{
+			// --dumpframes 60
+			s_frameDumpInterval = atoi(values[0]);
+		}
 	}
 }
\ No newline at end of file